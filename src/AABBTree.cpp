@@ -0,0 +1,146 @@
+#include "AABBTree.h"
+#include <SDL_log.h>
+#include <algorithm>
+
+/**
+ * AABBTree implementation
+ */
+
+/**
+ * The default constructor.
+ * @param leafSize maximum number of objects stored in a single leaf. Defaults to 4
+ */
+AABBTree::AABBTree(unsigned leafSize) :
+    leafSize(leafSize < 1 ? 1 : leafSize)
+{
+}
+
+/**
+ * The default destructor.
+ */
+AABBTree::~AABBTree()
+{
+}
+
+/**
+ * Builds tree over given objects by splitting them at median of longer axis.
+ * @param objects a list of objects that should be indexed
+ * @return void
+ */
+void AABBTree::build(std::vector<SolidObject*> const& objects)
+{
+    nodes.clear();
+    itemIndex.clear();
+    items = objects;
+    if (items.empty())
+        return;
+    nodes.reserve(2 * (items.size() / leafSize + 1));
+    buildNode(0, unsigned(items.size()));
+    for (unsigned i = 0; i < items.size(); ++i)
+        itemIndex[items[i]] = i;
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "AABBTree built with %u nodes and %u objects", unsigned(nodes.size()), unsigned(items.size()));
+}
+
+/**
+ * Marks object as removed, so it won't be returned by queries anymore.
+ * @param object a pointer to an indexed object
+ * @return void
+ */
+void AABBTree::remove(SolidObject* object)
+{
+    std::unordered_map<SolidObject*, unsigned>::iterator it = itemIndex.find(object);
+    if (it == itemIndex.end())
+        return;
+    items[it->second] = nullptr;
+    itemIndex.erase(it);
+}
+
+/**
+ * Appends to result every indexed object from leaves whose bounds overlap given rectangle.
+ * @param left left edge of queried rectangle
+ * @param top top edge of queried rectangle
+ * @param right right edge of queried rectangle
+ * @param bottom bottom edge of queried rectangle
+ * @param result a list to which candidates are appended
+ * @return void
+ */
+void AABBTree::query(double left, double top, double right, double bottom, std::vector<SolidObject*>& result) const
+{
+    if (nodes.empty())
+        return;
+    //median splits keep depth logarithmic, so fixed stack is enough
+    unsigned stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0)
+    {
+        unsigned index = stack[--stackSize];
+        Node const& node = nodes[index];
+        if (node.minX > right || node.maxX < left || node.minY > bottom || node.maxY < top)
+            continue;
+        if (node.count > 0)
+        {
+            for (unsigned i = node.start; i < node.start + node.count; ++i)
+                if (items[i] != nullptr)
+                    result.push_back(items[i]);
+        }
+        else
+        {
+            //right child is pushed first, so left subtree is visited first
+            stack[stackSize++] = node.start;
+            stack[stackSize++] = index + 1;
+        }
+    }
+}
+
+/**
+ * Recursively builds subtree over items in range [begin, end).
+ * @param begin index of first item
+ * @param end index after last item
+ * @return unsigned index of subtree root
+ */
+unsigned AABBTree::buildNode(unsigned begin, unsigned end)
+{
+    unsigned index = unsigned(nodes.size());
+    Node node;
+    node.minX = items[begin]->getX();
+    node.minY = items[begin]->getY();
+    node.maxX = items[begin]->getX() + items[begin]->getWidth();
+    node.maxY = items[begin]->getY() + items[begin]->getHeight();
+    double minCenterX = node.minX + items[begin]->getWidth() / 2.0;
+    double minCenterY = node.minY + items[begin]->getHeight() / 2.0;
+    double maxCenterX = minCenterX;
+    double maxCenterY = minCenterY;
+    for (unsigned i = begin; i < end; ++i)
+    {
+        SolidObject const* object = items[i];
+        node.minX = std::min(node.minX, object->getX());
+        node.minY = std::min(node.minY, object->getY());
+        node.maxX = std::max(node.maxX, object->getX() + object->getWidth());
+        node.maxY = std::max(node.maxY, object->getY() + object->getHeight());
+        minCenterX = std::min(minCenterX, object->getX() + object->getWidth() / 2.0);
+        minCenterY = std::min(minCenterY, object->getY() + object->getHeight() / 2.0);
+        maxCenterX = std::max(maxCenterX, object->getX() + object->getWidth() / 2.0);
+        maxCenterY = std::max(maxCenterY, object->getY() + object->getHeight() / 2.0);
+    }
+    node.start = begin;
+    node.count = end - begin;
+    nodes.push_back(node);
+    if (end - begin <= leafSize)
+        return index;
+
+    //split at median of centers along longer axis
+    unsigned middle = begin + (end - begin) / 2;
+    if (maxCenterX - minCenterX >= maxCenterY - minCenterY)
+        std::nth_element(items.begin() + begin, items.begin() + middle, items.begin() + end,
+            [](SolidObject const* a, SolidObject const* b){ return a->getX() + a->getWidth() / 2.0 < b->getX() + b->getWidth() / 2.0; });
+    else
+        std::nth_element(items.begin() + begin, items.begin() + middle, items.begin() + end,
+            [](SolidObject const* a, SolidObject const* b){ return a->getY() + a->getHeight() / 2.0 < b->getY() + b->getHeight() / 2.0; });
+
+    buildNode(begin, middle);
+    unsigned right = buildNode(middle, end);
+    nodes[index].start = right;
+    nodes[index].count = 0;
+    return index;
+}
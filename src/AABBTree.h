@@ -0,0 +1,97 @@
+#ifndef AABBTREE_H
+#define AABBTREE_H
+
+#include "Broadphase.h"
+#include <unordered_map>
+
+/**
+ * AABBTree is an immutable bounding volume hierarchy over static level geometry.
+ * It's built once, nodes are packed in depth-first order in one contiguous array.
+ * Removed objects are only marked as removed, the tree itself is never rebuilt.
+ * @see Broadphase
+ */
+class AABBTree :
+    public Broadphase
+{
+public:
+    /**
+     * The default constructor.
+     * @param leafSize maximum number of objects stored in a single leaf. Defaults to 4
+     */
+    AABBTree(unsigned leafSize = 4);
+
+    /**
+     * The default destructor.
+     */
+    ~AABBTree();
+
+    /**
+     * Builds tree over given objects by splitting them at median of longer axis.
+     * @param objects a list of objects that should be indexed
+     * @return void
+     */
+    void build(std::vector<SolidObject*> const& objects) override;
+
+    /**
+     * Marks object as removed, so it won't be returned by queries anymore.
+     * @param object a pointer to an indexed object
+     * @return void
+     */
+    void remove(SolidObject* object) override;
+
+    /**
+     * Appends to result every indexed object from leaves whose bounds overlap given rectangle.
+     * @param left left edge of queried rectangle
+     * @param top top edge of queried rectangle
+     * @param right right edge of queried rectangle
+     * @param bottom bottom edge of queried rectangle
+     * @param result a list to which candidates are appended
+     * @return void
+     */
+    void query(double left, double top, double right, double bottom, std::vector<SolidObject*>& result) const override;
+
+private:
+    /**
+     * Node is a struct that holds bounds of a subtree.
+     * Left child of inner node is always the next node, so only right child is stored.
+     */
+    struct Node
+    {
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+        unsigned start;     // right child of inner node or first item of leaf
+        unsigned count;     // 0 for inner node, number of items for leaf
+    };
+
+    /**
+     * Maximum number of objects stored in a single leaf.
+     */
+    unsigned const leafSize;
+
+    /**
+     * Nodes of tree in depth-first order. The first node is root.
+     */
+    std::vector<Node> nodes;
+
+    /**
+     * Indexed objects in order of leaves. Removed objects are nullptr.
+     */
+    std::vector<SolidObject*> items;
+
+    /**
+     * Map from indexed object to its index in items.
+     */
+    std::unordered_map<SolidObject*, unsigned> itemIndex;
+
+    /**
+     * Recursively builds subtree over items in range [begin, end).
+     * @param begin index of first item
+     * @param end index after last item
+     * @return unsigned index of subtree root
+     */
+    unsigned buildNode(unsigned begin, unsigned end);
+};
+
+#endif // AABBTREE_H
@@ -0,0 +1,91 @@
+#include "Arena.h"
+#include <SDL_log.h>
+
+/**
+ * Arena implementation
+ */
+
+/**
+ * The default constructor. No memory is reserved until first allocation.
+ * @param blockSize size of a single block in bytes
+ */
+Arena::Arena(size_t blockSize) :
+    blockSize(blockSize),
+    current(0),
+    offset(0),
+    usedBefore(0)
+{
+}
+
+/**
+ * The default destructor. Frees every block.
+ */
+Arena::~Arena()
+{
+    for (size_t i = 0; i < blocks.size(); ++i)
+        ::operator delete(blocks[i].memory);
+}
+
+/**
+ * Allocates uninitialized memory.
+ * Allocation that doesn't fit into current block moves to next kept block, or a new one if there's none big enough.
+ * @param size size of memory in bytes
+ * @param alignment required alignment, must be a power of two
+ * @return void* a pointer to allocated memory
+ */
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    while (current < blocks.size())
+    {
+        Block& block = blocks[current];
+        size_t address = reinterpret_cast<size_t>(block.memory) + offset;
+        size_t aligned = (address + alignment - 1) & ~(alignment - 1);
+        if (aligned - reinterpret_cast<size_t>(block.memory) + size <= block.size)
+        {
+            offset = aligned - reinterpret_cast<size_t>(block.memory) + size;
+            return reinterpret_cast<void*>(aligned);
+        }
+        usedBefore += offset;
+        offset = 0;
+        ++current;
+    }
+
+    Block block;
+    block.size = size + alignment > blockSize ? size + alignment : blockSize;
+    block.memory = static_cast<char*>(::operator new(block.size));
+    blocks.push_back(block);
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Arena allocated block of %u bytes", unsigned(block.size));
+    return allocate(size, alignment);
+}
+
+/**
+ * Releases every allocation at once. Blocks are kept for later allocations.
+ * @return void
+ */
+void Arena::reset()
+{
+    current = 0;
+    offset = 0;
+    usedBefore = 0;
+}
+
+/**
+ * Get number of bytes handed out since last reset.
+ * @return size_t
+ */
+size_t Arena::getUsed() const
+{
+    return usedBefore + offset;
+}
+
+/**
+ * Get number of bytes held in blocks.
+ * @return size_t
+ */
+size_t Arena::getCapacity() const
+{
+    size_t capacity = 0;
+    for (size_t i = 0; i < blocks.size(); ++i)
+        capacity += blocks[i].size;
+    return capacity;
+}
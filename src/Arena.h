@@ -0,0 +1,114 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Arena is a monotonic allocator for objects that live as long as a level.
+ * Memory is handed out from large blocks by moving a pointer and is never freed one allocation at a time.
+ * Reset releases everything at once but keeps blocks, so next level is allocated without asking system for memory.
+ * Destructors aren't called by Arena, owner of an object has to call it before reset.
+ * @see World
+ */
+class Arena
+{
+public:
+    /**
+     * The default constructor. No memory is reserved until first allocation.
+     * @param blockSize size of a single block in bytes
+     */
+    Arena(size_t blockSize = 64 * 1024);
+
+    /**
+     * The default destructor. Frees every block.
+     */
+    ~Arena();
+
+    /**
+     * Allocates uninitialized memory.
+     * @param size size of memory in bytes
+     * @param alignment required alignment, must be a power of two
+     * @return void* a pointer to allocated memory
+     */
+    void* allocate(size_t size, size_t alignment);
+
+    /**
+     * Constructs a new object in arena.
+     * @param args arguments passed to constructor of T
+     * @return T* a pointer to created object
+     */
+    template <class T, class... Args>
+    T* create(Args&&... args)
+    {
+        return new (allocate(sizeof(T), std::alignment_of<T>::value)) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Releases every allocation at once. Blocks are kept for later allocations.
+     * @return void
+     */
+    void reset();
+
+    /**
+     * Get number of bytes handed out since last reset.
+     * @return size_t
+     */
+    size_t getUsed() const;
+
+    /**
+     * Get number of bytes held in blocks.
+     * @return size_t
+     */
+    size_t getCapacity() const;
+
+    /**
+     * Copy constructor is deleted because blocks can't be shared.
+     */
+    Arena(Arena const&) = delete;
+
+    /**
+     * Assignment operator is deleted because blocks can't be shared.
+     */
+    Arena& operator=(Arena const&) = delete;
+
+private:
+    /**
+     * Block is a struct that holds a single chunk of memory.
+     */
+    struct Block
+    {
+        char* memory; // beginning of block
+        size_t size;  // size of block in bytes
+    };
+
+    /**
+     * Size of a regular block in bytes.
+     */
+    const size_t blockSize;
+
+    /**
+     * Blocks in order of allocation.
+     */
+    std::vector<Block> blocks;
+
+    /**
+     * Index of block that allocations are taken from.
+     */
+    size_t current;
+
+    /**
+     * Offset of first free byte in current block.
+     */
+    size_t offset;
+
+    /**
+     * Number of bytes handed out from blocks before current one.
+     */
+    size_t usedBefore;
+};
+
+#endif // ARENA_H
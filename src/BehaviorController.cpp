@@ -0,0 +1,234 @@
+#include "BehaviorController.h"
+#include "World.h"
+#include "GameDefs.h"
+#include "Snapshot.h"
+#include <cmath>
+
+/**
+ * BehaviorController implementation
+ */
+
+/**
+ * The default constructor with Creature possesion. Creature starts in first state of behavior.
+ * @param world a constant pointer to World that holds Creature
+ * @param creature handle of associated Creature
+ * @param behavior BehaviorTable that is followed, it has to outlive controller
+ * @see Creature
+ */
+BehaviorController::BehaviorController(World const* world, ObjectHandle creature, BehaviorTable const& behavior) :
+    Controller(world, creature),
+    behavior(&behavior),
+    state(0),
+    timer(behavior.getState(0).duration),
+    controlTick(0)
+{
+}
+
+/**
+ * The default destructor.
+ */
+BehaviorController::~BehaviorController()
+{
+}
+
+/**
+ * Controls associated Creature for a single step.
+ * @return void
+ */
+void BehaviorController::control()
+{
+    control(1);
+}
+
+/**
+ * Controls associated Creature for a number of steps, takes at most one transition.
+ * Events are checked in order wall, ground, timer, and the first one that has a transition is taken.
+ * Entered state resets timer and jumps if it has jump speed and Creature stands on ground, unless it's a chasing state.
+ * @param ticks number of steps that have passed since last control, timer runs down by all of them
+ * @return void
+ */
+void BehaviorController::control(unsigned ticks)
+{
+    Creature* creature = getCreature();
+    if (creature == nullptr)
+        return;
+    BehaviorTable::State const* current = &behavior->getState(state);
+    bool timedOut = false;
+    if (current->duration > 0)
+    {
+        timer = timer > ticks ? Uint16(timer - ticks) : 0;
+        timedOut = timer == 0;
+    }
+
+    CollisionState collisions = creature->getCollisionState();
+    bool grounded = (collisions & CollisionState::FromAbove) == CollisionState::FromAbove;
+    Uint8 next = noTransition;
+    if ((collisions & CollisionState::FromLeft) == CollisionState::FromLeft ||
+        (collisions & CollisionState::FromRight) == CollisionState::FromRight)
+        next = current->onWall;
+    if (next == noTransition && grounded)
+        next = current->onLand;
+    if (next == noTransition && timedOut)
+        next = current->onTimer;
+
+    double speedY = creature->getSpeedY();
+    if (next != noTransition)
+    {
+        state = next;
+        current = &behavior->getState(state);
+        timer = current->duration;
+        if (current->jumpSpeed > 0.0f && grounded && current->move != BehaviorMove::Chase)
+            speedY = -current->jumpSpeed;
+    }
+    if (current->move == BehaviorMove::Chase)
+    {
+        chase(creature, *current, grounded);
+        return;
+    }
+    switch (current->move)
+    {
+    case BehaviorMove::Left:
+        controllerState = ControllerState::GoingLeft;
+        creature->setSpeedVector(-current->speed, speedY);
+        break;
+    case BehaviorMove::Right:
+        controllerState = ControllerState::GoingRight;
+        creature->setSpeedVector(current->speed, speedY);
+        break;
+    case BehaviorMove::Stop:
+    default:
+        controllerState = ControllerState::NotGoing;
+        creature->setSpeedVector(0.0, speedY);
+    }
+}
+
+/**
+ * Steers associated Creature along NavGraph of World towards nearest player.
+ * Creature on the same segment as player walks to it, otherwise it walks to take-off point of next link of path and jumps there
+ * if link is a jump. Creature whose state has no jump speed follows paths made only of falls. Creature in the air keeps its speed until it lands, so it follows through jumps and falls.
+ * Path is read from table of NavGraph, so every step costs a lookup of two segments and one link.
+ * @param creature a pointer to associated Creature
+ * @param current current state
+ * @param grounded true if Creature stands on ground
+ * @return void
+ * @see NavGraph
+ */
+void BehaviorController::chase(Creature* creature, BehaviorTable::State const& current, bool grounded)
+{
+    if (!grounded)
+        return;
+    double x = creature->getX() + creature->getWidth() / 2;
+    PlayerCreature const* target = nullptr;
+    double targetX = 0.0;
+    world->players.forEach([x, &target, &targetX](PlayerCreature const* player)
+    {
+        double playerX = player->getX() + player->getWidth() / 2;
+        if (!player->getDestroyed() && (target == nullptr || std::fabs(playerX - x) < std::fabs(targetX - x)))
+        {
+            target = player;
+            targetX = playerX;
+        }
+    });
+    if (target == nullptr)
+    {
+        controllerState = ControllerState::NotGoing;
+        creature->setSpeedVector(0.0, creature->getSpeedY());
+        return;
+    }
+
+    NavGraph const& navigation = world->navigation;
+    Uint32 from = navigation.findSegment(x, creature->getY() + creature->getHeight());
+    Uint32 to = navigation.findSegment(targetX, target->getY() + target->getHeight());
+    double goal = targetX;
+    //Creatures that can't jump follow paths made only of falls, so they never wait at a take-off point
+    NavGraph::Link const* link = navigation.getNextLink(from, to, current.jumpSpeed > 0.0f);
+    if (link != nullptr)
+    {
+        goal = link->x;
+        if (link->type == NavLinkType::Jump && std::fabs(x - goal) <= GameDefinitions::navReachTolerance)
+        {
+            controllerState = link->direction < 0.0 ? ControllerState::GoingLeft : ControllerState::GoingRight;
+            creature->setSpeedVector(link->direction * current.speed, -current.jumpSpeed);
+            return;
+        }
+    }
+    if (std::fabs(goal - x) <= GameDefinitions::navReachTolerance)
+    {
+        controllerState = ControllerState::NotGoing;
+        creature->setSpeedVector(0.0, creature->getSpeedY());
+    }
+    else if (goal < x)
+    {
+        controllerState = ControllerState::GoingLeft;
+        creature->setSpeedVector(-current.speed, creature->getSpeedY());
+    }
+    else
+    {
+        controllerState = ControllerState::GoingRight;
+        creature->setSpeedVector(current.speed, creature->getSpeedY());
+    }
+}
+
+/**
+ * Controls associated Creature for every step that has passed since it was last controlled by controlUntil.
+ * Creature that was near players until last step and turned far takes only steps it missed, not a whole coarse step.
+ * Creature that wasn't controlled yet takes a single step.
+ * @param tick number of current step
+ * @return void
+ */
+void BehaviorController::controlUntil(Uint32 tick)
+{
+    unsigned ticks = controlTick != 0 && controlTick < tick ? tick - controlTick : 1;
+    controlTick = tick;
+    control(ticks);
+}
+
+/**
+ * Get followed BehaviorTable.
+ * @return BehaviorTable const&
+ */
+BehaviorTable const& BehaviorController::getBehavior() const
+{
+    return *behavior;
+}
+
+/**
+ * Get index of current state in BehaviorTable.
+ * @return Uint8
+ */
+Uint8 BehaviorController::getState() const
+{
+    return state;
+}
+
+/**
+ * Appends state of BehaviorController to snapshot. Followed BehaviorTable isn't saved.
+ * @param snapshot Snapshot that state is appended to
+ * @return void
+ */
+void BehaviorController::saveState(Snapshot& snapshot) const
+{
+    Controller::saveState(snapshot);
+    snapshot.write(state);
+    snapshot.write(timer);
+    snapshot.write(controlTick);
+}
+
+/**
+ * Reads state of BehaviorController appended by saveState.
+ * State that isn't in followed BehaviorTable, because snapshot was taken with another table, is replaced by first one.
+ * @param snapshot Snapshot that state is read from
+ * @return void
+ */
+void BehaviorController::loadState(Snapshot& snapshot)
+{
+    Controller::loadState(snapshot);
+    state = snapshot.read<Uint8>();
+    timer = snapshot.read<Uint16>();
+    controlTick = snapshot.read<Uint32>();
+    if (state >= behavior->getStateCount())
+    {
+        state = 0;
+        timer = behavior->getState(0).duration;
+    }
+}
@@ -0,0 +1,114 @@
+#ifndef BEHAVIORCONTROLLER_H
+#define BEHAVIORCONTROLLER_H
+
+#include "Controller.h"
+#include "BehaviorTable.h"
+
+/**
+ * BehaviorController is a Controller of a monster that follows a BehaviorTable.
+ * Table is shared by every monster of the same kind, so a controller only holds index of its current state and a timer.
+ * Chasing states find their way with NavGraph of World, which keeps paths for every Controller.
+ * It's final, so Game calls it without going through virtual table.
+ * @see BehaviorTable
+ */
+class BehaviorController final: public Controller
+{
+public:
+    /**
+     * The default constructor with Creature possesion. Creature starts in first state of behavior.
+     * @param world a constant pointer to World that holds Creature
+     * @param creature handle of associated Creature
+     * @param behavior BehaviorTable that is followed, it has to outlive controller
+     * @see Creature
+     */
+    BehaviorController(World const* world, ObjectHandle creature, BehaviorTable const& behavior = BehaviorTable::getWalker());
+
+    /**
+     * The default destructor.
+     */
+    ~BehaviorController();
+
+    /**
+     * Controls associated Creature for a single step.
+     * @return void
+     */
+    void control() override;
+
+    /**
+     * Controls associated Creature for a number of steps, takes at most one transition.
+     * @param ticks number of steps that have passed since last control, timer runs down by all of them
+     * @return void
+     */
+    void control(unsigned ticks);
+
+    /**
+     * Controls associated Creature for every step that has passed since it was last controlled by controlUntil.
+     * @param tick number of current step
+     * @return void
+     */
+    void controlUntil(Uint32 tick);
+
+    /**
+     * Get followed BehaviorTable.
+     * @return BehaviorTable const&
+     */
+    BehaviorTable const& getBehavior() const;
+
+    /**
+     * Get index of current state in BehaviorTable.
+     * @return Uint8
+     */
+    Uint8 getState() const;
+
+    /**
+     * Appends state of BehaviorController to snapshot. Followed BehaviorTable isn't saved.
+     * @param snapshot Snapshot that state is appended to
+     * @return void
+     */
+    void saveState(Snapshot& snapshot) const override;
+
+    /**
+     * Reads state of BehaviorController appended by saveState.
+     * @param snapshot Snapshot that state is read from
+     * @return void
+     */
+    void loadState(Snapshot& snapshot) override;
+
+    /**
+     * Assignment operator is deleted because BehaviorController has constant variable.
+     */
+    BehaviorController& operator=(BehaviorController const&) = delete;
+
+private:
+    /**
+     * A constant pointer to followed BehaviorTable.
+     */
+    BehaviorTable const* behavior;
+
+    /**
+     * Index of current state.
+     */
+    Uint8 state;
+
+    /**
+     * Number of steps left until duration of current state runs out.
+     */
+    Uint16 timer;
+
+    /**
+     * Number of step in which controlUntil last controlled Creature, 0 if it hasn't yet.
+     */
+    Uint32 controlTick;
+
+    /**
+     * Steers associated Creature along NavGraph of World towards nearest player.
+     * @param creature a pointer to associated Creature
+     * @param current current state
+     * @param grounded true if Creature stands on ground
+     * @return void
+     * @see NavGraph
+     */
+    void chase(Creature* creature, BehaviorTable::State const& current, bool grounded);
+};
+
+#endif // BEHAVIORCONTROLLER_H
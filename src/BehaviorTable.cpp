@@ -0,0 +1,92 @@
+#include "BehaviorTable.h"
+#include <algorithm>
+
+/**
+ * BehaviorTable implementation
+ */
+
+/**
+ * The constructor that reads states of a behavior from level file.
+ * Transitions to states that don't exist are dropped, so a damaged record can't make a monster leave its table.
+ * @param index index of behavior record in level file
+ * @param records a constant pointer to first state record of behavior
+ * @param count number of state records, at most 255
+ */
+BehaviorTable::BehaviorTable(Uint32 index, LevelBehaviorState const* records, Uint32 count) :
+    index(index)
+{
+    count = std::min(count, Uint32(noTransition));
+    auto transition = [count](Uint32 next){ return next < count ? Uint8(next) : noTransition; };
+    states.resize(count);
+    for (Uint32 i = 0; i < count; ++i)
+    {
+        LevelBehaviorState const& record = records[i];
+        State& state = states[i];
+        state.speed = record.speed;
+        state.jumpSpeed = record.jumpSpeed;
+        state.duration = Uint16(std::min(record.duration, Uint32(0xFFFF)));
+        state.move = record.move <= Uint32(BehaviorMove::Chase) ? BehaviorMove(record.move) : BehaviorMove::Stop;
+        state.onTimer = transition(record.onTimer);
+        state.onWall = transition(record.onWall);
+        state.onLand = transition(record.onLand);
+    }
+}
+
+/**
+ * The constructor of built-in behavior.
+ * First state walks left, second walks right, each turns into the other on a wall.
+ */
+BehaviorTable::BehaviorTable() :
+    index(noBehavior)
+{
+    State left = { 1.0f, 0.0f, 0, BehaviorMove::Left, noTransition, 1, noTransition };
+    State right = { 1.0f, 0.0f, 0, BehaviorMove::Right, noTransition, 0, noTransition };
+    states.push_back(left);
+    states.push_back(right);
+}
+
+/**
+ * The default destructor.
+ */
+BehaviorTable::~BehaviorTable()
+{
+}
+
+/**
+ * Get built-in behavior of monsters that have none in level file.
+ * They walk left and turn around whenever they walk into a wall.
+ * @return BehaviorTable const&
+ */
+BehaviorTable const& BehaviorTable::getWalker()
+{
+    static BehaviorTable const walker;
+    return walker;
+}
+
+/**
+ * Get index of behavior record in level file.
+ * @return Uint32 index, noBehavior for built-in behavior
+ */
+Uint32 BehaviorTable::getIndex() const
+{
+    return index;
+}
+
+/**
+ * Get number of states.
+ * @return size_t
+ */
+size_t BehaviorTable::getStateCount() const
+{
+    return states.size();
+}
+
+/**
+ * Get a state.
+ * @param state index of state, less than getStateCount()
+ * @return State const&
+ */
+BehaviorTable::State const& BehaviorTable::getState(Uint8 state) const
+{
+    return states[state];
+}
@@ -0,0 +1,95 @@
+#ifndef BEHAVIORTABLE_H
+#define BEHAVIORTABLE_H
+
+#include "LevelFile.h"
+#include <vector>
+
+/**
+ * Value of state transition of BehaviorTable that means there's none.
+ */
+Uint8 const noTransition = 0xFF;
+
+/**
+ * BehaviorTable is an immutable state machine that drives monsters, read from level file.
+ * Every monster of the same kind shares a single table, its BehaviorController only keeps index of current state and a timer.
+ * Every state sets horizontal speed of monster and can make it jump when it's entered on ground.
+ * Chasing states steer monster along NavGraph of World towards nearest player instead.
+ * State is left on first event that has a transition, in order: walking into a wall, standing on ground, duration running out.
+ * @see BehaviorController
+ * @see LevelBehavior
+ */
+class BehaviorTable
+{
+public:
+    /**
+     * State is a struct that holds a single state of behavior.
+     */
+    struct State
+    {
+        float speed;       // horizontal speed
+        float jumpSpeed;   // vertical speed of jump made when state is entered on ground, or at jump links while chasing, 0 for none
+        Uint16 duration;   // number of steps after which onTimer is taken, 0 for none
+        BehaviorMove move; // way monster moves
+        Uint8 onTimer;     // state entered when duration has passed, noTransition for none
+        Uint8 onWall;      // state entered when monster walks into a wall, noTransition for none
+        Uint8 onLand;      // state entered when monster stands on ground, noTransition for none
+    };
+
+    /**
+     * The constructor that reads states of a behavior from level file.
+     * Transitions to states that don't exist are dropped, so a damaged record can't make a monster leave its table.
+     * @param index index of behavior record in level file
+     * @param records a constant pointer to first state record of behavior
+     * @param count number of state records, at most 255
+     */
+    BehaviorTable(Uint32 index, LevelBehaviorState const* records, Uint32 count);
+
+    /**
+     * The default destructor.
+     */
+    ~BehaviorTable();
+
+    /**
+     * Get built-in behavior of monsters that have none in level file.
+     * They walk left and turn around whenever they walk into a wall.
+     * @return BehaviorTable const&
+     */
+    static BehaviorTable const& getWalker();
+
+    /**
+     * Get index of behavior record in level file.
+     * @return Uint32 index, noBehavior for built-in behavior
+     */
+    Uint32 getIndex() const;
+
+    /**
+     * Get number of states.
+     * @return size_t
+     */
+    size_t getStateCount() const;
+
+    /**
+     * Get a state.
+     * @param state index of state, less than getStateCount()
+     * @return State const&
+     */
+    State const& getState(Uint8 state) const;
+
+private:
+    /**
+     * The constructor of built-in behavior.
+     */
+    BehaviorTable();
+
+    /**
+     * Index of behavior record in level file.
+     */
+    Uint32 index;
+
+    /**
+     * States of behavior, first of them is where monsters start.
+     */
+    std::vector<State> states;
+};
+
+#endif // BEHAVIORTABLE_H
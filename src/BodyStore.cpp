@@ -0,0 +1,201 @@
+#include "BodyStore.h"
+#include "SimdLanes.h"
+
+/**
+ * BodyStore implementation
+ */
+
+/**
+ * Advances bodies in range [begin, end) with given integrator and width of lanes.
+ * Stops before bodies that don't fill whole lanes.
+ * @param bodies reference to integrated bodies
+ * @param begin index of first body
+ * @param end index after last body
+ * @param gravity vertical acceleration
+ * @return size_t index after last processed body
+ */
+template <class Integrator, class L>
+static size_t integrateRange(BodyStore& bodies, size_t begin, size_t end, double gravity)
+{
+    L noAcceleration(0.0);
+    L laneGravity(gravity);
+    size_t i = begin;
+    for (; i + L::width <= end; i += L::width)
+    {
+        L x = L::load(&bodies.x[i]);
+        L y = L::load(&bodies.y[i]);
+        L speedX = L::load(&bodies.speedX[i]);
+        L speedY = L::load(&bodies.speedY[i]);
+        L laneDt = L::load(&bodies.timestep[i]);
+        Integrator::step(x, speedX, noAcceleration, laneDt);
+        Integrator::step(y, speedY, laneGravity, laneDt);
+        x.store(&bodies.x[i]);
+        y.store(&bodies.y[i]);
+        speedX.store(&bodies.speedX[i]);
+        speedY.store(&bodies.speedY[i]);
+    }
+    return i;
+}
+
+/**
+ * The default constructor.
+ */
+BodyStore::BodyStore()
+{
+}
+
+/**
+ * The default destructor.
+ */
+BodyStore::~BodyStore()
+{
+}
+
+/**
+ * Removes every body.
+ * @return void
+ */
+void BodyStore::clear()
+{
+    indices.clear();
+    creatures.clear();
+    x.clear();
+    y.clear();
+    speedX.clear();
+    speedY.clear();
+    width.clear();
+    height.clear();
+    idleTicks.clear();
+    lastCollisionState.clear();
+    timestep.clear();
+    lastTick.clear();
+}
+
+/**
+ * Adds a body mirroring given Creature.
+ * @param creature a pointer to mirrored Creature
+ * @param tick number of step that body is simulated from. Defaults to 0
+ * @return void
+ */
+void BodyStore::add(Creature* creature, Uint32 tick)
+{
+    indices[creature->getId()] = creatures.size();
+    creatures.push_back(creature);
+    x.push_back(creature->getX());
+    y.push_back(creature->getY());
+    speedX.push_back(creature->getSpeedX());
+    speedY.push_back(creature->getSpeedY());
+    width.push_back(creature->getWidth());
+    height.push_back(creature->getHeight());
+    idleTicks.push_back(0);
+    lastCollisionState.push_back(creature->getCollisionState());
+    timestep.push_back(0.0);
+    lastTick.push_back(tick);
+}
+
+/**
+ * Removes body mirroring given Creature. Last body takes place of removed one.
+ * Body is found by identifier of Creature and arrays are never shifted, so removal takes constant time.
+ * @param creature a pointer to mirrored Creature
+ * @return bool true if body was found
+ */
+bool BodyStore::remove(Creature* creature)
+{
+    std::unordered_map<unsigned, size_t>::iterator it = indices.find(creature->getId());
+    if (it == indices.end() || creatures[it->second] != creature)
+        return false;
+    size_t i = it->second;
+    size_t last = creatures.size() - 1;
+    indices.erase(it);
+    if (i != last)
+    {
+        creatures[i] = creatures[last];
+        x[i] = x[last];
+        y[i] = y[last];
+        speedX[i] = speedX[last];
+        speedY[i] = speedY[last];
+        width[i] = width[last];
+        height[i] = height[last];
+        idleTicks[i] = idleTicks[last];
+        lastCollisionState[i] = lastCollisionState[last];
+        timestep[i] = timestep[last];
+        lastTick[i] = lastTick[last];
+        indices[creatures[i]->getId()] = i;
+    }
+    creatures.pop_back();
+    x.pop_back();
+    y.pop_back();
+    speedX.pop_back();
+    speedY.pop_back();
+    width.pop_back();
+    height.pop_back();
+    idleTicks.pop_back();
+    lastCollisionState.pop_back();
+    timestep.pop_back();
+    lastTick.pop_back();
+    return true;
+}
+
+/**
+ * Get number of bodies.
+ * @return size_t
+ */
+size_t BodyStore::size() const
+{
+    return creatures.size();
+}
+
+/**
+ * Copies positions and velocities of Creatures in range [begin, end) into arrays.
+ * @param begin index of first body
+ * @param end index after last body
+ * @return void
+ */
+void BodyStore::pull(size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        x[i] = creatures[i]->getX();
+        y[i] = creatures[i]->getY();
+        speedX[i] = creatures[i]->getSpeedX();
+        speedY[i] = creatures[i]->getSpeedY();
+    }
+}
+
+/**
+ * Copies positions and velocities from arrays into Creatures in range [begin, end).
+ * Creatures of bodies that aren't simulated in current step are left untouched.
+ * @param begin index of first body
+ * @param end index after last body
+ * @return void
+ */
+void BodyStore::push(size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        if (timestep[i] == 0.0)
+            continue;
+        creatures[i]->moveBy(x[i] - creatures[i]->getX(), y[i] - creatures[i]->getY());
+        creatures[i]->setSpeedVector(speedX[i], speedY[i]);
+    }
+}
+
+/**
+ * Advances bodies in range [begin, end) by their own timesteps under constant gravity.
+ * Runs vectorized over as many bodies as fit in SIMD registers, leftovers are done one by one.
+ * @param begin index of first body
+ * @param end index after last body
+ * @param gravity vertical acceleration
+ * @return void
+ * @see Integrators.h
+ */
+template <class Integrator>
+void BodyStore::integrate(size_t begin, size_t end, double gravity)
+{
+    size_t done = integrateRange<Integrator, Lanes>(*this, begin, end, gravity);
+    integrateRange<Integrator, ScalarLanes>(*this, done, end, gravity);
+}
+
+template void BodyStore::integrate<RK4Integrator>(size_t begin, size_t end, double gravity);
+template void BodyStore::integrate<SemiImplicitEulerIntegrator>(size_t begin, size_t end, double gravity);
+template void BodyStore::integrate<ConstantAccelerationIntegrator>(size_t begin, size_t end, double gravity);
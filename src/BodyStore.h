@@ -0,0 +1,148 @@
+#ifndef BODYSTORE_H
+#define BODYSTORE_H
+
+#include "Creature.h"
+#include "Integrators.h"
+#include <unordered_map>
+#include <vector>
+
+/**
+ * BodyStore is a structure-of-arrays copy of state of every simulated Creature.
+ * Physics copies positions and velocities in, integrates all bodies in one pass and copies results back.
+ * Creature stays the authoritative state between steps because Controllers and collisions change it.
+ * @see Physics
+ * @see Creature
+ */
+class BodyStore
+{
+public:
+    /**
+     * The default constructor.
+     */
+    BodyStore();
+
+    /**
+     * The default destructor.
+     */
+    ~BodyStore();
+
+    /**
+     * Removes every body.
+     * @return void
+     */
+    void clear();
+
+    /**
+     * Adds a body mirroring given Creature.
+     * @param creature a pointer to mirrored Creature
+     * @param tick number of step that body is simulated from. Defaults to 0
+     * @return void
+     */
+    void add(Creature* creature, Uint32 tick = 0);
+
+    /**
+     * Removes body mirroring given Creature. Last body takes place of removed one.
+     * @param creature a pointer to mirrored Creature
+     * @return bool true if body was found
+     */
+    bool remove(Creature* creature);
+
+    /**
+     * Get number of bodies.
+     * @return size_t
+     */
+    size_t size() const;
+
+    /**
+     * Copies positions and velocities of Creatures in range [begin, end) into arrays.
+     * @param begin index of first body
+     * @param end index after last body
+     * @return void
+     */
+    void pull(size_t begin, size_t end);
+
+    /**
+     * Copies positions and velocities from arrays into Creatures in range [begin, end).
+     * Creatures of bodies that aren't simulated in current step are left untouched.
+     * @param begin index of first body
+     * @param end index after last body
+     * @return void
+     */
+    void push(size_t begin, size_t end);
+
+    /**
+     * Advances bodies in range [begin, end) by their own timesteps under constant gravity.
+     * Runs vectorized over as many bodies as fit in SIMD registers, leftovers are done one by one.
+     * Instantiated for RK4Integrator, SemiImplicitEulerIntegrator and ConstantAccelerationIntegrator.
+     * @param begin index of first body
+     * @param end index after last body
+     * @param gravity vertical acceleration
+     * @return void
+     * @see Integrators.h
+     */
+    template <class Integrator>
+    void integrate(size_t begin, size_t end, double gravity);
+
+    /**
+     * Mirrored Creatures.
+     */
+    std::vector<Creature*> creatures;
+
+    /**
+     * X positions of bodies.
+     */
+    std::vector<double> x;
+
+    /**
+     * Y positions of bodies.
+     */
+    std::vector<double> y;
+
+    /**
+     * Velocities on X-axis of bodies.
+     */
+    std::vector<double> speedX;
+
+    /**
+     * Velocities on Y-axis of bodies.
+     */
+    std::vector<double> speedY;
+
+    /**
+     * Widths of bodies.
+     */
+    std::vector<double> width;
+
+    /**
+     * Heights of bodies.
+     */
+    std::vector<double> height;
+
+    /**
+     * Number of consecutive steps in which bodies have been resting.
+     */
+    std::vector<unsigned> idleTicks;
+
+    /**
+     * CollisionState of bodies after previous step.
+     */
+    std::vector<CollisionState> lastCollisionState;
+
+    /**
+     * Timesteps of bodies in current step, 0 if body isn't simulated in it.
+     */
+    std::vector<double> timestep;
+
+    /**
+     * Number of last step in which bodies were simulated.
+     */
+    std::vector<Uint32> lastTick;
+
+private:
+    /**
+     * Indices of bodies keyed by identifiers of their Creatures.
+     */
+    std::unordered_map<unsigned, size_t> indices;
+};
+
+#endif // BODYSTORE_H
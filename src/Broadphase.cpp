@@ -0,0 +1,19 @@
+#include "Broadphase.h"
+
+/**
+ * Broadphase implementation
+ */
+
+/**
+ * The default constructor.
+ */
+Broadphase::Broadphase()
+{
+}
+
+/**
+ * The default destructor.
+ */
+Broadphase::~Broadphase()
+{
+}
@@ -0,0 +1,62 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include "SolidObject.h"
+#include <vector>
+
+/**
+ * Broadphase is a base class for spatial indices over static level geometry.
+ * It's used by Physics to find collision candidates without testing every pair of objects.
+ * @see Physics
+ */
+class Broadphase
+{
+public:
+    /**
+     * The default constructor.
+     */
+    Broadphase();
+
+    /**
+     * The default destructor.
+     */
+    virtual ~Broadphase();
+
+    /**
+     * Builds index over given objects. Previously indexed objects are discarded.
+     * @param objects a list of objects that should be indexed
+     * @return void
+     */
+    virtual void build(std::vector<SolidObject*> const& objects) = 0;
+
+    /**
+     * Removes object from index, so it won't be returned by queries anymore.
+     * @param object a pointer to an indexed object
+     * @return void
+     */
+    virtual void remove(SolidObject* object) = 0;
+
+    /**
+     * Appends to result every indexed object that may overlap given rectangle.
+     * Every object is reported at most once, but exact overlap test is left to the caller.
+     * @param left left edge of queried rectangle
+     * @param top top edge of queried rectangle
+     * @param right right edge of queried rectangle
+     * @param bottom bottom edge of queried rectangle
+     * @param result a list to which candidates are appended
+     * @return void
+     */
+    virtual void query(double left, double top, double right, double bottom, std::vector<SolidObject*>& result) const = 0;
+
+    /**
+     * Copy constructor is deleted because index shouldn't be ever copied.
+     */
+    Broadphase(Broadphase const&) = delete;
+
+    /**
+     * Assignment operator is deleted because index shouldn't be ever copied.
+     */
+    Broadphase& operator=(Broadphase const&) = delete;
+};
+
+#endif // BROADPHASE_H
@@ -0,0 +1,68 @@
+#include "Clock.h"
+#include <SDL_timer.h>
+
+/**
+ * Clock implementation
+ */
+
+/**
+ * The default constructor.
+ */
+Clock::Clock()
+{
+}
+
+/**
+ * The default destructor.
+ */
+Clock::~Clock()
+{
+}
+
+/**
+ * Get current time.
+ * @return double time in seconds
+ */
+double Clock::getSeconds()
+{
+    return SDL_GetTicks() / 1000.0;
+}
+
+/**
+ * ManualClock implementation
+ */
+
+/**
+ * The default constructor.
+ * @param seconds initial time in seconds. Defaults to 0.0
+ */
+ManualClock::ManualClock(double seconds) :
+    seconds(seconds)
+{
+}
+
+/**
+ * The default destructor.
+ */
+ManualClock::~ManualClock()
+{
+}
+
+/**
+ * Get current time.
+ * @return double time in seconds
+ */
+double ManualClock::getSeconds()
+{
+    return seconds;
+}
+
+/**
+ * Moves clock forward.
+ * @param seconds how much time has passed
+ * @return void
+ */
+void ManualClock::advance(double seconds)
+{
+    this->seconds += seconds;
+}
@@ -0,0 +1,68 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+/**
+ * Clock is a time source for Game.
+ * Default implementation reads SDL ticks, so simulation follows real time.
+ * @see Game
+ */
+class Clock
+{
+public:
+    /**
+     * The default constructor.
+     */
+    Clock();
+
+    /**
+     * The default destructor.
+     */
+    virtual ~Clock();
+
+    /**
+     * Get current time.
+     * @return double time in seconds
+     */
+    virtual double getSeconds();
+};
+
+/**
+ * ManualClock is a Clock that only moves when told to.
+ * It lets simulation run faster or slower than real time, e.g. in headless processes.
+ */
+class ManualClock :
+    public Clock
+{
+public:
+    /**
+     * The default constructor.
+     * @param seconds initial time in seconds. Defaults to 0.0
+     */
+    ManualClock(double seconds = 0.0);
+
+    /**
+     * The default destructor.
+     */
+    ~ManualClock();
+
+    /**
+     * Get current time.
+     * @return double time in seconds
+     */
+    double getSeconds() override;
+
+    /**
+     * Moves clock forward.
+     * @param seconds how much time has passed
+     * @return void
+     */
+    void advance(double seconds);
+
+private:
+    /**
+     * Current time in seconds.
+     */
+    double seconds;
+};
+
+#endif // CLOCK_H
@@ -15,6 +15,7 @@
 Coin::Coin(double x, double y) :
     SolidObject(x, y, 1.0, 1.0)
 {
+    setKind(ObjectKind::Coin);
     SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Coin created at x:%f, y:%f", x, y);
 }
 
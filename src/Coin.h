@@ -24,5 +24,10 @@ public:
      * Coin destructor.
      */
     ~Coin();
+
+    /**
+     * Kind of objects of this class.
+     */
+    static const ObjectKind staticKind = ObjectKind::Coin;
 };
 #endif // COIN_H
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "CollisionDispatcher.h"
+#include "PlayerCreature.h"
+#include "MonsterCreature.h"
+#include "Coin.h"
+
+/**
+ * CollisionDispatcher implementation
+ */
+
+/**
+ * Handlers indexed by kind of Creature (rows) and kind of collider (columns).
+ * Kinds go in order: Object, Solid, Coin, Trigger, Creature, Player, Monster.
+ */
+CollisionDispatcher::Handler const CollisionDispatcher::table[static_cast<int>(ObjectKind::Count)][static_cast<int>(ObjectKind::Count)] =
+{
+    /* Object   */ { ignore, ignore,  ignore,      ignore,       ignore,  ignore,       ignore  },
+    /* Solid    */ { ignore, ignore,  ignore,      ignore,       ignore,  ignore,       ignore  },
+    /* Coin     */ { ignore, ignore,  ignore,      ignore,       ignore,  ignore,       ignore  },
+    /* Trigger  */ { ignore, ignore,  ignore,      ignore,       ignore,  ignore,       ignore  },
+    /* Creature */ { ignore, pushOut, ignore,      ignore,       pushOut, pushOut,      pushOut },
+    /* Player   */ { ignore, pushOut, collectCoin, ignore,       ignore,  ignore,       ignore  },
+    /* Monster  */ { ignore, pushOut, ignore,      ignore,       pushOut, attackPlayer, pushOut }
+};
+
+/**
+ * Resolves collision of a Creature with another object by their kinds.
+ * @param creature a pointer to colliding Creature
+ * @param collider a pointer to object with which Creature is colliding
+ * @return void
+ */
+void CollisionDispatcher::dispatch(Creature* creature, SolidObject* collider)
+{
+    table[static_cast<int>(creature->getKind())][static_cast<int>(collider->getKind())](creature, collider);
+}
+
+/**
+ * Does nothing.
+ * @param creature a pointer to colliding Creature
+ * @param collider a pointer to object with which Creature is colliding
+ * @return void
+ */
+void CollisionDispatcher::ignore(Creature*, SolidObject*)
+{
+}
+
+/**
+ * Pushes Creature out of collider.
+ * @param creature a pointer to colliding Creature
+ * @param collider a pointer to object with which Creature is colliding
+ * @return void
+ * @see Creature::resolveContact
+ */
+void CollisionDispatcher::pushOut(Creature* creature, SolidObject* collider)
+{
+    creature->resolveContact(collider);
+}
+
+/**
+ * PlayerCreature collects Coin.
+ * @param creature a pointer to colliding PlayerCreature
+ * @param collider a pointer to Coin
+ * @return void
+ */
+void CollisionDispatcher::collectCoin(Creature* creature, SolidObject* collider)
+{
+    static_cast<PlayerCreature*>(creature)->collectCoin(static_cast<Coin*>(collider));
+}
+
+/**
+ * MonsterCreature hurts PlayerCreature.
+ * @param creature a pointer to colliding MonsterCreature
+ * @param collider a pointer to PlayerCreature
+ * @return void
+ */
+void CollisionDispatcher::attackPlayer(Creature* creature, SolidObject* collider)
+{
+    static_cast<MonsterCreature*>(creature)->attack(static_cast<PlayerCreature*>(collider));
+}
@@ -0,0 +1,68 @@
+#ifndef COLLISIONDISPATCHER_H
+#define COLLISIONDISPATCHER_H
+
+#include "Creature.h"
+
+/**
+ * CollisionDispatcher resolves collision of a Creature with another object.
+ * Response is looked up in a constant table indexed by kinds of both objects, so types are never checked with dynamic_cast.
+ * @see Creature
+ * @see ObjectKind
+ */
+class CollisionDispatcher
+{
+public:
+    /**
+     * Resolves collision of a Creature with another object by their kinds.
+     * @param creature a pointer to colliding Creature
+     * @param collider a pointer to object with which Creature is colliding
+     * @return void
+     */
+    static void dispatch(Creature* creature, SolidObject* collider);
+
+private:
+    /**
+     * Handler is a function that resolves collision of objects of known kinds.
+     */
+    typedef void (*Handler)(Creature* creature, SolidObject* collider);
+
+    /**
+     * Handlers indexed by kind of Creature and kind of collider.
+     */
+    static Handler const table[static_cast<int>(ObjectKind::Count)][static_cast<int>(ObjectKind::Count)];
+
+    /**
+     * Does nothing.
+     * @param creature a pointer to colliding Creature
+     * @param collider a pointer to object with which Creature is colliding
+     * @return void
+     */
+    static void ignore(Creature* creature, SolidObject* collider);
+
+    /**
+     * Pushes Creature out of collider.
+     * @param creature a pointer to colliding Creature
+     * @param collider a pointer to object with which Creature is colliding
+     * @return void
+     * @see Creature::resolveContact
+     */
+    static void pushOut(Creature* creature, SolidObject* collider);
+
+    /**
+     * PlayerCreature collects Coin.
+     * @param creature a pointer to colliding PlayerCreature
+     * @param collider a pointer to Coin
+     * @return void
+     */
+    static void collectCoin(Creature* creature, SolidObject* collider);
+
+    /**
+     * MonsterCreature hurts PlayerCreature.
+     * @param creature a pointer to colliding MonsterCreature
+     * @param collider a pointer to PlayerCreature
+     * @return void
+     */
+    static void attackPlayer(Creature* creature, SolidObject* collider);
+};
+
+#endif // COLLISIONDISPATCHER_H
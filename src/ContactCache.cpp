@@ -0,0 +1,145 @@
+#include "ContactCache.h"
+#include <limits>
+
+/**
+ * ContactCache implementation
+ */
+
+/**
+ * The default constructor.
+ * @param margin how much queried box is enlarged on every side
+ */
+ContactCache::ContactCache(double margin) :
+    margin(margin),
+    obstaclesRemoved(false)
+{
+}
+
+/**
+ * The default destructor.
+ */
+ContactCache::~ContactCache()
+{
+}
+
+/**
+ * Forgets every Creature.
+ * @return void
+ */
+void ContactCache::clear()
+{
+    bodies.clear();
+    obstaclesRemoved = false;
+}
+
+/**
+ * Makes every Creature find its candidates again on next request. Sides of persisting pairs are kept.
+ * @return void
+ */
+void ContactCache::invalidate()
+{
+    obstaclesRemoved = false;
+    for (std::unordered_map<unsigned, Contacts>::iterator it = bodies.begin(); it != bodies.end(); ++it)
+    {
+        //empty box is never covering anything
+        it->second.left = std::numeric_limits<double>::infinity();
+        it->second.top = std::numeric_limits<double>::infinity();
+        it->second.right = -std::numeric_limits<double>::infinity();
+        it->second.bottom = -std::numeric_limits<double>::infinity();
+    }
+}
+
+/**
+ * Adds empty entry for a Creature. Every Creature has to be added before its contacts are asked for.
+ * @param id identifier of Creature
+ * @return void
+ */
+void ContactCache::addBody(unsigned id)
+{
+    Contacts& contacts = bodies[id];
+    //empty box is never covering anything, so first request always queries broadphase
+    contacts.left = std::numeric_limits<double>::infinity();
+    contacts.top = std::numeric_limits<double>::infinity();
+    contacts.right = -std::numeric_limits<double>::infinity();
+    contacts.bottom = -std::numeric_limits<double>::infinity();
+    contacts.obstacles.clear();
+    contacts.ids.clear();
+    contacts.sides.clear();
+}
+
+/**
+ * Forgets a Creature.
+ * @param id identifier of Creature
+ * @return void
+ */
+void ContactCache::removeBody(unsigned id)
+{
+    bodies.erase(id);
+}
+
+/**
+ * Records that a static object is about to be deleted. Its pairs are dropped by applyRemovals, so removing many objects costs a single pass.
+ * Pairs aren't searched for the object, a chunk of solids streamed out would otherwise visit every Creature once per solid.
+ * @return void
+ */
+void ContactCache::removeObstacle()
+{
+    obstaclesRemoved = true;
+}
+
+/**
+ * Makes every Creature find its candidates again if objects were removed since last call. Called before cached contacts are read.
+ * Candidates found again never hold removed objects, sides of pairs that persist are kept.
+ * @return void
+ */
+void ContactCache::applyRemovals()
+{
+    if (obstaclesRemoved)
+        invalidate();
+}
+
+/**
+ * Get cached contacts of a Creature. Candidates are found again if cached ones don't cover given box.
+ * Entries aren't added or removed here, so it can be called from several threads for different Creatures.
+ * @param id identifier of Creature
+ * @param left left edge of box that candidates have to cover
+ * @param top top edge of box that candidates have to cover
+ * @param right right edge of box that candidates have to cover
+ * @param bottom bottom edge of box that candidates have to cover
+ * @param broadphase broadphase over static objects
+ * @param scratch scratch list for found candidates
+ * @return Contacts&
+ */
+ContactCache::Contacts& ContactCache::getContacts(unsigned id, double left, double top, double right, double bottom, Broadphase const* broadphase, std::vector<SolidObject*>& scratch)
+{
+    Contacts& contacts = bodies.find(id)->second;
+    if (left >= contacts.left && top >= contacts.top && right <= contacts.right && bottom <= contacts.bottom)
+        return contacts;
+
+    contacts.left = left - margin;
+    contacts.top = top - margin;
+    contacts.right = right + margin;
+    contacts.bottom = bottom + margin;
+    scratch.clear();
+    broadphase->query(contacts.left, contacts.top, contacts.right, contacts.bottom, scratch);
+
+    //pairs found again keep their side, new ones start untouched and missing ones are dropped
+    std::vector<unsigned> ids(scratch.size());
+    std::vector<CollisionState> sides(scratch.size(), CollisionState::None);
+    for (size_t i = 0; i < scratch.size(); ++i)
+    {
+        ids[i] = scratch[i]->getId();
+        for (size_t j = 0; j < contacts.ids.size(); ++j)
+        {
+            if (contacts.ids[j] == ids[i])
+            {
+                sides[i] = contacts.sides[j];
+                break;
+            }
+        }
+    }
+    contacts.obstacles.assign(scratch.begin(), scratch.end());
+    contacts.ids.swap(ids);
+    contacts.sides.swap(sides);
+    return contacts;
+}
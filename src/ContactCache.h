@@ -0,0 +1,123 @@
+#ifndef CONTACTCACHE_H
+#define CONTACTCACHE_H
+
+#include "Creature.h"
+#include "Broadphase.h"
+#include <unordered_map>
+#include <vector>
+
+/**
+ * ContactCache keeps collision candidates of every Creature and sides of their contacts between steps of Physics.
+ * Broadphase is queried with a box enlarged by a margin and the result is reused until Creature leaves that box,
+ * so broadphase is asked only when pairs may appear or disappear. Pairs that persist keep side of their last contact.
+ * Entries are keyed by identifiers of objects, so a deleted object is never mistaken for a new one at the same address.
+ * @see Physics
+ */
+class ContactCache
+{
+public:
+    /**
+     * Contacts is a struct that holds cached candidates of a single Creature.
+     */
+    struct Contacts
+    {
+        double left;                         // edges of box that candidates were found for
+        double top;
+        double right;
+        double bottom;
+        std::vector<SolidObject*> obstacles; // candidates in order reported by broadphase
+        std::vector<unsigned> ids;           // identifiers of candidates
+        std::vector<CollisionState> sides;   // side of last contact with candidate, CollisionState::None if they weren't touching
+    };
+
+    /**
+     * The default constructor.
+     * @param margin how much queried box is enlarged on every side
+     */
+    ContactCache(double margin);
+
+    /**
+     * The default destructor.
+     */
+    ~ContactCache();
+
+    /**
+     * Forgets every Creature.
+     * @return void
+     */
+    void clear();
+
+    /**
+     * Makes every Creature find its candidates again on next request. Sides of persisting pairs are kept.
+     * @return void
+     */
+    void invalidate();
+
+    /**
+     * Adds empty entry for a Creature. Every Creature has to be added before its contacts are asked for.
+     * @param id identifier of Creature
+     * @return void
+     */
+    void addBody(unsigned id);
+
+    /**
+     * Forgets a Creature.
+     * @param id identifier of Creature
+     * @return void
+     */
+    void removeBody(unsigned id);
+
+    /**
+     * Records that a static object is about to be deleted. Its pairs are dropped by applyRemovals, so removing many objects costs a single pass.
+     * @return void
+     */
+    void removeObstacle();
+
+    /**
+     * Makes every Creature find its candidates again if objects were removed since last call. Called before cached contacts are read.
+     * @return void
+     */
+    void applyRemovals();
+
+    /**
+     * Get cached contacts of a Creature. Candidates are found again if cached ones don't cover given box.
+     * Entries aren't added or removed here, so it can be called from several threads for different Creatures.
+     * @param id identifier of Creature
+     * @param left left edge of box that candidates have to cover
+     * @param top top edge of box that candidates have to cover
+     * @param right right edge of box that candidates have to cover
+     * @param bottom bottom edge of box that candidates have to cover
+     * @param broadphase broadphase over static objects
+     * @param scratch scratch list for found candidates
+     * @return Contacts&
+     */
+    Contacts& getContacts(unsigned id, double left, double top, double right, double bottom, Broadphase const* broadphase, std::vector<SolidObject*>& scratch);
+
+    /**
+     * Copy constructor is deleted because cache shouldn't be ever copied.
+     */
+    ContactCache(ContactCache const&) = delete;
+
+    /**
+     * Assignment operator is deleted because cache shouldn't be ever copied.
+     */
+    ContactCache& operator=(ContactCache const&) = delete;
+
+private:
+    /**
+     * How much queried box is enlarged on every side.
+     */
+    const double margin;
+
+    /**
+     * Cached contacts of every Creature, keyed by its identifier.
+     */
+    std::unordered_map<unsigned, Contacts> bodies;
+
+    /**
+     * True if objects were removed since candidates were last found again.
+     */
+    bool obstaclesRemoved;
+};
+
+#endif // CONTACTCACHE_H
@@ -1,4 +1,6 @@
 #include "Controller.h"
+#include "World.h"
+#include "Snapshot.h"
 
 /**
  * Controller implementation
@@ -6,13 +8,15 @@
 
 /**
  * The default constructor with Creature possesion.
- * @param creature association of Creature object.
+ * @param world a constant pointer to World that holds Creature.
+ * @param creature handle of associated Creature.
  * @param maxSpeed an absolute value of a maximum horizontal velocity that Controller should set.
  * @see Creature
  * @see maxSpeed
  */
-Controller::Controller(Creature* creature, double maxSpeed) :
-    creature(creature),
+Controller::Controller(World const* world, ObjectHandle creature, double maxSpeed) :
+    world(world),
+    creatureHandle(creature),
     controllerState(ControllerState::GoingLeft),
     maxSpeed(maxSpeed)
 {
@@ -37,6 +41,9 @@ Controller::~Controller()
  */
 void Controller::control()
 {
+    Creature* creature = getCreature();
+    if (creature == nullptr)
+        return;
     if ((creature->getCollisionState() & CollisionState::FromLeft) == CollisionState::FromLeft ||
         (creature->getCollisionState() & CollisionState::FromRight) == CollisionState::FromRight)
     {
@@ -48,14 +55,14 @@ void Controller::control()
     switch (controllerState)
     {
     case ControllerState::GoingLeft:
-        goLeft();
+        goLeft(creature);
         break;
     case ControllerState::GoingRight:
-        goRight();
+        goRight(creature);
         break;
     case ControllerState::NotGoing:
     default:
-        stopGoing();
+        stopGoing(creature);
     }
     //creature->move();
 }
@@ -63,11 +70,11 @@ void Controller::control()
 /**
  * Get associated Creature.
  * @see Creature
- * @return Creature* a pointer to associated Creature
+ * @return Creature* a pointer to associated Creature or nullptr if it was destroyed
  */
 Creature* Controller::getCreature()
 {
-    return creature;
+    return objectCast<Creature>(world->get(creatureHandle));
 }
 
 /**
@@ -79,12 +86,35 @@ ControllerState Controller::getControllerState()
     return controllerState;
 }
 
+/**
+ * Appends state of Controller to snapshot. Associated Creature isn't saved.
+ * @param snapshot Snapshot that state is appended to
+ * @return void
+ * @see Snapshot
+ */
+void Controller::saveState(Snapshot& snapshot) const
+{
+    snapshot.write(controllerState);
+}
+
+/**
+ * Reads state of Controller appended by saveState.
+ * @param snapshot Snapshot that state is read from
+ * @return void
+ * @see Snapshot
+ */
+void Controller::loadState(Snapshot& snapshot)
+{
+    controllerState = snapshot.read<ControllerState>();
+}
+
 /**
  * Make associated Creature go left.
+ * @param creature a pointer to associated Creature
  * @see Creature
  * @return void
  */
-void Controller::goLeft()
+void Controller::goLeft(Creature* creature)
 {
     controllerState = ControllerState::GoingLeft;
     creature->setSpeedVector(-1.0*maxSpeed, creature->getSpeedY());
@@ -92,10 +122,11 @@ void Controller::goLeft()
 
 /**
  * Make associated Creature go right.
+ * @param creature a pointer to associated Creature
  * @see Creature
  * @return void
  */
-void Controller::goRight()
+void Controller::goRight(Creature* creature)
 {
     controllerState = ControllerState::GoingRight;
     creature->setSpeedVector(1.0*maxSpeed, creature->getSpeedY());
@@ -103,10 +134,11 @@ void Controller::goRight()
 
 /**
  * Make associated Creature stop going.
+ * @param creature a pointer to associated Creature
  * @see Creature
  * @return void
  */
-void Controller::stopGoing()
+void Controller::stopGoing(Creature* creature)
 {
     controllerState = ControllerState::NotGoing;
     creature->setSpeedVector(0.0, creature->getSpeedY());
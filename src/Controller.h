@@ -2,6 +2,10 @@
 #define CONTROLLER_H
 
 #include "Creature.h"
+#include "ObjectHandle.h"
+
+class World;
+class Snapshot;
 
 /**
  * The types of states that can represent a controlled Creature.
@@ -36,12 +40,13 @@ public:
 
     /**
      * The default constructor with Creature possesion.
-     * @param creature association of Creature object
+     * @param world a constant pointer to World that holds Creature
+     * @param creature handle of associated Creature
      * @param maxSpeed an absolute value of a maximum horizontal velocity that Controller should set
      * @see Creature
      * @see maxSpeed
      */
-    Controller(Creature* creature, double maxSpeed = 1.0);
+    Controller(World const* world, ObjectHandle creature, double maxSpeed = 1.0);
 
     /**
      * The default destructor.
@@ -61,7 +66,7 @@ public:
     /**
      * Get associated Creature.
      * @see Creature
-     * @return Creature* a pointer to associated Creature
+     * @return Creature* a pointer to associated Creature or nullptr if it was destroyed
      */
     Creature* getCreature();
 
@@ -70,11 +75,32 @@ public:
      * @return ControllerState
      */
     ControllerState getControllerState();
+
+    /**
+     * Appends state of Controller to snapshot. Associated Creature isn't saved.
+     * @param snapshot Snapshot that state is appended to
+     * @return void
+     * @see Snapshot
+     */
+    virtual void saveState(Snapshot& snapshot) const;
+
+    /**
+     * Reads state of Controller appended by saveState.
+     * @param snapshot Snapshot that state is read from
+     * @return void
+     * @see Snapshot
+     */
+    virtual void loadState(Snapshot& snapshot);
 protected:
     /**
-     * a protected pointer to associated Creature
+     * a protected constant pointer to World that holds associated Creature
+     */
+    World const* world;
+
+    /**
+     * a protected handle of associated Creature
      */
-    Creature* creature;
+    ObjectHandle creatureHandle;
 
     /**
      * a protected ControllerState variable
@@ -89,24 +115,27 @@ protected:
 
     /**
      * Make associated Creature go left.
+     * @param creature a pointer to associated Creature
      * @see Creature
      * @return void
      */
-    void goLeft();
+    void goLeft(Creature* creature);
 
     /**
      * Make associated Creature go right.
+     * @param creature a pointer to associated Creature
      * @see Creature
      * @return void
      */
-    void goRight();
+    void goRight(Creature* creature);
 
     /**
      * Make associated Creature stop going.
+     * @param creature a pointer to associated Creature
      * @see Creature
      * @return void
      */
-    void stopGoing();
+    void stopGoing(Creature* creature);
     
     /**
      * Assignment operator is deleted because Controller has constant variable.
@@ -1,6 +1,6 @@
 #include "Creature.h"
-#include "Coin.h"
-#include "Trigger.h"
+#include "CollisionDispatcher.h"
+#include "Snapshot.h"
 
 /**
  * Creature implementation
@@ -25,8 +25,12 @@ Creature::Creature(double x, double y, double width, double height, Uint8 health
 	wasInvulnerable(false),
 	speedX(0.0),
     speedY(0.0),
-	collisionState(CollisionState::None)
+	collisionState(CollisionState::None),
+    invTimeLeft(0.0),
+    isSleeping(false),
+    scheduleKey(0)
 {
+    setKind(ObjectKind::Creature);
     SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Creature created at x:%f, y:%f, with witdh:%f, height:%f and health:%d", x, y, width, height, health);
 }
 
@@ -40,7 +44,6 @@ Creature::~Creature()
 
 /**
  * Changes members that hold information about previous step to hold current state of Creature.
- * Also checks if invTimer has passed and disables invulnerability.
  * Sets current collisionState to noCollision.
  * @return void
  */
@@ -48,23 +51,82 @@ void Creature::savePrevious()
 {
     collisionState = CollisionState::None;
     wasInvulnerable = isInvulnerable;
+    Object::savePrevious();
+}
+
+/**
+ * Appends state of Creature to snapshot.
+ * @param snapshot Snapshot that state is appended to
+ * @return void
+ */
+void Creature::saveState(Snapshot& snapshot) const
+{
+    SolidObject::saveState(snapshot);
+    snapshot.write(health);
+    snapshot.write(isAlive);
+    snapshot.write(isInvulnerable);
+    snapshot.write(wasInvulnerable);
+    snapshot.write(speedX);
+    snapshot.write(speedY);
+    snapshot.write(collisionState);
+    snapshot.write(invTimeLeft);
+    snapshot.write(isSleeping);
+    snapshot.write(scheduleKey);
+}
+
+/**
+ * Reads state of Creature appended by saveState.
+ * @param snapshot Snapshot that state is read from
+ * @return void
+ */
+void Creature::loadState(Snapshot& snapshot)
+{
+    SolidObject::loadState(snapshot);
+    health = snapshot.read<Uint8>();
+    isAlive = snapshot.read<bool>();
+    isInvulnerable = snapshot.read<bool>();
+    wasInvulnerable = snapshot.read<bool>();
+    speedX = snapshot.read<double>();
+    speedY = snapshot.read<double>();
+    collisionState = snapshot.read<CollisionState>();
+    invTimeLeft = snapshot.read<double>();
+    isSleeping = snapshot.read<bool>();
+    scheduleKey = snapshot.read<unsigned>();
+}
+
+/**
+ * Advances simulated time of Creature, disables invulnerability once it has passed.
+ * Invulnerability follows simulation time instead of wall clock, so simulation can run at any speed.
+ * @param seconds how much simulated time has passed
+ * @return void
+ */
+void Creature::advanceTime(double seconds)
+{
     if (isInvulnerable)
-        if (invTimer.getTicks() > invFrames)
+    {
+        invTimeLeft -= seconds;
+        if (invTimeLeft < 0.0)
         {
             isInvulnerable = false;
-            invTimer.stop();
+            invTimeLeft = 0.0;
         }
-    Object::savePrevious();
+    }
 }
 
 /**
  * Changes relatively current position of Creature.
+ * Wakes Creature up if it's moved.
  * @param x relative change of position on X axis
  * @param y relative change of position on Y axis
  * @return void
  */
 void Creature::moveBy(double x, double y)
 {
+    if (x != 0.0 || y != 0.0)
+    {
+        isSleeping = false;
+        markChanged(ChangeFlags::Moved);
+    }
     this->x += x;
     this->y += y;
 }
@@ -73,30 +135,36 @@ void Creature::moveBy(double x, double y)
  * Changes health of Creature.
  * If damage equals 127 or is less than or equal to 0 then it ignores invulnerability.
  * Else deal damage only if Creature is not Invulnerable and set invulnerability of Creature.
+ * Wakes Creature up.
  * @param damage how much damage Creature takes
  * @return void
  */
 void Creature::hurt(Sint8 damage)
 { 
+    isSleeping = false;
 	if (!isInvulnerable || damage==127)
 	{
+        markChanged(ChangeFlags::Hurt);
         health -= (health - damage < 0) ? health : damage;
 		if (health <= 0)
 			isAlive = false;
 		isInvulnerable = true;
-		invTimer.start();
+		invTimeLeft = invFrames / 1000.0;
 	}
 	
 }
 
 /**
  * Changes current velocity vector of Creature.
+ * Wakes Creature up if velocity is different than current one.
  * @param x new velocity value on X axis
  * @param y new velocity value on Y axis
  * @return void
  */
 void Creature::setSpeedVector(double x, double y)
 {
+    if (x != speedX || y != speedY)
+        isSleeping = false;
     speedX=x;
     speedY=y;
 }
@@ -112,64 +180,103 @@ void Creature::addCollisionState(CollisionState state)
 }
 
 /**
- * Virtual function for resolving collision.
- * Default implementation ignores Coin and Trigger and solves collision with SolidObject.
+ * Puts Creature to sleep. Physics doesn't simulate sleeping Creature until it's woken up.
+ * @return void
+ * @see Physics
+ */
+void Creature::sleep()
+{
+    isSleeping = true;
+}
+
+/**
+ * Wakes Creature up, so Physics simulates it again.
+ * @return void
+ */
+void Creature::wake()
+{
+    isSleeping = false;
+}
+
+/**
+ * Resolves collision with another object.
+ * Response is looked up by kinds of both objects in CollisionDispatcher, so no dynamic_cast is needed.
  * @param collider a pointer to a SolidObject with which Creature is colliding
  * @return void
+ * @see CollisionDispatcher
  */
 void Creature::onCollision(SolidObject* collider)
 {
     //collider is guaranteed here to not be a nullptr but just to be safe
     if (collider == nullptr)
         return;
+    CollisionDispatcher::dispatch(this, collider);
+}
 
-	//here ignore coin
-    if (dynamic_cast<Coin*>(collider))
-        return;
-
-    //here ignore trigger
-    if (dynamic_cast<Trigger*>(collider))
-        return;
+/**
+ * Pushes Creature out of plain SolidObject it overlaps, which is the default response of onCollision.
+ * If Creature landed on the same object in previous step, that side is checked first without the full test.
+ * @param collider a pointer to overlapped object
+ * @param side side from which Creature collided with the object in previous step. Defaults to CollisionState::None, which means unknown
+ * @return CollisionState side from which Creature has collided, CollisionState::None if it wasn't pushed
+ */
+CollisionState Creature::resolveContact(SolidObject const* collider, CollisionState side)
+{
+	double enterY = (y + height) - collider->getY();
+    //standing on the same object as in previous step is the common case
+    if (side == CollisionState::FromAbove && enterY > 0 && y + height - 0.2 < collider->getY() &&
+        (y + height / 2.0) <= (collider->getY() + collider->getHeight() / 2.0))
+    {
+        moveBy(0, -enterY);
+        collisionState |= CollisionState::FromAbove;
+        setSpeedVector(speedX, 0.0);
+        return CollisionState::FromAbove;
+    }
 
 	double tmpX = speedX;
 	double tmpY = speedY;
 
-	double enterY = (y + height) - collider->getY();
 	double enterX = (x + width) - collider->getX();
     SDL_LogVerbose(SDL_LOG_CATEGORY_APPLICATION, "My X:%f My Y:%f SpeedX:%f SpeedY:%f EnterX:%f EnterY:%f\n", x, y, tmpX, tmpY, enterX, enterY);
 	if (enterY > 0 && (y + height - 0.2 < collider->getY() || y > collider->getY() + collider->getHeight() - 0.2))
 	{
+		CollisionState pushedFrom;
 		if ((y + height / 2.0) <= (collider->getY() + collider->getHeight() / 2.0))
 		{
             SDL_LogVerbose(SDL_LOG_CATEGORY_APPLICATION, "His Height:%f\n", collider->getY() + collider->getHeight() / 2);
 			moveBy(0, -enterY);
             SDL_LogVerbose(SDL_LOG_CATEGORY_APPLICATION, "Move up");
-			collisionState |= CollisionState::FromAbove;
+			pushedFrom = CollisionState::FromAbove;
 		}
 		else
 		{
 			moveBy(0, (collider->getY() + collider->getHeight()) - y);
             SDL_LogVerbose(SDL_LOG_CATEGORY_APPLICATION, "Move down");
-			collisionState |= CollisionState::FromBelow;
+			pushedFrom = CollisionState::FromBelow;
 		}
+		collisionState |= pushedFrom;
 		setSpeedVector(tmpX, 0.0);
-		return;
+		return pushedFrom;
 	}
 	tmpY = speedY;
 	if (enterX > 0)
 	{
+		CollisionState pushedFrom;
 		if ((x + width / 2.0) <= (collider->getX() + collider->getWidth() / 2.0))
 		{
 			moveBy(-enterX, 0);
-			collisionState |= CollisionState::FromLeft;
+			pushedFrom = CollisionState::FromLeft;
 		}
 		else
 		{
 			moveBy((collider->getX() + collider->getWidth()) - x, 0);
-			collisionState |= CollisionState::FromRight;
+			pushedFrom = CollisionState::FromRight;
 		}
+		collisionState |= pushedFrom;
 		setSpeedVector(0.0, tmpY);
+		return pushedFrom;
 	}
+	return CollisionState::None;
 }
 
 /**
@@ -234,3 +341,32 @@ CollisionState Creature::getCollisionState() const
 {
     return collisionState;
 }
+
+
+/**
+ * Check if Creature is sleeping.
+ * @return bool
+ */
+bool Creature::getIsSleeping() const
+{
+    return isSleeping;
+}
+
+/**
+ * Changes key that spreads coarse steps of Creature far from players, see LodScheduler.
+ * @param key new key
+ * @return void
+ */
+void Creature::setScheduleKey(unsigned key)
+{
+    scheduleKey = key;
+}
+
+/**
+ * Get key that spreads coarse steps of Creature far from players.
+ * @return unsigned
+ */
+unsigned Creature::getScheduleKey() const
+{
+    return scheduleKey;
+}
@@ -2,7 +2,7 @@
 #define CREATURE_H
 
 #include "SolidObject.h"
-#include "Timer.h"
+#include <SDL.h>
 
 /**
  * The types of states that can represent a collision of a Creature.
@@ -92,16 +92,43 @@ public:
      */
     virtual ~Creature();
 
+    /**
+     * Kind of objects of this class.
+     */
+    static const ObjectKind staticKind = ObjectKind::Creature;
+
     /**
      * Changes members that hold information about previous step to hold current state of Creature.
-     * Also checks if invTimer has passed and disables invulnerability.
      * Sets current collisionState to noCollision.
      * @return void
      */
     void savePrevious() override;
 
+    /**
+     * Appends state of Creature to snapshot.
+     * @param snapshot Snapshot that state is appended to
+     * @return void
+     */
+    void saveState(Snapshot& snapshot) const override;
+
+    /**
+     * Reads state of Creature appended by saveState.
+     * @param snapshot Snapshot that state is read from
+     * @return void
+     */
+    void loadState(Snapshot& snapshot) override;
+
+    /**
+     * Advances simulated time of Creature, disables invulnerability once it has passed.
+     * Invulnerability follows simulation time instead of wall clock, so simulation can run at any speed.
+     * @param seconds how much simulated time has passed
+     * @return void
+     */
+    void advanceTime(double seconds);
+
     /**
      * Changes relatively current position of Creature.
+     * Wakes Creature up if it's moved.
      * @param x relative change of position on X axis
      * @param y relative change of position on Y axis
      * @return void
@@ -112,6 +139,7 @@ public:
      * Changes health of Creature.
      * If damage equals 127 or is less than or equal to 0 then it ignores invulnerability.
      * Else deal damage only if Creature is not Invulnerable and set invulnerability of Creature.
+     * Wakes Creature up.
      * @param damage how much damage Creature takes
      * @return void
      */
@@ -119,6 +147,7 @@ public:
 
     /**
      * Changes current velocity vector of Creature.
+     * Wakes Creature up if velocity is different than current one.
      * @param x new velocity value on X axis
      * @param y new velocity value on Y axis
      * @return void
@@ -133,12 +162,35 @@ public:
     void addCollisionState(CollisionState state);
 
     /**
-     * Virtual function for resolving collision.
-     * Default implementation ignores Coin and Trigger and solves collision with SolidObject. 
+     * Puts Creature to sleep. Physics doesn't simulate sleeping Creature until it's woken up.
+     * @return void
+     * @see Physics
+     */
+    void sleep();
+
+    /**
+     * Wakes Creature up, so Physics simulates it again.
+     * @return void
+     */
+    void wake();
+
+    /**
+     * Resolves collision with another object.
+     * Response is looked up by kinds of both objects in CollisionDispatcher, so no dynamic_cast is needed.
      * @param collider a pointer to a SolidObject with which Creature is colliding
      * @return void
+     * @see CollisionDispatcher
+     */
+    void onCollision(SolidObject* collider);
+
+    /**
+     * Pushes Creature out of plain SolidObject it overlaps, which is the default response of onCollision.
+     * If Creature landed on the same object in previous step, that side is checked first without the full test.
+     * @param collider a pointer to overlapped object
+     * @param side side from which Creature collided with the object in previous step. Defaults to CollisionState::None, which means unknown
+     * @return CollisionState side from which Creature has collided, CollisionState::None if it wasn't pushed
      */
-    virtual void onCollision(SolidObject* collider);
+    CollisionState resolveContact(SolidObject const* collider, CollisionState side = CollisionState::None);
 
     /**
      * Get current health of Creature.
@@ -182,6 +234,25 @@ public:
      */
     CollisionState getCollisionState() const;
 
+    /**
+     * Check if Creature is sleeping.
+     * @return bool
+     */
+    bool getIsSleeping() const;
+
+    /**
+     * Changes key that spreads coarse steps of Creature far from players, see LodScheduler.
+     * @param key new key
+     * @return void
+     */
+    void setScheduleKey(unsigned key);
+
+    /**
+     * Get key that spreads coarse steps of Creature far from players.
+     * @return unsigned
+     */
+    unsigned getScheduleKey() const;
+
     /**
      * Assignment operator is deleted because of constant member initialized on Construction.
      */
@@ -194,7 +265,7 @@ protected:
     Uint8 health;
     
     /**
-     * Constant number of invulnerability frames of Creature.
+     * Constant duration of invulnerability of Creature in milliseconds of simulation time.
      */
     Uint32 const invFrames;
 
@@ -229,9 +300,19 @@ protected:
     CollisionState collisionState;
 
     /**
-     * Timer used to calculate a period of invulnerability of Creature.
+     * Simulation time in seconds left until invulnerability of Creature ends.
+     */
+    double invTimeLeft;
+
+    /**
+     * True if Creature is resting and isn't simulated by Physics.
+     */
+    bool isSleeping;
+
+    /**
+     * Key that spreads coarse steps of Creature far from players, given by World in order of creation.
      */
-    Timer invTimer;
+    unsigned scheduleKey;
 };
 
 #endif // CREATURE_H
@@ -0,0 +1,146 @@
+#include "DirtySet.h"
+#include <SDL_log.h>
+#include <algorithm>
+
+/**
+ * DirtySet implementation
+ */
+
+const size_t DirtySet::noIndex;
+
+/**
+ * The default constructor.
+ * @param capacity number of entries allocated up front. Defaults to 256
+ */
+DirtySet::DirtySet(size_t capacity) :
+    entries(capacity),
+    count(0),
+    allChanged(false)
+{
+}
+
+/**
+ * The default destructor.
+ */
+DirtySet::~DirtySet()
+{
+}
+
+/**
+ * Forgets every change and lets objects be added again. Array of entries grows if set has overflowed.
+ * Only changed objects are visited.
+ * @return void
+ */
+void DirtySet::clear()
+{
+    size_t used = getCount();
+    for (size_t i = 0; i < used; ++i)
+        if (entries[i].object != nullptr)
+            entries[i].object->forgetChanges();
+    if (count > entries.size())
+    {
+        size_t capacity = std::max(size_t(count), entries.size() * 2);
+        SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "DirtySet grows to %u entries", unsigned(capacity));
+        entries.resize(capacity);
+    }
+    count = 0;
+    allChanged = false;
+}
+
+/**
+ * Forgets every change without touching objects, because they were destroyed together, and marks every object as changed.
+ * @return void
+ */
+void DirtySet::reset()
+{
+    count = 0;
+    allChanged = true;
+}
+
+/**
+ * Marks every object as changed until set is cleared.
+ * @return void
+ */
+void DirtySet::markAll()
+{
+    allChanged = true;
+}
+
+/**
+ * Claims an entry for an object. Called by object on its first change.
+ * @param object a pointer to changed object
+ * @return size_t index of entry or noIndex if set has overflowed
+ */
+size_t DirtySet::add(Object* object)
+{
+    size_t index = count.fetch_add(1, std::memory_order_relaxed);
+    if (index >= entries.size())
+        return noIndex;
+    Entry& entry = entries[index];
+    entry.object = object;
+    entry.id = object->getId();
+    entry.kind = object->getKind();
+    entry.flags = ChangeFlags::None;
+    return index;
+}
+
+/**
+ * Records that an object was removed from World. Object can't be reached through its entry afterwards.
+ * Object that hasn't changed yet claims its entry the way its other changes do, so later changes in the same step land in that entry too.
+ * @param object a pointer to removed object, which records its changes in this set
+ * @return void
+ */
+void DirtySet::remove(Object* object)
+{
+    object->markChanged(ChangeFlags::Removed);
+    size_t index = object->getDirtyIndex();
+    if (index != noIndex)
+        entries[index].object = nullptr;
+}
+
+/**
+ * Get entry of a changed object.
+ * @param index index of entry, lower than getCount
+ * @return Entry&
+ */
+DirtySet::Entry& DirtySet::getEntry(size_t index)
+{
+    return entries[index];
+}
+
+/**
+ * Get entry of a changed object.
+ * @param index index of entry, lower than getCount
+ * @return Entry const&
+ */
+DirtySet::Entry const& DirtySet::getEntry(size_t index) const
+{
+    return entries[index];
+}
+
+/**
+ * Get number of recorded entries.
+ * @return size_t
+ */
+size_t DirtySet::getCount() const
+{
+    return std::min(size_t(count), entries.size());
+}
+
+/**
+ * Check if every object should be treated as changed, because set has overflowed or level was replaced.
+ * @return bool
+ */
+bool DirtySet::getAllChanged() const
+{
+    return allChanged || count > entries.size();
+}
+
+/**
+ * Check if nothing changed.
+ * @return bool
+ */
+bool DirtySet::isEmpty() const
+{
+    return count == 0 && !allChanged;
+}
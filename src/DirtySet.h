@@ -0,0 +1,139 @@
+#ifndef DIRTYSET_H
+#define DIRTYSET_H
+
+#include "Object.h"
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * DirtySet records which game objects changed since it was cleared and how.
+ * Objects add themselves when they're created, moved, hurt, destroyed or removed, so nothing is scanned and a step in which nothing changed leaves set empty.
+ * Every object takes a single entry, claimed with an atomic counter on its first change, so objects simulated on different threads can be recorded at the same time.
+ * Entries live in an array that is sized up front. If more objects change than it holds, set is marked as overflowed and grows when it's cleared,
+ * so consumers should treat every object as changed. Every object is also reported as changed after a whole level is replaced.
+ * @see Object
+ * @see World
+ */
+class DirtySet
+{
+public:
+    /**
+     * Entry is a struct that holds changes of a single object.
+     */
+    struct Entry
+    {
+        Object* object;    // changed object, nullptr once it's removed
+        unsigned id;       // identifier of object
+        ObjectKind kind;   // kind of object
+        ChangeFlags flags; // what has changed
+    };
+
+    /**
+     * Index that doesn't refer to an entry.
+     */
+    static const size_t noIndex = ~size_t(0);
+
+    /**
+     * The default constructor.
+     * @param capacity number of entries allocated up front. Defaults to 256
+     */
+    DirtySet(size_t capacity = 256);
+
+    /**
+     * The default destructor.
+     */
+    ~DirtySet();
+
+    /**
+     * Forgets every change and lets objects be added again. Array of entries grows if set has overflowed.
+     * @return void
+     */
+    void clear();
+
+    /**
+     * Forgets every change without touching objects, because they were destroyed together, and marks every object as changed.
+     * @return void
+     */
+    void reset();
+
+    /**
+     * Marks every object as changed until set is cleared.
+     * @return void
+     */
+    void markAll();
+
+    /**
+     * Claims an entry for an object. Called by object on its first change.
+     * @param object a pointer to changed object
+     * @return size_t index of entry or noIndex if set has overflowed
+     */
+    size_t add(Object* object);
+
+    /**
+     * Records that an object was removed from World. Object can't be reached through its entry afterwards.
+     * @param object a pointer to removed object, which records its changes in this set
+     * @return void
+     */
+    void remove(Object* object);
+
+    /**
+     * Get entry of a changed object.
+     * @param index index of entry, lower than getCount
+     * @return Entry&
+     */
+    Entry& getEntry(size_t index);
+
+    /**
+     * Get entry of a changed object.
+     * @param index index of entry, lower than getCount
+     * @return Entry const&
+     */
+    Entry const& getEntry(size_t index) const;
+
+    /**
+     * Get number of recorded entries.
+     * @return size_t
+     */
+    size_t getCount() const;
+
+    /**
+     * Check if every object should be treated as changed, because set has overflowed or level was replaced.
+     * @return bool
+     */
+    bool getAllChanged() const;
+
+    /**
+     * Check if nothing changed.
+     * @return bool
+     */
+    bool isEmpty() const;
+
+    /**
+     * Copy constructor is deleted because objects refer to their set.
+     */
+    DirtySet(DirtySet const&) = delete;
+
+    /**
+     * Assignment operator is deleted because objects refer to their set.
+     */
+    DirtySet& operator=(DirtySet const&) = delete;
+
+private:
+    /**
+     * Entries, only the first count of them are used.
+     */
+    std::vector<Entry> entries;
+
+    /**
+     * Number of claimed entries, can be higher than number of entries once set has overflowed.
+     */
+    std::atomic<size_t> count;
+
+    /**
+     * True if every object should be treated as changed.
+     */
+    bool allChanged;
+};
+
+#endif // DIRTYSET_H
@@ -1,7 +1,12 @@
 #include "Game.h"
-#include "Coin.h"
-#include "MonsterCreature.h"
-#include "Trigger.h"
+#include "World.h"
+#include "LevelFile.h"
+#include "LevelStreamer.h"
+#include "RenderFrame.h"
+#include "GameDefs.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 /**
  * Game implementation
@@ -10,16 +15,42 @@
 /**
  * The default constructor.
  * Sets gameState to menu.
+ * @param clock a pointer to Clock that drives simulation in gameLoop. Defaults to nullptr, which means real time
  * @see GameState
+ * @see Clock
  */
-Game::Game():
+Game::Game(Clock* clock):
+    world(new World()),
 	gameState(GameState::Menu),
 	posUpdated(false),
+    changeVersion(0),
+    levelReplaced(false),
 	levelWidth(0),
 	levelHeight(0),
     levelCoins(0),
+    levelPath(GameDefinitions::levelPath),
+    levelStreaming(true),
+    streamer(nullptr),
+    hasView(false),
+    viewLeft(0.0),
+    viewRight(0.0),
+    levelIntegrator(IntegratorType::RK4),
+    levelSourceHeader(),
 	levelLoaded(false),
-	posAlpha(1.0)
+	posAlpha(1.0),
+    broadphaseType(BroadphaseType::Tree),
+    physicsWorkerCount(0),
+    physicsTimestep(0.01),
+    continuousCollision(false),
+    lodDistance(GameDefinitions::lodDistance),
+    lodPeriod(GameDefinitions::lodPeriod),
+    lastControlTick(0),
+    clock(clock != nullptr ? clock : &defaultClock),
+    lastTime(0.0),
+    input(&defaultInput),
+    replaying(false),
+    rewindEnabled(false),
+    rewindBuffer(GameDefinitions::rewindBufferSize, GameDefinitions::rewindSeconds, GameDefinitions::rewindKeyframeInterval)
 {
     SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Game created!");
 }
@@ -31,77 +62,102 @@ Game::Game():
 Game::~Game()
 {
 	unloadLevel();
+    delete world;
     SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Game destroyed!");
 }
 
 /**
- * Updates current state of game.
+ * Updates current state of game by time that has passed on clock since last update.
+ * Clock decides how many fixed steps are due, every one of them runs the whole pipeline of tick.
  * @return void
  */
 void Game::gameLoop()
 {
-    posUpdated = false;
+    beginChanges();
 
     if (gameState == GameState::Playing)
     {
-
-        //move everything
-        std::list<Controller*>::iterator it;
-        for (it = controllerList.begin(); it != controllerList.end(); ++it)
-        {
-            if ((*it)->getCreature()->getY() > levelHeight)
-            {
-                (*it)->getCreature()->hurt(127);
-            }
-            if (!(*it)->getCreature()->getIsAlive()) //hide corpses in the closet
-            {
-                posUpdated = true;
-                PlayerController* tmpPC = dynamic_cast<PlayerController*>(*it);
-                if (tmpPC != nullptr)
-                    gameState = GameState::Lost;
-                (*it)->getCreature()->destroy();
-                delete (*it);
-                controllerList.erase(it);
-                it = controllerList.begin();
-                if (it == controllerList.end())
-                    break;
-                continue;
-            }
-            (*it)->control();
-        }
-        //clear destroyed objects
-        for (std::list<Object*>::iterator it = objectList.begin(); it != objectList.end(); ++it)
-        {
-            if ((*it)->getDestroyed())
-            {
-                delete (*it);
-                objectList.erase(it);
-                it = objectList.begin();
-                if (it == objectList.end())
-                    break;
-            }
-        }
-        //untrigger the triggers
-        std::for_each(objectList.begin(), objectList.end(), [](Object* o){ Trigger* tmpT = dynamic_cast<Trigger*>(o); if (tmpT != nullptr) tmpT->untrigger(); });
-        //do physics
-        posAlpha = physics->update(objectList);
-        //check if positions were updated
-        checkPositions();
+        double newTime = clock->getSeconds();
+        unsigned ticks = physics->advance(newTime - lastTime);
+        lastTime = newTime;
+        //chunks are read in background, so a step never waits for disk, unless run has to be reproducible
+        for (unsigned i = 0; i < ticks && gameState == GameState::Playing; ++i)
+            tick(getDeterministic());
+        posAlpha = physics->getAlpha();
+        recordRewind();
     }
     if (gameState == GameState::Menu)
         if (levelLoaded)
             unloadLevel();
+    endChanges();
+}
+
+/**
+ * Updates current state of game by exact number of fixed steps, regardless of clock.
+ * Every step runs the whole pipeline of tick, so it doesn't need SDL to be initialized.
+ * Missing chunks are read right away, so stepping the same level with the same input always gives the same World.
+ * @param ticks number of steps
+ * @return void
+ */
+void Game::step(unsigned ticks)
+{
+    beginChanges();
+
+    for (unsigned i = 0; i < ticks && gameState == GameState::Playing; ++i)
+    {
+        tick(true);
+        posAlpha = 1.0;
+        recordRewind();
+    }
+    endChanges();
+}
+
+/**
+ * Runs a single fixed step: samples input, updates Controllers, removes destroyed objects, streams chunks and steps Physics.
+ * Everything that changes World happens in steps, so a run depends only on input of every step and not on how steps were grouped into frames.
+ * Level of detail is focused on players once at start, so Controllers and Physics agree on which Creatures are far.
+ * @param wait true to read missing chunks right away, false to let LevelStreamer read them in background
+ * @return void
+ */
+void Game::tick(bool wait)
+{
+    InputButton buttons = readInput();
+    physics->focusLevelOfDetail(*world);
+    updateControllers();
+    removeDestroyedObjects();
+    if (streamer != nullptr)
+        updateStreaming(wait);
+    physics->step(*world, 1);
+    recorder.record(buttons);
 }
 
 /**
  * Changes gameState to GameState::Playing and loads level.
+ * Level is loaded from level path, built-in level is loaded if that fails.
  * @return void
+ * @see setLevelPath
  */
 void Game::startGame()
 {
 	//Load level
-	loadLevel();
+	bool fromFile = !levelPath.empty() && loadLevel(levelPath);
+	if (!fromFile)
+		loadLevel();
 	gameState = GameState::Playing;
+	if (!recordPath.empty())
+	{
+		InputSettings settings;
+		settings.levelPath = fromFile ? levelPath : std::string();
+		settings.timestep = physicsTimestep;
+		settings.streaming = fromFile && levelStreaming;
+		settings.continuousCollision = continuousCollision;
+		settings.broadphase = Uint8(broadphaseType);
+		settings.workerCount = physicsWorkerCount;
+		settings.lodDistance = lodDistance;
+		settings.lodPeriod = lodPeriod;
+		recorder.open(recordPath.c_str(), settings);
+		recordPath.clear();
+	}
 }
 
 /**
@@ -150,66 +206,209 @@ void Game::wonGame()
 }
 
 /**
- * Unloads level if loaded, loads level and initializes Physics.
+ * Unloads level if loaded, loads built-in level and initializes Physics.
  * @return void
  * @see Physics
  */
 void Game::loadLevel()
 {
     unloadLevel();
-	objectList.push_back(new SolidObject(0, 17, 24, 3));
-	objectList.push_back(new SolidObject(28, 17, 8, 3));
-	objectList.push_back(new SolidObject(52, 17, 8, 3));
-	objectList.push_back(new SolidObject(8, 15.5, 2, 1.5));
-	objectList.push_back(new SolidObject(14, 14.5, 2, 2.5));
-	objectList.push_back(new SolidObject(20, 14.5, 2, 2.5));
-    objectList.push_back(new SolidObject(39, 14.5, 3, 1));
-    objectList.push_back(new SolidObject(46, 14.5, 3, 1));
-    objectList.push_back(new SolidObject(56, 0, 4, 14));
-    objectList.push_back(new SolidObject(32, 13, 4, 1));
-    objectList.push_back(new SolidObject(28, 10.5, 3, 1));
-    objectList.push_back(new SolidObject(20, 9.5, 4, 1));
-    objectList.push_back(new SolidObject(17, 0, 2, 8.5));
-    objectList.push_back(new SolidObject(10, 9.5, 6, 1));
-    objectList.push_back(new SolidObject(2, 7, 8, 1));
-
-	objectList.push_back(new PlayerCreature(1, 16));
-	playerController = new PlayerController(dynamic_cast<PlayerCreature*> (objectList.back()));
-	controllerList.push_back(playerController);
-    objectList.push_back(new MonsterCreature(9, 14.5, 1, 1));
-    controllerList.push_back(new Controller(dynamic_cast<Creature*> (objectList.back())));
-    objectList.push_back(new MonsterCreature(19, 16, 1, 1));
-    controllerList.push_back(new Controller(dynamic_cast<Creature*> (objectList.back())));
-
-    objectList.push_back(new Coin(4, 14));
+    world->solids.create(0, 17, 24, 3);
+    world->solids.create(28, 17, 8, 3);
+    world->solids.create(52, 17, 8, 3);
+    world->solids.create(8, 15.5, 2, 1.5);
+    world->solids.create(14, 14.5, 2, 2.5);
+    world->solids.create(20, 14.5, 2, 2.5);
+    world->solids.create(39, 14.5, 3, 1);
+    world->solids.create(46, 14.5, 3, 1);
+    world->solids.create(56, 0, 4, 14);
+    world->solids.create(32, 13, 4, 1);
+    world->solids.create(28, 10.5, 3, 1);
+    world->solids.create(20, 9.5, 4, 1);
+    world->solids.create(17, 0, 2, 8.5);
+    world->solids.create(10, 9.5, 6, 1);
+    world->solids.create(2, 7, 8, 1);
+
+    playerController = world->playerControllers.getHandle(world->playerControllers.create(world, world->getHandle(world->players.create(1, 16))));
+    world->controllers.create(world, world->getHandle(world->monsters.create(9, 14.5, 1, 1)));
+    world->controllers.create(world, world->getHandle(world->monsters.create(19, 16, 1, 1)));
+
+    world->coins.create(4, 14);
     ++levelCoins;
-    objectList.push_back(new Coin(14.5, 12));
+    world->coins.create(14.5, 12);
     ++levelCoins;
-    objectList.push_back(new Coin(20.5, 13));
+    world->coins.create(20.5, 13);
     ++levelCoins;
-    objectList.push_back(new Coin(43.5, 12));
+    world->coins.create(43.5, 12);
     ++levelCoins;
-    objectList.push_back(new Coin(33.5, 10.5));
+    world->coins.create(33.5, 10.5);
     ++levelCoins;
-    objectList.push_back(new Coin(21.5, 7));
+    world->coins.create(21.5, 7);
     ++levelCoins;
-    objectList.push_back(new Coin(13.5, 7));
+    world->coins.create(13.5, 7);
     ++levelCoins;
-    objectList.push_back(new Coin(11.5, 7));
+    world->coins.create(11.5, 7);
     ++levelCoins;
-    objectList.push_back(new Coin(7.5, 4.5));
+    world->coins.create(7.5, 4.5);
     ++levelCoins;
-    objectList.push_back(new Coin(5.5, 4.5));
+    world->coins.create(5.5, 4.5);
     ++levelCoins;
-    objectList.push_back(new Coin(3.5, 4.5));
+    world->coins.create(3.5, 4.5);
     ++levelCoins;
 
-    objectList.push_back(new Trigger(this, &Game::wonGame, nullptr, nullptr, 59, 14, 1, 3));
+    world->triggers.create(this, &Game::wonGame, nullptr, nullptr, 59, 14, 1, 3);
 
 	levelWidth = 60;
 	levelHeight = 20;
+    levelIntegrator = IntegratorType::ConstantAcceleration;
+    levelSource.clear();
+    levelSourceHeader = LevelHeader();
+    buildNavigation();
+    startPhysics();
+}
+
+/**
+ * Unloads level if loaded, loads level from binary level file and initializes Physics.
+ * If level streaming is on, only chunks of level around view are kept in World.
+ * Physics moves objects with integrator named by level.
+ * Loaded level is kept if file can't be read.
+ * @param path path to binary level file
+ * @return bool true if level was loaded
+ * @see LevelFile
+ * @see LevelStreamer
+ */
+bool Game::loadLevel(std::string const& path)
+{
+    if (levelStreaming)
+    {
+        LevelStreamer* newStreamer = new LevelStreamer(GameDefinitions::chunkWidth);
+        if (!newStreamer->open(path.c_str()))
+        {
+            delete newStreamer;
+            return false;
+        }
+        unloadLevel();
+        streamer = newStreamer;
+        LevelHeader const& header = streamer->getHeader();
+        LevelPoint const& player = streamer->getPlayer();
+        playerController = world->playerControllers.getHandle(world->playerControllers.create(world, world->getHandle(world->players.create(player.x, player.y))));
+        levelCoins = header.coinCount;
+        levelWidth = int(header.width);
+        levelHeight = int(header.height);
+        levelIntegrator = IntegratorType(header.integrator);
+        levelSource = path;
+        levelSourceHeader = header;
+        loadBehaviors(streamer->getLevel());
+        buildNavigation();
+        hasView = false;
+        startPhysics();
+        updateStreaming(true);
+        return true;
+    }
+
+    LevelFile level;
+    if (!level.open(path.c_str()))
+        return false;
+    unloadLevel();
+    LevelHeader const& header = level.getHeader();
+
+    LevelBox const* solids = level.getSolids();
+    for (Uint32 i = 0; i < header.solidCount; ++i)
+        world->solids.create(solids[i].x, solids[i].y, solids[i].width, solids[i].height);
+
+    LevelPoint const* players = level.getPlayers();
+    playerController = world->playerControllers.getHandle(world->playerControllers.create(world, world->getHandle(world->players.create(players[0].x, players[0].y))));
+    loadBehaviors(level);
+    LevelMonster const* monsters = level.getMonsters();
+    for (Uint32 i = 0; i < header.monsterCount; ++i)
+    {
+        LevelBox const& box = monsters[i].box;
+        world->controllers.create(world, world->getHandle(world->monsters.create(box.x, box.y, box.width, box.height)), findBehavior(monsters[i].behavior));
+    }
+
+    LevelPoint const* coins = level.getCoins();
+    for (Uint32 i = 0; i < header.coinCount; ++i)
+        world->coins.create(coins[i].x, coins[i].y);
+    levelCoins = header.coinCount;
+
+    LevelTrigger const* triggers = level.getTriggers();
+    for (Uint32 i = 0; i < header.triggerCount; ++i)
+        if (triggers[i].action == Uint32(TriggerAction::Win))
+            world->triggers.create(this, &Game::wonGame, nullptr, nullptr, triggers[i].box.x, triggers[i].box.y, triggers[i].box.width, triggers[i].box.height);
+
+    levelWidth = int(header.width);
+    levelHeight = int(header.height);
+    levelIntegrator = IntegratorType(header.integrator);
+    levelSource = path;
+    levelSourceHeader = header;
+    buildNavigation();
+    startPhysics();
+    return true;
+}
+
+/**
+ * Changes path of level file loaded by startGame.
+ * @param path path to binary level file, empty to always load built-in level
+ * @return void
+ */
+void Game::setLevelPath(std::string const& path)
+{
+    levelPath = path;
+}
+
+/**
+ * Turns level streaming on or off. Applies to levels loaded later.
+ * @param enabled true to keep only chunks of level around view in World
+ * @return void
+ * @see LevelStreamer
+ */
+void Game::setLevelStreaming(bool enabled)
+{
+    levelStreaming = enabled;
+}
+
+/**
+ * Changes horizontal range of level seen by camera, chunks of streamed level are kept around it.
+ * Until it's called, range of screen size around player is used.
+ * @param left left edge of view
+ * @param right right edge of view
+ * @return void
+ */
+void Game::setView(double left, double right)
+{
+    hasView = true;
+    viewLeft = left;
+    viewRight = right;
+}
+
+/**
+ * Marks level as loaded and initializes Physics for objects in World.
+ * @return void
+ */
+void Game::startPhysics()
+{
 	levelLoaded = true;
-	physics = new Physics(levelWidth, levelHeight);
+    levelReplaced = true;
+    createPhysics();
+    physics->buildBroadphase(*world);
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Level loaded, arena uses %u of %u bytes", unsigned(world->arena.getUsed()), unsigned(world->arena.getCapacity()));
+}
+
+/**
+ * Creates Physics in arena of World and applies settings of Game to it. Broadphase isn't built.
+ * @return void
+ */
+void Game::createPhysics()
+{
+	physics = world->arena.create<Physics>(levelWidth, levelHeight);
+    lastTime = clock->getSeconds();
+    physics->setBroadphaseType(broadphaseType);
+    physics->setIntegratorType(levelIntegrator);
+    physics->setWorkerCount(physicsWorkerCount);
+    physics->setTimestep(physicsTimestep);
+    physics->setContinuousCollision(continuousCollision);
+    physics->setLevelOfDetail(lodDistance, lodPeriod);
+    lastControlTick = 0;
 }
 
 /**
@@ -220,15 +419,23 @@ void Game::unloadLevel()
 {
 	if (levelLoaded)
 	{
-		std::for_each(controllerList.begin(), controllerList.end(), [](Controller* c){delete(c); });
-		controllerList.clear();
-		std::for_each(objectList.begin(), objectList.end(), [](Object* o){delete(o); });
-		objectList.clear();
-		delete physics;
+		//Physics lives in arena of World, so it goes before arena is reset
+		physics->~Physics();
+		world->clear();
+		delete streamer;
+		streamer = nullptr;
+		behaviors.clear();
+		world->navigation.clear();
+		rewindBuffer.clear();
+		recorder.close();
+		if (replaying)
+			stopReplay();
 		levelLoaded = false;
+        levelReplaced = true;
         levelCoins = 0;
         levelHeight = 0;
         levelWidth = 0;
+        levelIntegrator = IntegratorType::RK4;
 	}
 }
 
@@ -243,11 +450,11 @@ GameState Game::getGameState() const
 
 /**
  * Get pointer to PlayerController.
- * @return PlayerController*
+ * @return PlayerController* a pointer to PlayerController or nullptr if it was destroyed
  */
 PlayerController* Game::getPlayerController() const
 {
-    return playerController;
+    return world->playerControllers.get(playerController);
 }
 
 /**
@@ -271,6 +478,26 @@ bool Game::getPosUpdated() const
 	return posUpdated;
 }
 
+/**
+ * Get objects that changed during last update.
+ * Every object should be treated as changed if DirtySet::getAllChanged returns true.
+ * @return DirtySet const&
+ * @see DirtySet
+ */
+DirtySet const& Game::getChanges() const
+{
+    return world->changes;
+}
+
+/**
+ * Get number that increases with every update in which game objects changed.
+ * @return Uint32
+ */
+Uint32 Game::getChangeVersion() const
+{
+    return changeVersion;
+}
+
 /**
  * Get width of loaded level.
  * @return int
@@ -291,9 +518,9 @@ int Game::getLevelHeight() const
 
 /**
  * Get number of coins spawned on loaded level.
- * @return int
+ * @return Uint32
  */
-Uint8 Game::getLevelCoins() const
+Uint32 Game::getLevelCoins() const
 {
     return levelCoins;
 }
@@ -308,25 +535,896 @@ double Game::getPosAlpha() const
 }
 
 /**
- * Get reference to constant list of loaded game objects.
- * @return std::list<Object*> const&
+ * Changes broadphase used by Physics. Applies to loaded level and every level loaded later.
+ * @param type new BroadphaseType
+ * @return void
+ * @see Physics
+ */
+void Game::setBroadphaseType(BroadphaseType type)
+{
+    broadphaseType = type;
+    if (levelLoaded)
+        physics->setBroadphaseType(type);
+}
+
+/**
+ * Get broadphase used by Physics.
+ * @return BroadphaseType
  */
-std::list<Object*> const& Game::getObjectList() const
+BroadphaseType Game::getBroadphaseType() const
 {
-	return objectList;
+    return broadphaseType;
 }
 
 /**
- * Sets posUpdated to true if state of game objects has changed.
+ * Get reference to constant World that holds loaded game objects.
+ * It's a view over pools of objects, so nothing is copied.
+ * @return World const&
+ */
+World const& Game::getWorld() const
+{
+    return *world;
+}
+
+/**
+ * Changes number of threads used by Physics. Applies to loaded level and every level loaded later.
+ * @param count number of threads including main thread. 0 or 1 means everything runs on main thread
+ * @return void
+ * @see Physics
+ */
+void Game::setPhysicsWorkerCount(unsigned count)
+{
+    physicsWorkerCount = count;
+    if (levelLoaded)
+        physics->setWorkerCount(count);
+}
+
+/**
+ * Changes timestep of Physics. Applies to loaded level and every level loaded later.
+ * @param seconds new timestep in seconds
+ * @return void
+ * @see Physics
+ */
+void Game::setPhysicsTimestep(double seconds)
+{
+    physicsTimestep = seconds;
+    if (levelLoaded)
+        physics->setTimestep(seconds);
+}
+
+/**
+ * Changes how Creatures far from players are simulated and controlled. Applies to loaded level and every level loaded later.
+ * Far Creatures are simulated in coarse steps and their Controllers control them only once every period steps.
+ * @param distance horizontal distance from players beyond which Creatures are far, 0 updates every Creature in every step
+ * @param period number of steps between updates of far Creatures
+ * @return void
+ * @see LodScheduler
+ */
+void Game::setLevelOfDetail(double distance, unsigned period)
+{
+    lodDistance = distance;
+    lodPeriod = period;
+    if (levelLoaded)
+        physics->setLevelOfDetail(distance, period);
+}
+
+/**
+ * Get timestep that Physics uses.
+ * @return double timestep in seconds
+ */
+double Game::getPhysicsTimestep() const
+{
+    return physicsTimestep;
+}
+
+/**
+ * Turns continuous collision of Physics on or off. Applies to loaded level and every level loaded later.
+ * @param enabled true to turn continuous collision on
  * @return void
+ * @see Physics
  */
-void Game::checkPositions()
+void Game::setContinuousCollision(bool enabled)
 {
-    for (std::list<Object*>::iterator it = objectList.begin(); it != objectList.end(); ++it)
+    continuousCollision = enabled;
+    if (levelLoaded)
+        physics->setContinuousCollision(enabled);
+}
+
+/**
+ * Appends to result every loaded game object that overlaps given rectangle.
+ * Static objects come from AABBTree built on level load, so only nearby ones are visited.
+ * @param left left edge of rectangle
+ * @param top top edge of rectangle
+ * @param right right edge of rectangle
+ * @param bottom bottom edge of rectangle
+ * @param result a list to which objects are appended
+ * @return void
+ * @see Physics
+ */
+void Game::getObjectsInRect(double left, double top, double right, double bottom, std::vector<SolidObject*>& result) const
+{
+    if (levelLoaded)
+        physics->queryObjects(left, top, right, bottom, result);
+}
+
+/**
+ * Copies everything needed to draw game into frame, replacing what it held.
+ * Objects are taken from a rectangle twice the size of view around player, so any camera that follows player is covered.
+ * Once player is gone, rectangle stays around last view.
+ * @param frame RenderFrame that state is written to
+ * @param viewWidth width of view
+ * @param viewHeight height of view
+ * @return void
+ * @see RenderFrame
+ */
+void Game::captureFrame(RenderFrame& frame, double viewWidth, double viewHeight)
+{
+    frame.state = gameState;
+    frame.posUpdated = posUpdated;
+    frame.changeVersion = changeVersion;
+    frame.posAlpha = posAlpha;
+    frame.levelWidth = levelWidth;
+    frame.levelHeight = levelHeight;
+    frame.levelCoins = levelCoins;
+    frame.broadphaseType = broadphaseType;
+    frame.hasPlayer = false;
+    frame.blinking = false;
+    frame.objects.clear();
+    if (!levelLoaded)
+        return;
+
+    auto copy = [&frame](SolidObject* o, RenderObject& r)
     {
-        if ((*it)->getPrevX() != (*it)->getX() || (*it)->getPrevY() != (*it)->getY())
+        r.x = float(o->getX());
+        r.y = float(o->getY());
+        r.prevX = float(o->getPrevX());
+        r.prevY = float(o->getPrevY());
+        r.width = float(o->getWidth());
+        r.height = float(o->getHeight());
+        r.kind = o->getKind();
+        r.flags = RenderFlags::None;
+        Creature* creature = objectCast<Creature>(o);
+        if (creature == nullptr)
+            return;
+        if (creature->getSpeedX() < 0.0)
+            r.flags = r.flags | RenderFlags::FacingLeft;
+        else if (creature->getSpeedX() > 0.0)
+            r.flags = r.flags | RenderFlags::FacingRight;
+        if (creature->getIsInvulnerable())
         {
-            posUpdated = true;
+            r.flags = r.flags | RenderFlags::Invulnerable;
+            frame.blinking = true;
         }
+    };
+
+    double centerX = hasView ? (viewLeft + viewRight) / 2 : 0.0;
+    double centerY = levelHeight / 2.0;
+    PlayerController* controller = getPlayerController();
+    PlayerCreature* player = controller != nullptr ? objectCast<PlayerCreature>(controller->getCreature()) : nullptr;
+    if (player != nullptr)
+    {
+        frame.hasPlayer = true;
+        copy(player, frame.player);
+        frame.playerHealth = player->getHealth();
+        frame.playerCoins = player->getCoins();
+        centerX = player->getX() + player->getWidth() / 2;
+        centerY = player->getY() + player->getHeight() / 2;
+    }
+
+    frameObjects.clear();
+    physics->queryObjects(centerX - viewWidth, centerY - viewHeight, centerX + viewWidth, centerY + viewHeight, frameObjects);
+    frame.objects.resize(frameObjects.size());
+    for (size_t i = 0; i < frameObjects.size(); ++i)
+        copy(frameObjects[i], frame.objects[i]);
+}
+
+/**
+ * Captures state of whole simulation into snapshot, replacing what it held.
+ * Game objects, Controllers, Physics, coin counts, GameState, state of streamed level and path and header of level file are saved,
+ * so simulation restored from snapshot continues exactly as it would from this point.
+ * Objects are written pool by pool in order of iteration, every Controller is followed by identifier of its Creature.
+ * @param snapshot Snapshot that state is written to
+ * @return void
+ * @see Snapshot
+ */
+void Game::saveSnapshot(Snapshot& snapshot) const
+{
+    snapshot.clear();
+    snapshot.write(gameState);
+    snapshot.write(levelLoaded);
+    if (!levelLoaded)
+        return;
+    snapshot.write(Uint32(levelSource.size()));
+    snapshot.write(levelSource.data(), levelSource.size());
+    snapshot.write(levelSourceHeader);
+    snapshot.write(levelWidth);
+    snapshot.write(levelHeight);
+    snapshot.write(levelCoins);
+    snapshot.write(levelIntegrator);
+    snapshot.write(posAlpha);
+    snapshot.write(lastControlTick);
+    snapshot.write(world->nextScheduleKey);
+    snapshot.write(streamer != nullptr);
+    if (streamer != nullptr)
+    {
+        snapshot.write(streamer->getHeader().monsterCount);
+        snapshot.write(streamer->getHeader().coinCount);
+    }
+
+    auto save = [&snapshot](Object const* o){ o->saveState(snapshot); };
+    snapshot.write(Uint32(world->solids.size()));
+    world->solids.forEach(save);
+    snapshot.write(Uint32(world->coins.size()));
+    world->coins.forEach(save);
+    snapshot.write(Uint32(world->triggers.size()));
+    world->triggers.forEach(save);
+    snapshot.write(Uint32(world->players.size()));
+    world->players.forEach(save);
+    snapshot.write(Uint32(world->monsters.size()));
+    world->monsters.forEach(save);
+
+    //Controllers of destroyed Creatures are kept until updateControllers releases them
+    auto saveController = [&snapshot](Controller* c)
+    {
+        Creature const* creature = c->getCreature();
+        snapshot.write(creature != nullptr ? creature->getId() : 0u);
+        c->saveState(snapshot);
+    };
+    snapshot.write(Uint32(world->playerControllers.size()));
+    world->playerControllers.forEach(saveController);
+    //behavior goes before state, so controller can be created with it
+    snapshot.write(Uint32(world->controllers.size()));
+    world->controllers.forEach([&snapshot, &saveController](BehaviorController* c)
+    {
+        snapshot.write(c->getBehavior().getIndex());
+        saveController(c);
+    });
+
+    physics->saveState(snapshot);
+    if (streamer != nullptr)
+        streamer->saveState(snapshot);
+}
+
+/**
+ * Restores state captured by saveSnapshot. Game objects are created again in their arena with their identifiers.
+ * Streamed level can only be restored while the same level is loaded.
+ * Snapshot of another level reads behaviors of monsters again from level file it was taken from, which mustn't have changed,
+ * and builds NavGraph again from restored solid objects.
+ * Frames recorded for rewinding are dropped, because simulation doesn't continue from them anymore.
+ * @param snapshot Snapshot that state is read from
+ * @return bool true if state was restored, false if snapshot is empty, was taken from another streamed level or its level file changed
+ * @see Snapshot
+ */
+bool Game::restoreSnapshot(Snapshot& snapshot)
+{
+    if (!loadSnapshot(snapshot))
+        return false;
+    rewindBuffer.clear();
+    return true;
+}
+
+/**
+ * Restores state captured by saveSnapshot, keeping frames recorded for rewinding.
+ * Memory of arena and pools is reused, so restoring allocates little once a level has been played for a while.
+ * @param snapshot Snapshot that state is read from
+ * @return bool true if state was restored, false if snapshot is empty, was taken from another streamed level or its level file changed
+ */
+bool Game::loadSnapshot(Snapshot& snapshot)
+{
+    if (snapshot.getSize() == 0)
+        return false;
+    snapshot.rewind();
+    GameState state = snapshot.read<GameState>();
+    if (!snapshot.read<bool>())
+    {
+        unloadLevel();
+        gameState = state;
+        return true;
+    }
+    std::string source(snapshot.read<Uint32>(), '\0');
+    if (!source.empty())
+        snapshot.read(&source[0], source.size());
+    LevelHeader sourceHeader = snapshot.read<LevelHeader>();
+    int width = snapshot.read<int>();
+    int height = snapshot.read<int>();
+    Uint32 coins = snapshot.read<Uint32>();
+    IntegratorType integrator = snapshot.read<IntegratorType>();
+    double alpha = snapshot.read<double>();
+    Uint32 controlTick = snapshot.read<Uint32>();
+    unsigned scheduleKey = snapshot.read<unsigned>();
+    bool streamed = snapshot.read<bool>();
+    bool sameLevel = levelLoaded && source == levelSource && std::memcmp(&sourceHeader, &levelSourceHeader, sizeof(LevelHeader)) == 0;
+    //records of streamed level aren't in snapshot, so they have to be the same
+    if (streamed != (streamer != nullptr))
+        return false;
+    if (streamed)
+    {
+        Uint32 monsterCount = snapshot.read<Uint32>();
+        Uint32 coinCount = snapshot.read<Uint32>();
+        if (!sameLevel || monsterCount != streamer->getHeader().monsterCount || coinCount != streamer->getHeader().coinCount ||
+            width != levelWidth || height != levelHeight)
+            return false;
+    }
+    //behaviors of monsters aren't in snapshot either, so they're read again from level that snapshot was taken from
+    LevelFile level;
+    if (!sameLevel && !source.empty() &&
+        (!level.open(source.c_str()) || std::memcmp(&level.getHeader(), &sourceHeader, sizeof(LevelHeader)) != 0))
+        return false;
+
+    if (levelLoaded)
+    {
+        physics->~Physics();
+        world->clear();
+    }
+    levelWidth = width;
+    levelHeight = height;
+    levelCoins = coins;
+    levelIntegrator = integrator;
+    posAlpha = alpha;
+    if (!sameLevel)
+    {
+        levelSource = source;
+        levelSourceHeader = sourceHeader;
+        if (source.empty())
+            behaviors.clear();
+        else
+            loadBehaviors(level);
+    }
+
+    restoredIds.clear();
+    auto restore = [this, &snapshot](SolidObject* o)
+    {
+        o->loadState(snapshot);
+        restoredIds.push_back(std::make_pair(o->getId(), world->getHandle(o)));
+    };
+    for (Uint32 count = snapshot.read<Uint32>(); count > 0; --count)
+        restore(world->solids.create());
+    for (Uint32 count = snapshot.read<Uint32>(); count > 0; --count)
+        restore(world->coins.create());
+    for (Uint32 count = snapshot.read<Uint32>(); count > 0; --count)
+        restore(world->triggers.create(this, nullptr, nullptr, nullptr));
+    for (Uint32 count = snapshot.read<Uint32>(); count > 0; --count)
+        restore(world->players.create());
+    for (Uint32 count = snapshot.read<Uint32>(); count > 0; --count)
+        restore(world->monsters.create());
+    std::sort(restoredIds.begin(), restoredIds.end(),
+        [](std::pair<unsigned, ObjectHandle> const& a, std::pair<unsigned, ObjectHandle> const& b){ return a.first < b.first; });
+    //graph of loaded level is kept, snapshot of another level builds it from restored solid objects
+    if (!sameLevel)
+        buildNavigation();
+
+    for (Uint32 count = snapshot.read<Uint32>(); count > 0; --count)
+    {
+        ObjectHandle creature = findRestored(ObjectKind::Player, snapshot.read<unsigned>());
+        PlayerController* c = world->playerControllers.create(world, creature);
+        c->loadState(snapshot);
+        playerController = world->playerControllers.getHandle(c);
+    }
+    for (Uint32 count = snapshot.read<Uint32>(); count > 0; --count)
+    {
+        BehaviorTable const& behavior = findBehavior(snapshot.read<Uint32>());
+        ObjectHandle creature = findRestored(ObjectKind::Monster, snapshot.read<unsigned>());
+        world->controllers.create(world, creature, behavior)->loadState(snapshot);
+    }
+
+    //restored Creatures took their keys from snapshot, so ones created later continue where saved run did
+    world->nextScheduleKey = scheduleKey;
+    createPhysics();
+    physics->loadState(snapshot, *world);
+    lastControlTick = controlTick;
+    if (streamer != nullptr)
+    {
+        //static objects go back to chunks they were created from
+        streamer->loadState(snapshot);
+        std::map<int, LevelStreamer::ResidentChunk>& resident = streamer->getResident();
+        auto attach = [this, &resident](SolidObject* o)
+        {
+            std::map<int, LevelStreamer::ResidentChunk>::iterator it = resident.find(streamer->getChunk(o->getX()));
+            if (it != resident.end())
+                it->second.objects.push_back(world->getHandle(o));
+        };
+        world->solids.forEach(attach);
+        world->coins.forEach(attach);
+        world->triggers.forEach(attach);
     }
+    levelLoaded = true;
+    levelReplaced = true;
+    gameState = state;
+    if (snapshot.getOverrun())
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Snapshot ended before restored state did");
+    return true;
+}
+
+/**
+ * Turns recording of frames for rewinding on or off. Recorded frames are dropped when it's turned off.
+ * @param enabled true to record a frame after every update of Physics
+ * @return void
+ * @see RewindBuffer
+ */
+void Game::setRewindEnabled(bool enabled)
+{
+    rewindEnabled = enabled;
+    if (!enabled)
+        rewindBuffer.clear();
+}
+
+/**
+ * Moves simulation back in time to a recorded frame. Frames after it are dropped once it was restored,
+ * so a frame that can't be restored leaves both simulation and recorded frames as they were.
+ * Goes back as far as possible if less was recorded.
+ * @param seconds how many seconds of simulation time to go back
+ * @return bool true if simulation was moved back
+ * @see RewindBuffer
+ */
+bool Game::rewind(double seconds)
+{
+    //going back isn't recorded, so it would break replay
+    if (getDeterministic())
+        return false;
+    double time = rewindBuffer.getNewestTime() - seconds;
+    if (!levelLoaded || !rewindBuffer.peek(time, rewindSnapshot) || !loadSnapshot(rewindSnapshot))
+        return false;
+    rewindBuffer.truncate(time);
+    return true;
+}
+
+/**
+ * Changes source of buttons handed to PlayerController.
+ * @param source a pointer to InputSource, nullptr means keyboard
+ * @return void
+ * @see InputSource
+ */
+void Game::setInputSource(InputSource* source)
+{
+    input = source != nullptr ? source : &defaultInput;
+}
+
+/**
+ * Records input of next level started by startGame into a file, until level is unloaded or recording is stopped.
+ * Buttons of every step are recorded, so replaying the file reproduces the run exactly.
+ * While recording, chunks of streamed level are read right away around player instead of view, and rewinding is off.
+ * @param path path of recording file
+ * @return void
+ * @see InputRecorder
+ */
+void Game::recordInput(std::string const& path)
+{
+    recordPath = path;
+}
+
+/**
+ * Stops recording input and closes recording file.
+ * @return void
+ */
+void Game::stopRecording()
+{
+    recordPath.clear();
+    recorder.close();
+}
+
+/**
+ * Starts recorded level with settings it was recorded with and replays recorded input into it.
+ * Every step takes recorded buttons, so every replay is identical however steps fall into frames.
+ * Input goes back to InputSource once every step was replayed.
+ * Level path and every setting of Game that changes simulation are changed to recorded ones.
+ * @param path path of recording file
+ * @return bool true if replay started, false if file isn't a valid recording
+ * @see InputReplay
+ */
+bool Game::replayInput(std::string const& path)
+{
+    if (!replay.open(path.c_str()))
+        return false;
+    InputSettings const& settings = replay.getSettings();
+    if (settings.broadphase > Uint8(BroadphaseType::Tree))
+    {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Input recording %s has unknown broadphase %u", path.c_str(), unsigned(settings.broadphase));
+        return false;
+    }
+    setPhysicsTimestep(settings.timestep);
+    setContinuousCollision(settings.continuousCollision);
+    setBroadphaseType(BroadphaseType(settings.broadphase));
+    setPhysicsWorkerCount(settings.workerCount);
+    setLevelOfDetail(settings.lodDistance, settings.lodPeriod);
+    levelStreaming = settings.streaming;
+    levelPath = settings.levelPath;
+    startGame();
+    replaying = true;
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Replaying input from %s", path.c_str());
+    return true;
+}
+
+/**
+ * Check if recorded input is being replayed.
+ * @return bool
+ */
+bool Game::getReplaying() const
+{
+    return replaying;
+}
+
+/**
+ * Hands buttons of current step to PlayerController. Buttons come from replay, which is advanced first, or from InputSource.
+ * @return InputButton buttons that were handed
+ */
+InputButton Game::readInput()
+{
+    if (replaying && !replay.next())
+        stopReplay();
+    InputButton buttons = replaying ? replay.getButtons() : input->getButtons();
+    world->playerControllers.forEach([buttons](PlayerController* c){ c->setButtons(buttons); });
+    return buttons;
+}
+
+/**
+ * Stops replaying and hands input back to InputSource.
+ * @return void
+ */
+void Game::stopReplay()
+{
+    replaying = false;
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Replay finished");
+}
+
+/**
+ * Check if every update has to be reproducible, because input is recorded or replayed.
+ * @return bool
+ */
+bool Game::getDeterministic() const
+{
+    return replaying || recorder.isOpen();
+}
+
+/**
+ * Records a frame for rewinding if it's enabled.
+ * Frame is taken only if Physics has advanced since last one, so frames are one step of Physics apart or more.
+ * @return void
+ */
+void Game::recordRewind()
+{
+    if (!rewindEnabled || (rewindBuffer.getFrameCount() > 0 && physics->getTime() <= rewindBuffer.getNewestTime()))
+        return;
+    saveSnapshot(rewindSnapshot);
+    rewindBuffer.record(rewindSnapshot, physics->getTime());
+}
+
+/**
+ * Get handle of an object restored by loadSnapshot.
+ * @param kind kind of object, used if object isn't found
+ * @param id identifier of object
+ * @return ObjectHandle handle that doesn't resolve if object isn't found
+ */
+ObjectHandle Game::findRestored(ObjectKind kind, unsigned id) const
+{
+    std::vector<std::pair<unsigned, ObjectHandle> >::const_iterator it = std::lower_bound(restoredIds.begin(), restoredIds.end(), id,
+        [](std::pair<unsigned, ObjectHandle> const& restored, unsigned id){ return restored.first < id; });
+    if (it != restoredIds.end() && it->first == id)
+        return it->second;
+    ObjectHandle missing;
+    missing.kind = kind;
+    missing.slot.index = ~0u;
+    missing.slot.generation = 0;
+    return missing;
+}
+
+/**
+ * Reads behaviors of monsters from level file, replacing ones of previous level.
+ * Tables are only built here, so pointers of Controllers to them stay valid until level is unloaded.
+ * @param level level file that is loaded
+ * @return void
+ * @see BehaviorTable
+ */
+void Game::loadBehaviors(LevelFile const& level)
+{
+    LevelHeader const& header = level.getHeader();
+    LevelBehavior const* records = level.getBehaviors();
+    LevelBehaviorState const* states = level.getBehaviorStates();
+    behaviors.clear();
+    behaviors.reserve(header.behaviorCount);
+    for (Uint32 i = 0; i < header.behaviorCount; ++i)
+        behaviors.push_back(BehaviorTable(i, states + records[i].firstState, records[i].stateCount));
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Level has %u monster behaviors with %u states", unsigned(header.behaviorCount), unsigned(header.stateCount));
+}
+
+/**
+ * Get behavior of monsters by index of its record in level file.
+ * @param index index of behavior record, noBehavior for built-in behavior
+ * @return BehaviorTable const& behavior, built-in one if level has no such behavior
+ */
+BehaviorTable const& Game::findBehavior(Uint32 index) const
+{
+    return index < behaviors.size() ? behaviors[index] : BehaviorTable::getWalker();
+}
+
+/**
+ * Builds NavGraph of World from every solid object of level.
+ * Streamed level has only some chunks in World, so its graph is built from records of level file instead.
+ * @return void
+ * @see NavGraph
+ */
+void Game::buildNavigation()
+{
+    std::vector<LevelBox> boxes;
+    if (streamer != nullptr)
+    {
+        LevelFile const& level = streamer->getLevel();
+        boxes.assign(level.getSolids(), level.getSolids() + level.getHeader().solidCount);
+    }
+    else
+    {
+        world->solids.forEach([&boxes](SolidObject const* o)
+        {
+            LevelBox box = { float(o->getX()), float(o->getY()), float(o->getWidth()), float(o->getHeight()) };
+            boxes.push_back(box);
+        });
+    }
+    world->navigation.build(std::move(boxes));
+}
+
+/**
+ * Forgets changes of last update. Every object is marked as changed if level was replaced since then.
+ * @return void
+ */
+void Game::beginChanges()
+{
+    world->changes.clear();
+    if (levelReplaced)
+    {
+        world->changes.markAll();
+        levelReplaced = false;
+    }
+}
+
+/**
+ * Sets posUpdated to true and increases changeVersion if game objects changed during update.
+ * Nothing is scanned, objects record their own changes.
+ * @return void
+ */
+void Game::endChanges()
+{
+    posUpdated = !world->changes.isEmpty();
+    if (posUpdated)
+        ++changeVersion;
+}
+
+/**
+ * Lets every Controller control its Creature and releases Controllers of dead Creatures.
+ * Runs once every step, before Physics, over contiguous pools of Controllers.
+ * Creatures far from players are controlled only if they are due to take a coarse step since last control.
+ * Monsters are controlled by BehaviorTables of level without virtual calls.
+ * @return void
+ * @see LodScheduler
+ */
+void Game::updateControllers()
+{
+    //Controllers run before step of Physics, so they follow the same schedule as bodies of that step
+    Uint32 tick = physics->getTickCount() + 1;
+    LodScheduler const& lod = physics->getLodScheduler();
+    //returns false if Creature is dead, otherwise sets due to true if it's controlled in this step
+    auto update = [this, &lod, tick](Controller* c, bool& due) -> bool
+    {
+        Creature* creature = c->getCreature();
+        if (creature == nullptr)
+            return false;
+        if (creature->getY() > levelHeight)
+        {
+            creature->hurt(127);
+        }
+        if (!creature->getIsAlive()) //hide corpses in the closet
+        {
+            creature->destroy();
+            return false;
+        }
+        due = !lod.isFar(creature) || lod.isDue(creature->getScheduleKey(), lastControlTick, tick);
+        return true;
+    };
+    bool due;
+    world->playerControllers.forEach([this, &update, &due](PlayerController* c)
+    {
+        if (!update(c, due))
+        {
+            gameState = GameState::Lost;
+            world->playerControllers.release(c);
+        }
+        else if (due)
+            c->control();
+    });
+    //BehaviorController is final, so its control is called directly, far monsters run their timers down by every step they missed
+    world->controllers.forEach([this, &update, &due, tick](BehaviorController* c)
+    {
+        if (!update(c, due))
+            world->controllers.release(c);
+        else if (due)
+            c->controlUntil(tick);
+    });
+    lastControlTick = tick;
+}
+
+/**
+ * Collects released Controllers and game objects that were destroyed.
+ * Destroyed objects are released in a single pass and collected at once, so every removal takes constant time.
+ * @return void
+ */
+void Game::removeDestroyedObjects()
+{
+    //release destroyed objects
+    world->forEachObject([this](SolidObject* o)
+    {
+        if (o->getDestroyed())
+        {
+            //killed monsters and collected coins don't come back with their chunk
+            if (streamer != nullptr)
+                streamer->removeObject(o->getId());
+            physics->removeObject(o);
+            world->release(o);
+        }
+    });
+    world->collect();
+}
+
+/**
+ * Loads chunks of streamed level that came close to view and unloads ones that are far from it.
+ * Monsters are spawned one chunk beyond view on both sides and stored back when they get two chunks beyond it.
+ * Chunks are loaded one chunk further than where monsters are kept and unloaded one more chunk beyond, so walking back and forth
+ * over a chunk border doesn't load the same chunk over and over. Static objects of a chunk can reach into following chunks,
+ * so chunks are loaded further on the left. Monsters are only kept where ground around them is loaded, see isAreaResident.
+ * @param wait true to read missing chunks right away, false to let LevelStreamer read them in background
+ * @return void
+ * @see LevelStreamer
+ */
+void Game::updateStreaming(bool wait)
+{
+    double left = viewLeft;
+    double right = viewRight;
+    //view depends on size of window, so it's ignored when run has to be reproducible
+    if (!hasView || getDeterministic())
+    {
+        Creature const* player = nullptr;
+        PlayerController* controller = getPlayerController();
+        if (controller != nullptr)
+            player = controller->getCreature();
+        double center = player != nullptr ? player->getX() + player->getWidth() / 2 : streamer->getPlayer().x;
+        double halfWidth = double(GameDefinitions::screenWidth) / GameDefinitions::scale / 2;
+        left = center - halfWidth;
+        right = center + halfWidth;
+    }
+    int last = streamer->getChunk(right + GameDefinitions::chunkWidth);
+    int monsterFirst = streamer->getChunk(left - GameDefinitions::chunkWidth);
+    //static objects are loaded one chunk around chunks where monsters are kept, so monsters at the edge have ground to walk onto
+    int first = std::max(0, streamer->getChunk(left - 3 * GameDefinitions::chunkWidth) - streamer->getReach());
+    int loadLast = streamer->getChunk(right + 3 * GameDefinitions::chunkWidth);
+    std::map<int, LevelStreamer::ResidentChunk>& resident = streamer->getResident();
+
+    //unload chunks far from view
+    for (std::map<int, LevelStreamer::ResidentChunk>::iterator it = resident.begin(); it != resident.end();)
+    {
+        if (it->first >= first - 1 && it->first <= loadLast + 1)
+        {
+            ++it;
+            continue;
+        }
+        for (size_t i = 0; i < it->second.objects.size(); ++i)
+        {
+            SolidObject* o = world->get(it->second.objects[i]);
+            if (o == nullptr)
+                continue;
+            streamer->storeObject(o->getId());
+            physics->removeObject(o);
+            world->release(o);
+        }
+        it = resident.erase(it);
+    }
+    //store monsters that left chunks around view or got close to missing ground, their Controllers are released by updateControllers
+    world->monsters.forEach([this, monsterFirst, last](MonsterCreature* m)
+    {
+        int chunk = streamer->getChunk(m->getX());
+        if (chunk < monsterFirst - 1 || chunk > last + 1 || !isAreaResident(m->getX(), m->getX() + m->getWidth()))
+        {
+            streamer->storeObject(m->getId());
+            physics->removeObject(m);
+            world->release(m);
+        }
+    });
+
+    //load chunks close to view
+    bool staticChanged = false;
+    for (int index = first; index <= loadLast; ++index)
+    {
+        if (resident.count(index) != 0 || streamer->isPending(index))
+            continue;
+        if (wait)
+        {
+            LevelChunk chunk;
+            streamer->read(index, chunk);
+            loadChunk(chunk);
+            staticChanged = true;
+        }
+        else
+            streamer->request(index);
+    }
+    LevelChunk chunk;
+    while (streamer->poll(chunk))
+    {
+        //chunk could have left view while it was read
+        if (chunk.index < first - 1 || chunk.index > loadLast + 1 || resident.count(chunk.index) != 0)
+            continue;
+        loadChunk(chunk);
+        staticChanged = true;
+    }
+    for (std::map<int, LevelStreamer::ResidentChunk>::iterator it = resident.lower_bound(monsterFirst); it != resident.end() && it->first <= last; ++it)
+        spawnMonsters(it->second.records);
+
+    if (staticChanged)
+        physics->rebuildStatic(*world);
+    world->collect();
+}
+
+/**
+ * Creates static objects and coins of a chunk of streamed level.
+ * Coins that were collected before chunk was unloaded aren't created again.
+ * Broadphase has to be rebuilt afterwards.
+ * @param chunk records of chunk
+ * @return void
+ */
+void Game::loadChunk(LevelChunk const& chunk)
+{
+    LevelStreamer::ResidentChunk& loaded = streamer->getResident()[chunk.index];
+    loaded.records = chunk;
+    loaded.objects.reserve(chunk.solids.size() + chunk.coins.size() + chunk.triggers.size());
+    for (size_t i = 0; i < chunk.solids.size(); ++i)
+        loaded.objects.push_back(world->getHandle(world->solids.create(chunk.solids[i].x, chunk.solids[i].y, chunk.solids[i].width, chunk.solids[i].height)));
+    for (size_t i = 0; i < chunk.coins.size(); ++i)
+    {
+        Uint32 record = chunk.firstCoin + Uint32(i);
+        if (streamer->getCoinState(record) != RecordState::Stored)
+            continue;
+        Coin* coin = world->coins.create(chunk.coins[i].x, chunk.coins[i].y);
+        streamer->spawnCoin(record, coin->getId());
+        loaded.objects.push_back(world->getHandle(coin));
+    }
+    for (size_t i = 0; i < chunk.triggers.size(); ++i)
+    {
+        LevelBox const& box = chunk.triggers[i].box;
+        if (chunk.triggers[i].action == Uint32(TriggerAction::Win))
+            loaded.objects.push_back(world->getHandle(world->triggers.create(this, &Game::wonGame, nullptr, nullptr, box.x, box.y, box.width, box.height)));
+    }
+}
+
+/**
+ * Creates monsters of a resident chunk that are only in level file.
+ * Monsters whose ground isn't loaded yet wait in level file, see isAreaResident.
+ * @param chunk records of chunk
+ * @return void
+ */
+void Game::spawnMonsters(LevelChunk const& chunk)
+{
+    for (size_t i = 0; i < chunk.monsters.size(); ++i)
+    {
+        Uint32 record = chunk.firstMonster + Uint32(i);
+        LevelBox const& box = chunk.monsters[i].box;
+        if (streamer->getMonsterState(record) != RecordState::Stored || !isAreaResident(box.x, box.x + box.width))
+            continue;
+        MonsterCreature* monster = world->monsters.create(box.x, box.y, box.width, box.height);
+        world->controllers.create(world, world->getHandle(monster), findBehavior(chunk.monsters[i].behavior));
+        physics->addObject(monster);
+        streamer->spawnMonster(record, monster->getId());
+    }
+}
+
+/**
+ * Check if static objects around a part of streamed level are in World.
+ * Chunks under the part, one chunk on both sides of it and chunks whose static objects reach into them have to be resident,
+ * so a Creature there can't walk or fall into a chunk whose ground is missing.
+ * @param left left edge of the part
+ * @param right right edge of the part
+ * @return bool
+ */
+bool Game::isAreaResident(double left, double right)
+{
+    std::map<int, LevelStreamer::ResidentChunk>& resident = streamer->getResident();
+    int last = streamer->getChunk(right + GameDefinitions::chunkWidth);
+    for (int index = std::max(0, streamer->getChunk(left - GameDefinitions::chunkWidth) - streamer->getReach()); index <= last; ++index)
+        if (resident.count(index) == 0)
+            return false;
+    return true;
 }
@@ -2,12 +2,25 @@
 #define GAME_H
 
 #include "Object.h"
+#include "Clock.h"
+#include "DirtySet.h"
+#include "InputSource.h"
 #include "Physics.h"
+#include "BehaviorTable.h"
 #include "Controller.h"
 #include "PlayerController.h"
-#include <algorithm>
-#include <list>
+#include "ObjectHandle.h"
+#include "RewindBuffer.h"
+#include "Snapshot.h"
 #include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+class World;
+class LevelStreamer;
+struct LevelChunk;
+struct RenderFrame;
 
 /**
  * The types of states that can represent Game.
@@ -56,9 +69,11 @@ public:
     /**
      * The default constructor.
      * Sets gameState to menu.
+     * @param clock a pointer to Clock that drives simulation in gameLoop. Defaults to nullptr, which means real time
      * @see GameState
+     * @see Clock
      */
-    Game();
+    Game(Clock* clock = nullptr);
 
     /**
      * The default destructor.
@@ -67,14 +82,26 @@ public:
 	~Game();
 
     /**
-     * Updates current state of game.
+     * Updates current state of game by time that has passed on clock since last update.
+     * Clock decides how many fixed steps are due, every one of them runs the whole pipeline of tick.
      * @return void
      */
     void gameLoop();
+
+    /**
+     * Updates current state of game by exact number of fixed steps, regardless of clock.
+     * Every step runs the whole pipeline of tick, so it doesn't need SDL to be initialized.
+     * Missing chunks are read right away, so stepping the same level with the same input always gives the same World.
+     * @param ticks number of steps
+     * @return void
+     */
+    void step(unsigned ticks);
 	
     /**
      * Changes gameState to GameState::Playing and loads level.
+     * Level is loaded from level path, built-in level is loaded if that fails.
      * @return void
+     * @see setLevelPath
      */
     void startGame();
 
@@ -109,11 +136,46 @@ public:
     void wonGame();
 
     /**
-     * Unloads level if loaded, loads level and initializes Physics.
+     * Unloads level if loaded, loads built-in level and initializes Physics.
      * @return void
      * @see Physics
      */
 	void loadLevel();
+
+    /**
+     * Unloads level if loaded, loads level from binary level file and initializes Physics.
+     * If level streaming is on, only chunks of level around view are kept in World.
+     * Physics moves objects with integrator named by level.
+     * Loaded level is kept if file can't be read.
+     * @param path path to binary level file
+     * @return bool true if level was loaded
+     * @see LevelFile
+     */
+    bool loadLevel(std::string const& path);
+
+    /**
+     * Changes path of level file loaded by startGame.
+     * @param path path to binary level file, empty to always load built-in level
+     * @return void
+     */
+    void setLevelPath(std::string const& path);
+
+    /**
+     * Turns level streaming on or off. Applies to levels loaded later.
+     * @param enabled true to keep only chunks of level around view in World
+     * @return void
+     * @see LevelStreamer
+     */
+    void setLevelStreaming(bool enabled);
+
+    /**
+     * Changes horizontal range of level seen by camera, chunks of streamed level are kept around it.
+     * Until it's called, range of screen size around player is used.
+     * @param left left edge of view
+     * @param right right edge of view
+     * @return void
+     */
+    void setView(double left, double right);
 	
     /**
      * Unloads level if loaded.
@@ -129,7 +191,7 @@ public:
 
     /**
      * Get pointer to PlayerController.
-     * @return PlayerController*
+     * @return PlayerController* a pointer to PlayerController or nullptr if it was destroyed
      */
 	PlayerController* getPlayerController() const;
 
@@ -145,6 +207,20 @@ public:
      */
     bool getPosUpdated() const;
 
+    /**
+     * Get objects that changed during last update.
+     * Every object should be treated as changed if DirtySet::getAllChanged returns true.
+     * @return DirtySet const&
+     * @see DirtySet
+     */
+    DirtySet const& getChanges() const;
+
+    /**
+     * Get number that increases with every update in which game objects changed.
+     * @return Uint32
+     */
+    Uint32 getChangeVersion() const;
+
     /**
      * Get width of loaded level.
      * @return int
@@ -159,9 +235,9 @@ public:
     
     /**
      * Get number of coins spawned on loaded level.
-     * @return int
+     * @return Uint32
      */
-    Uint8 getLevelCoins() const;
+    Uint32 getLevelCoins() const;
 	
     /**
      * Get coefficient of game state between steps, where 0 is previous step and 1 is current step.
@@ -170,15 +246,174 @@ public:
     double getPosAlpha() const;
 
     /**
-     * Get reference to constant list of loaded game objects.
-     * @return std::list<Object*> const&
+     * Changes broadphase used by Physics. Applies to loaded level and every level loaded later.
+     * @param type new BroadphaseType
+     * @return void
+     * @see Physics
+     */
+    void setBroadphaseType(BroadphaseType type);
+
+    /**
+     * Get broadphase used by Physics.
+     * @return BroadphaseType
+     */
+    BroadphaseType getBroadphaseType() const;
+
+    /**
+     * Changes number of threads used by Physics. Applies to loaded level and every level loaded later.
+     * @param count number of threads including main thread. 0 or 1 means everything runs on main thread
+     * @return void
+     * @see Physics
+     */
+    void setPhysicsWorkerCount(unsigned count);
+
+    /**
+     * Changes timestep of Physics. Applies to loaded level and every level loaded later.
+     * @param seconds new timestep in seconds
+     * @return void
+     * @see Physics
+     */
+    void setPhysicsTimestep(double seconds);
+
+    /**
+     * Get timestep that Physics uses.
+     * @return double timestep in seconds
+     */
+    double getPhysicsTimestep() const;
+
+    /**
+     * Turns continuous collision of Physics on or off. Applies to loaded level and every level loaded later.
+     * @param enabled true to turn continuous collision on
+     * @return void
+     * @see Physics
+     */
+    void setContinuousCollision(bool enabled);
+
+    /**
+     * Changes how Creatures far from players are simulated and controlled. Applies to loaded level and every level loaded later.
+     * Far Creatures are simulated in coarse steps and their Controllers control them only once every period steps.
+     * @param distance horizontal distance from players beyond which Creatures are far, 0 updates every Creature in every step
+     * @param period number of steps between updates of far Creatures
+     * @return void
+     * @see LodScheduler
+     */
+    void setLevelOfDetail(double distance, unsigned period);
+
+    /**
+     * Get reference to constant World that holds loaded game objects.
+     * It's a view over pools of objects, so nothing is copied.
+     * @return World const&
+     */
+    World const& getWorld() const;
+
+    /**
+     * Appends to result every loaded game object that overlaps given rectangle.
+     * Static objects come from AABBTree built on level load, so only nearby ones are visited.
+     * @param left left edge of rectangle
+     * @param top top edge of rectangle
+     * @param right right edge of rectangle
+     * @param bottom bottom edge of rectangle
+     * @param result a list to which objects are appended
+     * @return void
+     * @see Physics
+     */
+    void getObjectsInRect(double left, double top, double right, double bottom, std::vector<SolidObject*>& result) const;
+
+    /**
+     * Copies everything needed to draw game into frame, replacing what it held.
+     * Objects are taken from a rectangle twice the size of view around player, so any camera that follows player is covered.
+     * @param frame RenderFrame that state is written to
+     * @param viewWidth width of view
+     * @param viewHeight height of view
+     * @return void
+     * @see RenderFrame
+     */
+    void captureFrame(RenderFrame& frame, double viewWidth, double viewHeight);
+
+    /**
+     * Captures state of whole simulation into snapshot, replacing what it held.
+     * Game objects, Controllers, Physics, coin counts, GameState, state of streamed level and path and header of level file are saved,
+     * so simulation restored from snapshot continues exactly as it would from this point.
+     * Cost grows with number of objects in World, not with size of streamed level.
+     * @param snapshot Snapshot that state is written to
+     * @return void
+     * @see Snapshot
+     */
+    void saveSnapshot(Snapshot& snapshot) const;
+
+    /**
+     * Restores state captured by saveSnapshot. Game objects are created again in their arena with their identifiers.
+     * Streamed level can only be restored while the same level is loaded.
+     * Snapshot of another level reads behaviors of monsters again from level file it was taken from, which mustn't have changed,
+     * and builds NavGraph again from restored solid objects.
+     * Frames recorded for rewinding are dropped, because simulation doesn't continue from them anymore.
+     * @param snapshot Snapshot that state is read from
+     * @return bool true if state was restored, false if snapshot is empty, was taken from another streamed level or its level file changed
+     * @see Snapshot
+     */
+    bool restoreSnapshot(Snapshot& snapshot);
+
+    /**
+     * Turns recording of frames for rewinding on or off. Recorded frames are dropped when it's turned off.
+     * @param enabled true to record a frame after every update of Physics
+     * @return void
+     * @see RewindBuffer
+     */
+    void setRewindEnabled(bool enabled);
+
+    /**
+     * Moves simulation back in time to a recorded frame. Frames after it are dropped.
+     * Goes back as far as possible if less was recorded.
+     * @param seconds how many seconds of simulation time to go back
+     * @return bool true if simulation was moved back
+     * @see RewindBuffer
+     */
+    bool rewind(double seconds);
+
+    /**
+     * Changes source of buttons handed to PlayerController.
+     * @param source a pointer to InputSource, nullptr means keyboard
+     * @return void
+     * @see InputSource
+     */
+    void setInputSource(InputSource* source);
+
+    /**
+     * Records input of next level started by startGame into a file, until level is unloaded or recording is stopped.
+     * Buttons of every step are recorded, so replaying the file reproduces the run exactly.
+     * While recording, chunks of streamed level are read right away around player instead of view, and rewinding is off.
+     * @param path path of recording file
+     * @return void
+     * @see InputRecorder
      */
-	std::list<Object*> const& getObjectList() const;
+    void recordInput(std::string const& path);
+
+    /**
+     * Stops recording input and closes recording file.
+     * @return void
+     */
+    void stopRecording();
+
+    /**
+     * Starts recorded level with settings it was recorded with and replays recorded input into it.
+     * Every step takes recorded buttons, so every replay is identical however steps fall into frames.
+     * Input goes back to InputSource once every step was replayed.
+     * @param path path of recording file
+     * @return bool true if replay started, false if file isn't a valid recording
+     * @see InputReplay
+     */
+    bool replayInput(std::string const& path);
+
+    /**
+     * Check if recorded input is being replayed.
+     * @return bool
+     */
+    bool getReplaying() const;
 private:
     /**
-     * List of loaded game objects.
+     * Pointer to World that holds loaded game objects and their Controllers.
      */
-	std::list<Object*> objectList;
+    World* world;
 
     /**
      * Current state of game.
@@ -190,6 +425,16 @@ private:
      */
 	bool posUpdated;
 
+    /**
+     * Number of updates in which game objects changed.
+     */
+    Uint32 changeVersion;
+
+    /**
+     * True if level was loaded, restored or unloaded since changes were last cleared.
+     */
+    bool levelReplaced;
+
     /**
      * Width of loaded level.
      */
@@ -203,7 +448,58 @@ private:
     /**
      * Number of coins on loaded level.
      */
-    Uint8 levelCoins;
+    Uint32 levelCoins;
+
+    /**
+     * Path of level file loaded by startGame.
+     */
+    std::string levelPath;
+
+    /**
+     * True if levels loaded from files should be streamed.
+     */
+    bool levelStreaming;
+
+    /**
+     * Pointer to LevelStreamer of loaded level, nullptr if level isn't streamed.
+     */
+    LevelStreamer* streamer;
+
+    /**
+     * True if view was set since level was loaded.
+     */
+    bool hasView;
+
+    /**
+     * Left edge of view.
+     */
+    double viewLeft;
+
+    /**
+     * Right edge of view.
+     */
+    double viewRight;
+
+    /**
+     * Integrator used by Physics on loaded level.
+     */
+    IntegratorType levelIntegrator;
+
+    /**
+     * Path of level file that loaded level was read from, empty for built-in level.
+     * Snapshots record it together with levelSourceHeader, so they're restored with behaviors of their own level.
+     */
+    std::string levelSource;
+
+    /**
+     * Header of level file that loaded level was read from, zeroed for built-in level.
+     */
+    LevelHeader levelSourceHeader;
+
+    /**
+     * Behaviors of monsters of loaded level. They're read before any monster is created and kept until level is unloaded.
+     */
+    std::vector<BehaviorTable> behaviors;
     
     /**
      * Answer to whether level is loaded.
@@ -216,25 +512,257 @@ private:
 	double posAlpha;
 
     /**
-     * Pointer to PlayerController object.
+     * Handle of PlayerController object in World.
      */
-	PlayerController* playerController;
+    PoolHandle playerController;
+	
+    /**
+     * Pointer to Physics object, allocated in arena of World.
+     */
+    Physics* physics;
 
     /**
-     * List of Controller objects.
+     * Broadphase that Physics should use.
      */
-    std::list<Controller*> controllerList;
-	
+    BroadphaseType broadphaseType;
+
     /**
-     * Pointer to Physics object.
+     * Number of threads that Physics should use.
      */
-    Physics* physics;
+    unsigned physicsWorkerCount;
+
+    /**
+     * Timestep that Physics should use.
+     */
+    double physicsTimestep;
+
+    /**
+     * True if Physics should use continuous collision.
+     */
+    bool continuousCollision;
+
+    /**
+     * Distance from players beyond which Creatures are far.
+     */
+    double lodDistance;
+
+    /**
+     * Number of steps between updates of far Creatures.
+     */
+    unsigned lodPeriod;
+
+    /**
+     * Number of step of Physics when Controllers were last updated.
+     */
+    Uint32 lastControlTick;
+
+    /**
+     * Clock used when it wasn't injected.
+     */
+    Clock defaultClock;
+
+    /**
+     * A pointer to Clock that drives simulation.
+     */
+    Clock* clock;
+
+    /**
+     * Time on clock of last update of Physics.
+     */
+    double lastTime;
+
+    /**
+     * InputSource used when it wasn't set.
+     */
+    InputSource defaultInput;
+
+    /**
+     * A pointer to InputSource that buttons are read from.
+     */
+    InputSource* input;
+
+    /**
+     * Path of file that next started level is recorded to, empty if recording isn't requested.
+     */
+    std::string recordPath;
+
+    /**
+     * Writes input of loaded level to recording file.
+     */
+    InputRecorder recorder;
+
+    /**
+     * Recording that is replayed.
+     */
+    InputReplay replay;
+
+    /**
+     * True if recorded input is being replayed.
+     */
+    bool replaying;
+
+    /**
+     * Identifiers of restored objects paired with their handles, sorted by identifier. Reused by every loadSnapshot.
+     */
+    std::vector<std::pair<unsigned, ObjectHandle> > restoredIds;
+
+    /**
+     * Objects copied by captureFrame. Reused by every capture.
+     */
+    std::vector<SolidObject*> frameObjects;
+
+    /**
+     * True if frames are recorded for rewinding.
+     */
+    bool rewindEnabled;
+
+    /**
+     * Recorded frames of loaded level.
+     */
+    RewindBuffer rewindBuffer;
+
+    /**
+     * Snapshot reused for recording and rewinding.
+     */
+    Snapshot rewindSnapshot;
+
+    /**
+     * Marks level as loaded and initializes Physics for objects in World.
+     * @return void
+     */
+    void startPhysics();
+
+    /**
+     * Creates Physics in arena of World and applies settings of Game to it. Broadphase isn't built.
+     * @return void
+     */
+    void createPhysics();
+
+    /**
+     * Get handle of an object restored by loadSnapshot.
+     * @param kind kind of object, used if object isn't found
+     * @param id identifier of object
+     * @return ObjectHandle handle that doesn't resolve if object isn't found
+     */
+    ObjectHandle findRestored(ObjectKind kind, unsigned id) const;
+
+    /**
+     * Reads behaviors of monsters from level file, replacing ones of previous level.
+     * @param level level file that is loaded
+     * @return void
+     * @see BehaviorTable
+     */
+    void loadBehaviors(LevelFile const& level);
+
+    /**
+     * Get behavior of monsters by index of its record in level file.
+     * @param index index of behavior record, noBehavior for built-in behavior
+     * @return BehaviorTable const& behavior, built-in one if level has no such behavior
+     */
+    BehaviorTable const& findBehavior(Uint32 index) const;
+
+    /**
+     * Builds NavGraph of World from every solid object of level.
+     * @return void
+     * @see NavGraph
+     */
+    void buildNavigation();
+
+    /**
+     * Restores state captured by saveSnapshot, keeping frames recorded for rewinding.
+     * @param snapshot Snapshot that state is read from
+     * @return bool true if state was restored, false if snapshot is empty, was taken from another streamed level or its level file changed
+     */
+    bool loadSnapshot(Snapshot& snapshot);
+
+    /**
+     * Records a frame for rewinding if it's enabled.
+     * @return void
+     */
+    void recordRewind();
+
+    /**
+     * Runs a single fixed step: samples input, updates Controllers, removes destroyed objects, streams chunks and steps Physics.
+     * Everything that changes World happens in steps, so a run depends only on input of every step and not on how steps were grouped into frames.
+     * @param wait true to read missing chunks right away, false to let LevelStreamer read them in background
+     * @return void
+     */
+    void tick(bool wait);
+
+    /**
+     * Hands buttons of current step to PlayerController. Buttons come from replay, which is advanced first, or from InputSource.
+     * @return InputButton buttons that were handed
+     */
+    InputButton readInput();
+
+    /**
+     * Stops replaying and hands input back to InputSource.
+     * @return void
+     */
+    void stopReplay();
+
+    /**
+     * Check if every update has to be reproducible, because input is recorded or replayed.
+     * @return bool
+     */
+    bool getDeterministic() const;
+
+    /**
+     * Loads chunks of streamed level that came close to view and unloads ones that are far from it.
+     * @param wait true to read missing chunks right away, false to let LevelStreamer read them in background
+     * @return void
+     */
+    void updateStreaming(bool wait);
+
+    /**
+     * Creates static objects and coins of a chunk of streamed level.
+     * @param chunk records of chunk
+     * @return void
+     */
+    void loadChunk(LevelChunk const& chunk);
+
+    /**
+     * Creates monsters of a resident chunk that are only in level file.
+     * @param chunk records of chunk
+     * @return void
+     */
+    void spawnMonsters(LevelChunk const& chunk);
+
+    /**
+     * Check if static objects around a part of streamed level are in World.
+     * @param left left edge of the part
+     * @param right right edge of the part
+     * @return bool
+     */
+    bool isAreaResident(double left, double right);
+
+    /**
+     * Forgets changes of last update. Every object is marked as changed if level was replaced since then.
+     * @return void
+     */
+    void beginChanges();
+
+    /**
+     * Sets posUpdated to true and increases changeVersion if game objects changed during update.
+     * @return void
+     */
+    void endChanges();
+
+    /**
+     * Lets every Controller control its Creature and releases Controllers of dead Creatures.
+     * Runs once every step, before Physics, over contiguous pools of Controllers.
+     * Creatures far from players are controlled only if they are due to take a coarse step since last control.
+     * Monsters are controlled by BehaviorTables of level without virtual calls.
+     * @return void
+     * @see LodScheduler
+     */
+    void updateControllers();
 
     /**
-     * Sets posUpdated to true if state of game objects has changed.
+     * Collects released Controllers and game objects that were destroyed.
      * @return void
      */
-	void checkPositions();
+    void removeDestroyedObjects();
 };
 
 #endif // GAME_H
@@ -21,6 +21,40 @@ namespace GameDefinitions //TODO: Load informations from file
     char const *const gameLost = "YOU DIED";
     char const *const gameWon = "YOU WIN";
 
+	//Level loaded on start, built-in level is loaded if it's missing
+	char const *const levelPath = "Data/levels/level1.lvl";
+
+	//Width of chunks in which level files are streamed
+	const double chunkWidth = 32.0;
+
+	//Rewinding keeps this many seconds of simulation in a ring of this many bytes
+	const double rewindSeconds = 10.0;
+	const size_t rewindBufferSize = 4 * 1024 * 1024;
+	//Frames between whole snapshots kept for rewinding, frames between them hold only changes
+	const unsigned rewindKeyframeInterval = 30;
+	//Creatures this far beyond players are simulated and controlled once every this many steps
+	const double lodDistance = 32.0;
+	const unsigned lodPeriod = 4;
+	//Navigation graph of monsters: jumps reach this high and this far and start this far before their target,
+	//falls land this far from edges, segments need this much headroom and width, tops closer than merge gap are joined
+	const double navJumpHeight = 2.5;
+	const double navJumpDistance = 3.0;
+	const double navTakeoffRun = 1.0;
+	const double navFallReach = 1.0;
+	const double navClearance = 1.0;
+	const double navMinWidth = 0.5;
+	const double navMergeGap = 0.5;
+	//Take-off points of jumps keep this far from ends of segments, where a wall may stop a monster short of them
+	const double navEdgeMargin = 0.5;
+	//Feet this close above a segment stand on it, chasing monsters this close to a point have reached it
+	const double navStandTolerance = 0.1;
+	const double navReachTolerance = 0.25;
+	//Width of cells that segments are looked up in, graphs up to this many segments have their whole path table built on load,
+	//rows of bigger ones and of paths without jumps are built on first use and at most this many of them are kept
+	const double navCellWidth = 8.0;
+	const unsigned navTableSegments = 1024;
+	const unsigned navCachedRows = 64;
+
 	//Screen dimension constants
 	const int screenWidth = 640;
 	const int screenHeight = 480;
@@ -0,0 +1,261 @@
+#include "InputSource.h"
+#include <SDL_keyboard.h>
+#include <SDL_log.h>
+#include <cstring>
+
+/**
+ * InputSource implementation
+ */
+
+/**
+ * The default constructor.
+ */
+InputSource::InputSource()
+{
+}
+
+/**
+ * The default destructor.
+ */
+InputSource::~InputSource()
+{
+}
+
+/**
+ * Get buttons that are held now, read from keyboard state of SDL.
+ * @return InputButton
+ */
+InputButton InputSource::getButtons()
+{
+    const Uint8 *state = SDL_GetKeyboardState(nullptr);
+    InputButton buttons = InputButton::None;
+    if (state[SDL_SCANCODE_LEFT])
+        buttons |= InputButton::Left;
+    if (state[SDL_SCANCODE_RIGHT])
+        buttons |= InputButton::Right;
+    if (state[SDL_SCANCODE_SPACE])
+        buttons |= InputButton::Jump;
+    return buttons;
+}
+
+/**
+ * InputRecorder implementation
+ */
+
+/**
+ * The default constructor.
+ */
+InputRecorder::InputRecorder() :
+    runButtons(InputButton::None),
+    runCount(0),
+    stepCount(0)
+{
+}
+
+/**
+ * The default destructor. Closes file.
+ */
+InputRecorder::~InputRecorder()
+{
+    close();
+}
+
+/**
+ * Creates recording file and writes its header. Recording that was open is closed.
+ * @param path path of recording file
+ * @param settings settings of Game that run depends on
+ * @return bool true if file was created
+ */
+bool InputRecorder::open(char const* path, InputSettings const& settings)
+{
+    close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Can't create input recording %s", path);
+        return false;
+    }
+    Uint8 streamed = settings.streaming ? 1 : 0;
+    Uint8 swept = settings.continuousCollision ? 1 : 0;
+    Uint32 pathLength = Uint32(settings.levelPath.size());
+    file.write("GINP", 4);
+    file.write(reinterpret_cast<char const*>(&inputRecordingVersion), sizeof(inputRecordingVersion));
+    file.write(reinterpret_cast<char const*>(&settings.timestep), sizeof(settings.timestep));
+    file.write(reinterpret_cast<char const*>(&streamed), sizeof(streamed));
+    file.write(reinterpret_cast<char const*>(&swept), sizeof(swept));
+    file.write(reinterpret_cast<char const*>(&settings.broadphase), sizeof(settings.broadphase));
+    file.write(reinterpret_cast<char const*>(&settings.workerCount), sizeof(settings.workerCount));
+    file.write(reinterpret_cast<char const*>(&settings.lodDistance), sizeof(settings.lodDistance));
+    file.write(reinterpret_cast<char const*>(&settings.lodPeriod), sizeof(settings.lodPeriod));
+    file.write(reinterpret_cast<char const*>(&pathLength), sizeof(pathLength));
+    file.write(settings.levelPath.data(), pathLength);
+    runCount = 0;
+    stepCount = 0;
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Recording input to %s", path);
+    return true;
+}
+
+/**
+ * Writes last run and closes file.
+ * @return void
+ */
+void InputRecorder::close()
+{
+    if (!file.is_open())
+        return;
+    writeRun();
+    file.close();
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Input recording closed after %u steps", unsigned(stepCount));
+}
+
+/**
+ * Check if recording file is open.
+ * @return bool
+ */
+bool InputRecorder::isOpen() const
+{
+    return file.is_open();
+}
+
+/**
+ * Records a single step. Step extends current run if its buttons are equal, otherwise current run is written and a new one starts.
+ * @param buttons buttons that were held
+ * @return void
+ */
+void InputRecorder::record(InputButton buttons)
+{
+    if (!file.is_open())
+        return;
+    if (runCount == 0xFFFF || (runCount > 0 && buttons != runButtons))
+        writeRun();
+    runButtons = buttons;
+    ++runCount;
+    ++stepCount;
+}
+
+/**
+ * Writes current run to file.
+ * @return void
+ */
+void InputRecorder::writeRun()
+{
+    if (runCount == 0)
+        return;
+    file.write(reinterpret_cast<char const*>(&runButtons), sizeof(runButtons));
+    file.write(reinterpret_cast<char const*>(&runCount), sizeof(runCount));
+    runCount = 0;
+}
+
+/**
+ * InputReplay implementation
+ */
+
+/**
+ * The default constructor.
+ */
+InputReplay::InputReplay() :
+    run(0),
+    replayed(0)
+{
+    settings.timestep = 0.0;
+    settings.streaming = false;
+    settings.continuousCollision = false;
+    settings.broadphase = 0;
+    settings.workerCount = 0;
+    settings.lodDistance = 0.0;
+    settings.lodPeriod = 0;
+}
+
+/**
+ * The default destructor.
+ */
+InputReplay::~InputReplay()
+{
+}
+
+/**
+ * Reads recording file. Replay starts before first step.
+ * File is rejected if its header is cut short or holds a level path longer than inputMaxPathLength.
+ * @param path path of recording file
+ * @return bool true if file is a valid recording
+ */
+bool InputReplay::open(char const* path)
+{
+    runs.clear();
+    run = 0;
+    replayed = 0;
+    std::ifstream file(path, std::ios::binary);
+    char magic[4];
+    Uint32 version = 0;
+    Uint8 streamed = 0;
+    Uint8 swept = 0;
+    Uint32 pathLength = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&settings.timestep), sizeof(settings.timestep));
+    file.read(reinterpret_cast<char*>(&streamed), sizeof(streamed));
+    file.read(reinterpret_cast<char*>(&swept), sizeof(swept));
+    file.read(reinterpret_cast<char*>(&settings.broadphase), sizeof(settings.broadphase));
+    file.read(reinterpret_cast<char*>(&settings.workerCount), sizeof(settings.workerCount));
+    file.read(reinterpret_cast<char*>(&settings.lodDistance), sizeof(settings.lodDistance));
+    file.read(reinterpret_cast<char*>(&settings.lodPeriod), sizeof(settings.lodPeriod));
+    file.read(reinterpret_cast<char*>(&pathLength), sizeof(pathLength));
+    if (!file || std::memcmp(magic, "GINP", 4) != 0 || version != inputRecordingVersion || pathLength > inputMaxPathLength)
+    {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%s isn't an input recording", path);
+        return false;
+    }
+    settings.levelPath.resize(pathLength);
+    if (pathLength > 0)
+        file.read(&settings.levelPath[0], pathLength);
+    if (!file)
+    {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Input recording %s is cut short", path);
+        settings.levelPath.clear();
+        return false;
+    }
+    settings.streaming = streamed != 0;
+    settings.continuousCollision = swept != 0;
+
+    Run next;
+    while (file.read(reinterpret_cast<char*>(&next.buttons), sizeof(next.buttons))
+        && file.read(reinterpret_cast<char*>(&next.count), sizeof(next.count)))
+        runs.push_back(next);
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Input recording %s has %u runs", path, unsigned(runs.size()));
+    return true;
+}
+
+/**
+ * Moves to next recorded step.
+ * @return bool false if every step was replayed
+ */
+bool InputReplay::next()
+{
+    while (run < runs.size() && replayed >= runs[run].count)
+    {
+        ++run;
+        replayed = 0;
+    }
+    if (run >= runs.size())
+        return false;
+    ++replayed;
+    return true;
+}
+
+/**
+ * Get buttons held during current step.
+ * @return InputButton
+ */
+InputButton InputReplay::getButtons()
+{
+    return run < runs.size() ? runs[run].buttons : InputButton::None;
+}
+
+/**
+ * Get settings of Game during recording.
+ * @return InputSettings const&
+ */
+InputSettings const& InputReplay::getSettings() const
+{
+    return settings;
+}
@@ -0,0 +1,265 @@
+#ifndef INPUTSOURCE_H
+#define INPUTSOURCE_H
+
+#include <SDL_stdinc.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * Version of recording files written by InputRecorder, changed whenever their layout changes.
+ */
+Uint32 const inputRecordingVersion = 3;
+
+/**
+ * Longest level path that recording files may hold, longer ones mean file is broken.
+ */
+Uint32 const inputMaxPathLength = 4096;
+
+/**
+ * The buttons that are read by PlayerController.
+ * Multiple buttons can be combined by treating them as bit fields.
+ * @see InputSource
+ */
+enum class InputButton : Uint8
+{
+    /**
+     * No button is held.
+     */
+    None = 0x0,
+
+    /**
+     * Walk left.
+     */
+    Left = 0x1,
+
+    /**
+     * Walk right.
+     */
+    Right = 0x2,
+
+    /**
+     * Jump, holding it makes jump longer.
+     */
+    Jump = 0x4
+};
+
+/**
+ * OR operator overload so InputButton can be used as a flag field.
+ * @see InputButton
+ */
+inline InputButton operator| (InputButton a, InputButton b)
+{
+    return static_cast<InputButton>(static_cast<int>(a) | static_cast<int>(b));
+}
+
+/**
+ * AND operator overload so InputButton can be used as a flag field.
+ * @see InputButton
+ */
+inline InputButton operator& (InputButton a, InputButton b)
+{
+    return static_cast<InputButton>(static_cast<int>(a) & static_cast<int>(b));
+}
+
+/**
+ * OR assignment operator overload so InputButton can be used as a flag field.
+ * @see InputButton
+ */
+inline InputButton& operator|= (InputButton& a, InputButton b)
+{
+    return a = a | b;
+}
+
+/**
+ * InputSettings is a struct that holds settings of Game that a recorded run depends on.
+ * @see InputRecorder
+ */
+struct InputSettings
+{
+    std::string levelPath;    // path of recorded level file, empty for built-in level
+    double timestep;          // timestep of Physics in seconds
+    bool streaming;           // true if level is streamed
+    bool continuousCollision; // true if Physics sweeps fast Creatures
+    Uint8 broadphase;         // BroadphaseType of Physics
+    Uint32 workerCount;       // number of worker threads of Physics
+    double lodDistance;       // distance beyond which Creatures are far
+    Uint32 lodPeriod;         // number of steps between updates of far Creatures
+};
+
+/**
+ * InputSource is a source of buttons held by player. Game reads it once per step of Physics and hands buttons to PlayerController.
+ * By default it reads keyboard state of SDL, derived classes can feed recorded or generated input.
+ * @see Game
+ * @see PlayerController
+ */
+class InputSource
+{
+public:
+    /**
+     * The default constructor.
+     */
+    InputSource();
+
+    /**
+     * The default destructor.
+     */
+    virtual ~InputSource();
+
+    /**
+     * Get buttons that are held now.
+     * @return InputButton
+     */
+    virtual InputButton getButtons();
+};
+
+/**
+ * InputRecorder writes buttons of every step of Physics to a file, so a run can be replayed exactly.
+ * File starts with a header that holds settings the run depends on, followed by runs of steps with equal buttons.
+ * Every run is buttons as Uint8 and count as Uint16, so holding a button costs a few bytes a second.
+ * Values are written in byte order of host.
+ * @see InputReplay
+ */
+class InputRecorder
+{
+public:
+    /**
+     * The default constructor.
+     */
+    InputRecorder();
+
+    /**
+     * The default destructor. Closes file.
+     */
+    ~InputRecorder();
+
+    /**
+     * Creates recording file and writes its header. Recording that was open is closed.
+     * @param path path of recording file
+     * @param settings settings of Game that run depends on
+     * @return bool true if file was created
+     */
+    bool open(char const* path, InputSettings const& settings);
+
+    /**
+     * Writes last run and closes file.
+     * @return void
+     */
+    void close();
+
+    /**
+     * Check if recording file is open.
+     * @return bool
+     */
+    bool isOpen() const;
+
+    /**
+     * Records a single step.
+     * @param buttons buttons that were held
+     * @return void
+     */
+    void record(InputButton buttons);
+
+private:
+    /**
+     * Recording file.
+     */
+    std::ofstream file;
+
+    /**
+     * Buttons of current run.
+     */
+    InputButton runButtons;
+
+    /**
+     * Number of steps in current run.
+     */
+    Uint16 runCount;
+
+    /**
+     * Number of recorded steps.
+     */
+    Uint32 stepCount;
+
+    /**
+     * Writes current run to file.
+     * @return void
+     */
+    void writeRun();
+};
+
+/**
+ * InputReplay is an InputSource that feeds buttons recorded by InputRecorder, one step at a time.
+ * Whole recording is read into memory when it's opened, so replaying never touches disk.
+ * @see InputRecorder
+ */
+class InputReplay: public InputSource
+{
+public:
+    /**
+     * The default constructor.
+     */
+    InputReplay();
+
+    /**
+     * The default destructor.
+     */
+    ~InputReplay();
+
+    /**
+     * Reads recording file. Replay starts before first step.
+     * @param path path of recording file
+     * @return bool true if file is a valid recording
+     */
+    bool open(char const* path);
+
+    /**
+     * Moves to next recorded step.
+     * @return bool false if every step was replayed
+     */
+    bool next();
+
+    /**
+     * Get buttons held during current step.
+     * @return InputButton
+     */
+    InputButton getButtons() override;
+
+    /**
+     * Get settings of Game during recording.
+     * @return InputSettings const&
+     */
+    InputSettings const& getSettings() const;
+
+private:
+    /**
+     * Run is a struct that holds consecutive steps with equal buttons.
+     */
+    struct Run
+    {
+        InputButton buttons; // buttons that were held
+        Uint16 count;        // number of steps
+    };
+
+    /**
+     * Recorded runs.
+     */
+    std::vector<Run> runs;
+
+    /**
+     * Index of current run.
+     */
+    size_t run;
+
+    /**
+     * Number of steps of current run that were replayed.
+     */
+    unsigned replayed;
+
+    /**
+     * Settings of Game during recording.
+     */
+    InputSettings settings;
+};
+
+#endif // INPUTSOURCE_H
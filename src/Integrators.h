@@ -0,0 +1,106 @@
+#ifndef INTEGRATORS_H
+#define INTEGRATORS_H
+
+/**
+ * Integrator policies used by BodyStore to advance bodies under constant acceleration.
+ * Every policy has a static step function template that works on any SimdLanes type.
+ * @see BodyStore
+ * @see SimdLanes.h
+ */
+
+/**
+ * The types of integrators that can be chosen for a level.
+ * @see Physics
+ */
+enum class IntegratorType
+{
+    /**
+     * Classic fourth order Runge-Kutta.
+     * @see RK4Integrator
+     */
+    RK4,
+
+    /**
+     * Semi-implicit (symplectic) Euler.
+     * @see SemiImplicitEulerIntegrator
+     */
+    SemiImplicitEuler,
+
+    /**
+     * Exact closed form for constant acceleration.
+     * @see ConstantAccelerationIntegrator
+     */
+    ConstantAcceleration
+};
+
+/**
+ * RK4Integrator evaluates four derivatives per step.
+ * Acceleration doesn't depend on state, so all four derivatives of velocity are equal.
+ */
+struct RK4Integrator
+{
+    /**
+     * Advances position and velocity by one step.
+     * @param position reference to position that will be changed
+     * @param speed reference to velocity that will be changed
+     * @param acceleration constant acceleration
+     * @param dt a timestep
+     * @return void
+     */
+    template <class L>
+    static void step(L& position, L& speed, L acceleration, L dt)
+    {
+        L halfDt = dt * L(0.5);
+        L aDx = speed;
+        L bDx = speed + acceleration * halfDt;
+        L cDx = speed + acceleration * halfDt;
+        L dDx = speed + acceleration * dt;
+        position = position + (aDx + L(2.0) * (bDx + cDx) + dDx) * (dt * L(1.0 / 6.0));
+        speed = speed + acceleration * dt;
+    }
+};
+
+/**
+ * SemiImplicitEulerIntegrator updates velocity first and moves with the new velocity.
+ * Using the new velocity moves it a*dt^2/2 ahead of the exact trajectory every step, but it's the cheapest.
+ */
+struct SemiImplicitEulerIntegrator
+{
+    /**
+     * Advances position and velocity by one step.
+     * @param position reference to position that will be changed
+     * @param speed reference to velocity that will be changed
+     * @param acceleration constant acceleration
+     * @param dt a timestep
+     * @return void
+     */
+    template <class L>
+    static void step(L& position, L& speed, L acceleration, L dt)
+    {
+        speed = speed + acceleration * dt;
+        position = position + speed * dt;
+    }
+};
+
+/**
+ * ConstantAccelerationIntegrator uses x += v*dt + a*dt^2/2, which is exact when acceleration is constant.
+ */
+struct ConstantAccelerationIntegrator
+{
+    /**
+     * Advances position and velocity by one step.
+     * @param position reference to position that will be changed
+     * @param speed reference to velocity that will be changed
+     * @param acceleration constant acceleration
+     * @param dt a timestep
+     * @return void
+     */
+    template <class L>
+    static void step(L& position, L& speed, L acceleration, L dt)
+    {
+        position = position + (speed + acceleration * dt * L(0.5)) * dt;
+        speed = speed + acceleration * dt;
+    }
+};
+
+#endif // INTEGRATORS_H
@@ -0,0 +1,407 @@
+#include "LevelFile.h"
+#include "Integrators.h"
+#include <SDL_endian.h>
+#include <SDL_log.h>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <vector>
+
+/**
+ * LevelFile implementation
+ */
+
+/**
+ * The default constructor. No level is open.
+ */
+LevelFile::LevelFile() :
+    header(nullptr)
+{
+}
+
+/**
+ * The default destructor. Closes level.
+ */
+LevelFile::~LevelFile()
+{
+}
+
+/**
+ * Check if record has finite position.
+ * @param point record of object
+ * @return bool
+ */
+static bool isValidPoint(LevelPoint const& point)
+{
+    return std::isfinite(point.x) && std::isfinite(point.y);
+}
+
+/**
+ * Check if record has finite position and finite size greater than 0.
+ * @param box record of object
+ * @param maxWidth width of widest object allowed by header
+ * @return bool
+ */
+static bool isValidBox(LevelBox const& box, float maxWidth)
+{
+    return std::isfinite(box.x) && std::isfinite(box.y) && std::isfinite(box.width) && std::isfinite(box.height) &&
+        box.width > 0.0f && box.height > 0.0f && box.width <= maxWidth;
+}
+
+/**
+ * Maps level file into memory and checks its header, size and records.
+ * Records are read in place, so only little-endian machines can read levels.
+ * Every record is checked once here, so nothing that reads them later has to deal with damaged values.
+ * @param path path to binary level file
+ * @return bool true if level can be read
+ */
+bool LevelFile::open(char const* path)
+{
+    header = nullptr;
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Level %s can't be read on big-endian machine", path);
+    return false;
+#endif
+    if (!file.open(path))
+    {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Couldn't map level %s", path);
+        return false;
+    }
+    LevelHeader const* candidate = reinterpret_cast<LevelHeader const*>(file.getData());
+    if (file.getSize() < sizeof(LevelHeader) || std::memcmp(candidate->magic, "GLVL", 4) != 0 || candidate->version != levelFormatVersion)
+    {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Level %s has unknown format", path);
+        file.close();
+        return false;
+    }
+    Uint64 size = sizeof(LevelHeader) +
+        Uint64(candidate->solidCount) * sizeof(LevelBox) +
+        Uint64(candidate->playerCount) * sizeof(LevelPoint) +
+        Uint64(candidate->monsterCount) * sizeof(LevelMonster) +
+        Uint64(candidate->coinCount) * sizeof(LevelPoint) +
+        Uint64(candidate->triggerCount) * sizeof(LevelTrigger) +
+        Uint64(candidate->behaviorCount) * sizeof(LevelBehavior) +
+        Uint64(candidate->stateCount) * sizeof(LevelBehaviorState);
+    if (size != file.getSize() || candidate->playerCount != 1 || candidate->width == 0 || candidate->width > Uint32(INT_MAX) ||
+        candidate->height == 0 || candidate->height > Uint32(INT_MAX) || !std::isfinite(candidate->maxWidth) ||
+        candidate->integrator > Uint32(IntegratorType::ConstantAcceleration))
+    {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Level %s is damaged", path);
+        file.close();
+        return false;
+    }
+    header = candidate;
+    auto reject = [this, path](char const* section, Uint32 index)
+    {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Level %s has damaged %s %u", path, section, unsigned(index));
+        header = nullptr;
+        file.close();
+        return false;
+    };
+
+    LevelBox const* solids = getSolids();
+    for (Uint32 i = 0; i < header->solidCount; ++i)
+        if (!isValidBox(solids[i], header->maxWidth))
+            return reject("solid object", i);
+    if (!isValidPoint(getPlayers()[0]))
+        return reject("player", 0);
+    LevelMonster const* monsters = getMonsters();
+    for (Uint32 i = 0; i < header->monsterCount; ++i)
+        if (!isValidBox(monsters[i].box, std::numeric_limits<float>::max()))
+            return reject("monster", i);
+    LevelPoint const* coins = getCoins();
+    for (Uint32 i = 0; i < header->coinCount; ++i)
+        if (!isValidPoint(coins[i]))
+            return reject("coin", i);
+    LevelTrigger const* triggers = getTriggers();
+    for (Uint32 i = 0; i < header->triggerCount; ++i)
+        if (!isValidBox(triggers[i].box, header->maxWidth) || triggers[i].action > Uint32(TriggerAction::Win))
+            return reject("trigger", i);
+    LevelBehavior const* behaviors = getBehaviors();
+    for (Uint32 i = 0; i < header->behaviorCount; ++i)
+        if (behaviors[i].stateCount == 0 || behaviors[i].stateCount > 255 ||
+            behaviors[i].firstState > header->stateCount || behaviors[i].stateCount > header->stateCount - behaviors[i].firstState)
+            return reject("behavior", i);
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Level %s mapped, %u bytes", path, unsigned(size));
+    return true;
+}
+
+/**
+ * Get header of open level.
+ * @return LevelHeader const&
+ */
+LevelHeader const& LevelFile::getHeader() const
+{
+    return *header;
+}
+
+/**
+ * Get records of solid objects, there's getHeader().solidCount of them.
+ * @return LevelBox const*
+ */
+LevelBox const* LevelFile::getSolids() const
+{
+    return reinterpret_cast<LevelBox const*>(header + 1);
+}
+
+/**
+ * Get records of players, there's getHeader().playerCount of them.
+ * @return LevelPoint const*
+ */
+LevelPoint const* LevelFile::getPlayers() const
+{
+    return reinterpret_cast<LevelPoint const*>(getSolids() + header->solidCount);
+}
+
+/**
+ * Get records of monsters, there's getHeader().monsterCount of them.
+ * @return LevelMonster const*
+ */
+LevelMonster const* LevelFile::getMonsters() const
+{
+    return reinterpret_cast<LevelMonster const*>(getPlayers() + header->playerCount);
+}
+
+/**
+ * Get records of coins, there's getHeader().coinCount of them.
+ * @return LevelPoint const*
+ */
+LevelPoint const* LevelFile::getCoins() const
+{
+    return reinterpret_cast<LevelPoint const*>(getMonsters() + header->monsterCount);
+}
+
+/**
+ * Get records of triggers, there's getHeader().triggerCount of them.
+ * @return LevelTrigger const*
+ */
+LevelTrigger const* LevelFile::getTriggers() const
+{
+    return reinterpret_cast<LevelTrigger const*>(getCoins() + header->coinCount);
+}
+
+/**
+ * Get records of monster behaviors, there's getHeader().behaviorCount of them.
+ * @return LevelBehavior const*
+ */
+LevelBehavior const* LevelFile::getBehaviors() const
+{
+    return reinterpret_cast<LevelBehavior const*>(getTriggers() + header->triggerCount);
+}
+
+/**
+ * Get records of states of monster behaviors, there's getHeader().stateCount of them.
+ * @return LevelBehaviorState const*
+ */
+LevelBehaviorState const* LevelFile::getBehaviorStates() const
+{
+    return reinterpret_cast<LevelBehaviorState const*>(getBehaviors() + header->behaviorCount);
+}
+
+/**
+ * Converts text level into binary level file.
+ * Text level has to have exactly one level line and exactly one player line. Level without named integrator uses constant acceleration.
+ * Records are sorted by x, objects with equal x keep their order. Behaviors and their states keep order of text.
+ * Names of behaviors and states are only used to resolve references, they aren't written.
+ * @param text stream with text level
+ * @param binary stream to which binary level is written
+ * @param error description of first error, set when conversion fails
+ * @return bool true if level was converted
+ */
+bool LevelFile::convert(std::istream& text, std::ostream& binary, std::string& error)
+{
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    error = "levels can't be written on big-endian machine";
+    return false;
+#endif
+    LevelHeader newHeader;
+    std::memcpy(newHeader.magic, "GLVL", 4);
+    newHeader.version = levelFormatVersion;
+    newHeader.width = 0;
+    newHeader.height = 0;
+    newHeader.integrator = Uint32(IntegratorType::ConstantAcceleration);
+    std::vector<LevelBox> solids;
+    std::vector<LevelPoint> players;
+    std::vector<LevelMonster> monsters;
+    std::vector<LevelPoint> coins;
+    std::vector<LevelTrigger> triggers;
+    std::vector<LevelBehavior> behaviors;
+    std::vector<LevelBehaviorState> states;
+    std::map<std::string, Uint32> behaviorNames;
+    bool hasSize = false;
+
+    //states of last behavior refer to each other by name, so they are resolved once the whole behavior was read
+    std::string behaviorName;
+    std::vector<std::string> stateNames;
+    std::vector<std::string> transitionNames;
+    auto closeBehavior = [&]() -> bool
+    {
+        if (behaviors.empty())
+            return true;
+        LevelBehavior& behavior = behaviors.back();
+        behavior.stateCount = Uint32(states.size()) - behavior.firstState;
+        if (behavior.stateCount == 0)
+        {
+            error = "behavior " + behaviorName + " has no states";
+            return false;
+        }
+        for (Uint32 i = 0; i < behavior.stateCount; ++i)
+        {
+            LevelBehaviorState& state = states[behavior.firstState + i];
+            Uint32* next[3] = { &state.onTimer, &state.onWall, &state.onLand };
+            for (int j = 0; j < 3; ++j)
+            {
+                std::string const& target = transitionNames[i*3 + j];
+                std::vector<std::string>::const_iterator found = std::find(stateNames.begin(), stateNames.end(), target);
+                if (target == "-")
+                    *next[j] = noBehavior;
+                else if (found != stateNames.end())
+                    *next[j] = Uint32(found - stateNames.begin());
+                else
+                {
+                    error = "behavior " + behaviorName + " has no state " + target;
+                    return false;
+                }
+            }
+        }
+        stateNames.clear();
+        transitionNames.clear();
+        return true;
+    };
+
+    std::string line;
+    for (unsigned lineNumber = 1; std::getline(text, line); ++lineNumber)
+    {
+        std::istringstream words(line);
+        std::string kind;
+        if (!(words >> kind) || kind[0] == '#')
+            continue;
+
+        bool valid = true;
+        if (kind == "level")
+        {
+            std::string integrator;
+            valid = !hasSize && (words >> newHeader.width >> newHeader.height) && newHeader.width > 0 && newHeader.height > 0 &&
+                newHeader.width <= Uint32(INT_MAX) && newHeader.height <= Uint32(INT_MAX);
+            if (valid && words >> integrator)
+            {
+                valid = integrator == "rk4" || integrator == "euler" || integrator == "exact";
+                newHeader.integrator = Uint32(integrator == "rk4" ? IntegratorType::RK4 : integrator == "euler" ?
+                    IntegratorType::SemiImplicitEuler : IntegratorType::ConstantAcceleration);
+            }
+            hasSize = true;
+        }
+        else if (kind == "solid")
+        {
+            LevelBox box;
+            valid = (words >> box.x >> box.y >> box.width >> box.height) && box.width > 0 && box.height > 0;
+            solids.push_back(box);
+        }
+        else if (kind == "monster")
+        {
+            LevelMonster monster;
+            std::string behavior;
+            valid = (words >> monster.box.x >> monster.box.y >> monster.box.width >> monster.box.height) && monster.box.width > 0 && monster.box.height > 0;
+            monster.behavior = noBehavior;
+            if (valid && words >> behavior)
+            {
+                std::map<std::string, Uint32>::const_iterator found = behaviorNames.find(behavior);
+                valid = found != behaviorNames.end();
+                if (valid)
+                    monster.behavior = found->second;
+            }
+            monsters.push_back(monster);
+        }
+        else if (kind == "player" || kind == "coin")
+        {
+            LevelPoint point;
+            valid = (words >> point.x >> point.y) ? true : false;
+            (kind == "player" ? players : coins).push_back(point);
+        }
+        else if (kind == "trigger")
+        {
+            std::string action;
+            LevelTrigger trigger;
+            valid = (words >> action >> trigger.box.x >> trigger.box.y >> trigger.box.width >> trigger.box.height) && action == "win" &&
+                trigger.box.width > 0 && trigger.box.height > 0;
+            trigger.action = Uint32(TriggerAction::Win);
+            triggers.push_back(trigger);
+        }
+        else if (kind == "behavior")
+        {
+            if (!closeBehavior())
+                return false;
+            valid = (words >> behaviorName) && behaviorNames.find(behaviorName) == behaviorNames.end();
+            behaviorNames[behaviorName] = Uint32(behaviors.size());
+            LevelBehavior behavior = { Uint32(states.size()), 0 };
+            behaviors.push_back(behavior);
+        }
+        else if (kind == "state")
+        {
+            std::string name;
+            std::string move;
+            std::string next[3];
+            LevelBehaviorState state;
+            valid = !behaviors.empty() && (words >> name >> move >> state.speed >> state.jumpSpeed >> state.duration >> next[0] >> next[1] >> next[2]) &&
+                (move == "left" || move == "right" || move == "stop" || move == "chase") && state.speed >= 0 && state.jumpSpeed >= 0 && state.duration <= 0xFFFF &&
+                std::find(stateNames.begin(), stateNames.end(), name) == stateNames.end() && stateNames.size() < 255;
+            state.move = Uint32(move == "left" ? BehaviorMove::Left : move == "right" ? BehaviorMove::Right :
+                move == "chase" ? BehaviorMove::Chase : BehaviorMove::Stop);
+            stateNames.push_back(name);
+            transitionNames.insert(transitionNames.end(), next, next + 3);
+            states.push_back(state);
+        }
+        else
+            valid = false;
+
+        std::string rest;
+        if (!valid || words >> rest)
+        {
+            error = "line " + std::to_string(lineNumber) + ": can't read \"" + line + "\"";
+            return false;
+        }
+    }
+    if (!closeBehavior())
+        return false;
+    if (!hasSize || players.size() != 1)
+    {
+        error = "level needs one level line and one player line";
+        return false;
+    }
+
+    std::stable_sort(solids.begin(), solids.end(), [](LevelBox const& a, LevelBox const& b){ return a.x < b.x; });
+    std::stable_sort(monsters.begin(), monsters.end(), [](LevelMonster const& a, LevelMonster const& b){ return a.box.x < b.box.x; });
+    std::stable_sort(coins.begin(), coins.end(), [](LevelPoint const& a, LevelPoint const& b){ return a.x < b.x; });
+    std::stable_sort(triggers.begin(), triggers.end(), [](LevelTrigger const& a, LevelTrigger const& b){ return a.box.x < b.box.x; });
+
+    newHeader.maxWidth = 0.0f;
+    for (size_t i = 0; i < solids.size(); ++i)
+        newHeader.maxWidth = std::max(newHeader.maxWidth, solids[i].width);
+    for (size_t i = 0; i < triggers.size(); ++i)
+        newHeader.maxWidth = std::max(newHeader.maxWidth, triggers[i].box.width);
+    newHeader.solidCount = Uint32(solids.size());
+    newHeader.playerCount = Uint32(players.size());
+    newHeader.monsterCount = Uint32(monsters.size());
+    newHeader.coinCount = Uint32(coins.size());
+    newHeader.triggerCount = Uint32(triggers.size());
+    newHeader.behaviorCount = Uint32(behaviors.size());
+    newHeader.stateCount = Uint32(states.size());
+    binary.write(reinterpret_cast<char const*>(&newHeader), sizeof(newHeader));
+    binary.write(reinterpret_cast<char const*>(solids.data()), solids.size() * sizeof(LevelBox));
+    binary.write(reinterpret_cast<char const*>(players.data()), players.size() * sizeof(LevelPoint));
+    binary.write(reinterpret_cast<char const*>(monsters.data()), monsters.size() * sizeof(LevelMonster));
+    binary.write(reinterpret_cast<char const*>(coins.data()), coins.size() * sizeof(LevelPoint));
+    binary.write(reinterpret_cast<char const*>(triggers.data()), triggers.size() * sizeof(LevelTrigger));
+    binary.write(reinterpret_cast<char const*>(behaviors.data()), behaviors.size() * sizeof(LevelBehavior));
+    binary.write(reinterpret_cast<char const*>(states.data()), states.size() * sizeof(LevelBehaviorState));
+    if (!binary)
+    {
+        error = "couldn't write level";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,264 @@
+#ifndef LEVELFILE_H
+#define LEVELFILE_H
+
+#include "MappedFile.h"
+#include <SDL_stdinc.h>
+#include <istream>
+#include <ostream>
+#include <string>
+
+/**
+ * Version of binary level format written by LevelFile::convert.
+ */
+Uint32 const levelFormatVersion = 4;
+
+/**
+ * The types of actions that a Trigger stored in level file can fire.
+ * @see LevelFile
+ */
+enum class TriggerAction : Uint32
+{
+    /**
+     * Player wins game.
+     */
+    Win
+};
+
+/**
+ * The ways a state of monster behavior stored in level file moves its monster.
+ * @see LevelBehaviorState
+ */
+enum class BehaviorMove : Uint8
+{
+    /**
+     * Monster stands still.
+     */
+    Stop,
+
+    /**
+     * Monster walks left.
+     */
+    Left,
+
+    /**
+     * Monster walks right.
+     */
+    Right,
+
+    /**
+     * Monster follows NavGraph towards nearest player, jumping at jump links.
+     */
+    Chase
+};
+
+/**
+ * Value of monster behavior or state transition that means there's none.
+ */
+Uint32 const noBehavior = 0xFFFFFFFF;
+
+/**
+ * Header of binary level file.
+ * It's followed by sections of records in order: solid objects, players, monsters, coins, triggers, behaviors, behavior states.
+ * Records of every section are sorted by x, so objects of a part of level can be found by binary search.
+ * Every value is stored in little-endian order.
+ */
+struct LevelHeader
+{
+    char magic[4];       // "GLVL"
+    Uint32 version;      // levelFormatVersion
+    Uint32 width;        // width of level, at most INT_MAX
+    Uint32 height;       // height of level, at most INT_MAX
+    Uint32 integrator;   // IntegratorType that moves objects of level
+    float maxWidth;      // width of widest solid object or trigger
+    Uint32 solidCount;   // number of LevelBox records of solid objects
+    Uint32 playerCount;  // number of LevelPoint records of players, always 1
+    Uint32 monsterCount; // number of LevelMonster records
+    Uint32 coinCount;    // number of LevelPoint records of coins
+    Uint32 triggerCount; // number of LevelTrigger records
+    Uint32 behaviorCount; // number of LevelBehavior records
+    Uint32 stateCount;   // number of LevelBehaviorState records
+};
+
+/**
+ * Record of an object with position and size.
+ */
+struct LevelBox
+{
+    float x;
+    float y;
+    float width;
+    float height;
+};
+
+/**
+ * Record of an object with position only.
+ */
+struct LevelPoint
+{
+    float x;
+    float y;
+};
+
+/**
+ * Record of a monster.
+ */
+struct LevelMonster
+{
+    LevelBox box;
+    Uint32 behavior; // index of LevelBehavior record, noBehavior for default walking
+};
+
+/**
+ * Record of a Trigger.
+ */
+struct LevelTrigger
+{
+    LevelBox box;
+    Uint32 action; // TriggerAction
+};
+
+/**
+ * Record of a monster behavior, a state machine shared by every monster that has it.
+ * Its states are consecutive LevelBehaviorState records, first of them is where monsters start.
+ */
+struct LevelBehavior
+{
+    Uint32 firstState; // index of first LevelBehaviorState record
+    Uint32 stateCount; // number of states, at most 255
+};
+
+/**
+ * Record of a state of monster behavior.
+ * Transitions are indices of states within behavior, noBehavior if state doesn't leave on that event.
+ */
+struct LevelBehaviorState
+{
+    Uint32 move;      // BehaviorMove
+    float speed;      // horizontal speed
+    float jumpSpeed;  // vertical speed of jump made when state is entered on ground, or at jump links while chasing, 0 for none
+    Uint32 duration;  // number of steps after which timer transition is taken, 0 for none
+    Uint32 onTimer;   // state entered when duration has passed
+    Uint32 onWall;    // state entered when monster walks into a wall
+    Uint32 onLand;    // state entered when monster stands on ground
+};
+
+/**
+ * LevelFile reads levels stored in compact binary format.
+ * File is mapped into memory and records are read in place, so opening a level doesn't copy or parse it.
+ * Binary files are made from text files by convert, every line of text file describes a single object:
+ *
+ *     level <width> <height> [<rk4|euler|exact>]
+ *     solid <x> <y> <width> <height>
+ *     player <x> <y>
+ *     monster <x> <y> <width> <height> [<behavior>]
+ *     coin <x> <y>
+ *     trigger win <x> <y> <width> <height>
+ *     behavior <name>
+ *     state <name> <left|right|stop|chase> <speed> <jumpSpeed> <duration> <onTimer> <onWall> <onLand>
+ *
+ * Level line may name integrator of level: rk4, euler for semi-implicit Euler or exact for constant acceleration, which is used if none is named.
+ * State lines belong to the behavior line above them, first of them is where monsters start.
+ * Transitions name states of the same behavior, - means no transition. Monsters can only name behaviors defined above them.
+ * Empty lines and lines starting with # are skipped.
+ * @see MappedFile
+ */
+class LevelFile
+{
+public:
+    /**
+     * The default constructor. No level is open.
+     */
+    LevelFile();
+
+    /**
+     * The default destructor. Closes level.
+     */
+    ~LevelFile();
+
+    /**
+     * Maps level file into memory and checks its header, size and records.
+     * @param path path to binary level file
+     * @return bool true if level can be read
+     */
+    bool open(char const* path);
+
+    /**
+     * Get header of open level.
+     * @return LevelHeader const&
+     */
+    LevelHeader const& getHeader() const;
+
+    /**
+     * Get records of solid objects, there's getHeader().solidCount of them.
+     * @return LevelBox const*
+     */
+    LevelBox const* getSolids() const;
+
+    /**
+     * Get records of players, there's getHeader().playerCount of them.
+     * @return LevelPoint const*
+     */
+    LevelPoint const* getPlayers() const;
+
+    /**
+     * Get records of monsters, there's getHeader().monsterCount of them.
+     * @return LevelMonster const*
+     */
+    LevelMonster const* getMonsters() const;
+
+    /**
+     * Get records of coins, there's getHeader().coinCount of them.
+     * @return LevelPoint const*
+     */
+    LevelPoint const* getCoins() const;
+
+    /**
+     * Get records of triggers, there's getHeader().triggerCount of them.
+     * @return LevelTrigger const*
+     */
+    LevelTrigger const* getTriggers() const;
+
+    /**
+     * Get records of monster behaviors, there's getHeader().behaviorCount of them.
+     * @return LevelBehavior const*
+     */
+    LevelBehavior const* getBehaviors() const;
+
+    /**
+     * Get records of states of monster behaviors, there's getHeader().stateCount of them.
+     * @return LevelBehaviorState const*
+     */
+    LevelBehaviorState const* getBehaviorStates() const;
+
+    /**
+     * Converts text level into binary level file.
+     * @param text stream with text level
+     * @param binary stream to which binary level is written
+     * @param error description of first error, set when conversion fails
+     * @return bool true if level was converted
+     */
+    static bool convert(std::istream& text, std::ostream& binary, std::string& error);
+
+    /**
+     * Copy constructor is deleted because mapping can't be shared.
+     */
+    LevelFile(LevelFile const&) = delete;
+
+    /**
+     * Assignment operator is deleted because mapping can't be shared.
+     */
+    LevelFile& operator=(LevelFile const&) = delete;
+
+private:
+    /**
+     * Mapped level file.
+     */
+    MappedFile file;
+
+    /**
+     * A pointer to header in mapped file.
+     */
+    LevelHeader const* header;
+};
+
+#endif // LEVELFILE_H
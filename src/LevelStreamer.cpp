@@ -0,0 +1,366 @@
+#include "LevelStreamer.h"
+#include "Snapshot.h"
+#include <SDL_log.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * LevelStreamer implementation
+ */
+
+/**
+ * The default constructor. Starts thread that reads chunks.
+ * @param chunkWidth width of a single chunk
+ */
+LevelStreamer::LevelStreamer(double chunkWidth) :
+    chunkWidth(chunkWidth),
+    chunkCount(0),
+    stopping(false)
+{
+    thread = std::thread(&LevelStreamer::readLoop, this);
+}
+
+/**
+ * The default destructor. Stops thread that reads chunks.
+ */
+LevelStreamer::~LevelStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+/**
+ * Opens level file. Every record is marked as stored and no chunk is resident.
+ * Shouldn't be called while chunks are pending.
+ * @param path path to binary level file
+ * @return bool true if level can be read
+ */
+bool LevelStreamer::open(char const* path)
+{
+    resident.clear();
+    pending.clear();
+    monsterRecords.clear();
+    coinRecords.clear();
+    if (!level.open(path))
+        return false;
+    chunkCount = std::max(1, int(std::ceil(level.getHeader().width / chunkWidth)));
+    monsterStates.assign(level.getHeader().monsterCount, RecordState::Stored);
+    coinStates.assign(level.getHeader().coinCount, RecordState::Stored);
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Level %s streamed in %d chunks", path, chunkCount);
+    return true;
+}
+
+/**
+ * Get header of open level.
+ * @return LevelHeader const&
+ */
+LevelHeader const& LevelStreamer::getHeader() const
+{
+    return level.getHeader();
+}
+
+/**
+ * Get record of player.
+ * @return LevelPoint const&
+ */
+LevelPoint const& LevelStreamer::getPlayer() const
+{
+    return level.getPlayers()[0];
+}
+
+/**
+ * Get streamed level file, for records that are needed whole rather than by chunks.
+ * @return LevelFile const&
+ */
+LevelFile const& LevelStreamer::getLevel() const
+{
+    return level;
+}
+
+/**
+ * Get index of chunk that contains given x, clamped to chunks of level.
+ * @param x horizontal position
+ * @return int
+ */
+int LevelStreamer::getChunk(double x) const
+{
+    if (x < 0.0)
+        return 0;
+    return std::min(chunkCount - 1, int(x / chunkWidth));
+}
+
+/**
+ * Get number of chunks that are crossed by objects of a single chunk on their right.
+ * @return int
+ */
+int LevelStreamer::getReach() const
+{
+    return int(std::ceil(level.getHeader().maxWidth / chunkWidth));
+}
+
+/**
+ * Reads records of a chunk on calling thread.
+ * Records are sorted by x, so every section is cut with binary search.
+ * @param index index of chunk
+ * @param chunk chunk to which records are copied
+ * @return void
+ */
+void LevelStreamer::read(int index, LevelChunk& chunk) const
+{
+    LevelHeader const& header = level.getHeader();
+    //last chunk takes everything up to end of level
+    float left = index == 0 ? -std::numeric_limits<float>::infinity() : float(index * chunkWidth);
+    float right = index == chunkCount - 1 ? std::numeric_limits<float>::infinity() : float((index + 1) * chunkWidth);
+    auto boxBefore = [](LevelBox const& box, float x){ return box.x < x; };
+    auto monsterBefore = [](LevelMonster const& monster, float x){ return monster.box.x < x; };
+    auto pointBefore = [](LevelPoint const& point, float x){ return point.x < x; };
+    auto triggerBefore = [](LevelTrigger const& trigger, float x){ return trigger.box.x < x; };
+
+    chunk.index = index;
+    LevelBox const* solids = level.getSolids();
+    chunk.solids.assign(std::lower_bound(solids, solids + header.solidCount, left, boxBefore),
+        std::lower_bound(solids, solids + header.solidCount, right, boxBefore));
+    LevelMonster const* monsters = level.getMonsters();
+    LevelMonster const* firstMonster = std::lower_bound(monsters, monsters + header.monsterCount, left, monsterBefore);
+    chunk.firstMonster = Uint32(firstMonster - monsters);
+    chunk.monsters.assign(firstMonster, std::lower_bound(monsters, monsters + header.monsterCount, right, monsterBefore));
+    LevelPoint const* coins = level.getCoins();
+    LevelPoint const* firstCoin = std::lower_bound(coins, coins + header.coinCount, left, pointBefore);
+    chunk.firstCoin = Uint32(firstCoin - coins);
+    chunk.coins.assign(firstCoin, std::lower_bound(coins, coins + header.coinCount, right, pointBefore));
+    LevelTrigger const* triggers = level.getTriggers();
+    chunk.triggers.assign(std::lower_bound(triggers, triggers + header.triggerCount, left, triggerBefore),
+        std::lower_bound(triggers, triggers + header.triggerCount, right, triggerBefore));
+}
+
+/**
+ * Asks thread to read a chunk. Chunk is pending until it's polled.
+ * @param index index of chunk
+ * @return void
+ */
+void LevelStreamer::request(int index)
+{
+    pending.insert(index);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requests.push_back(index);
+    }
+    wake.notify_one();
+}
+
+/**
+ * Takes a chunk that was read by thread.
+ * @param chunk chunk to which records are moved
+ * @return bool true if a chunk was taken
+ */
+bool LevelStreamer::poll(LevelChunk& chunk)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (finished.empty())
+        return false;
+    chunk = std::move(finished.front());
+    finished.pop_front();
+    pending.erase(chunk.index);
+    return true;
+}
+
+/**
+ * Check if chunk was requested and not polled yet.
+ * @param index index of chunk
+ * @return bool
+ */
+bool LevelStreamer::isPending(int index) const
+{
+    return pending.count(index) != 0;
+}
+
+/**
+ * Get chunks that are in World, keyed by their index.
+ * @return std::map<int, ResidentChunk>&
+ */
+std::map<int, LevelStreamer::ResidentChunk>& LevelStreamer::getResident()
+{
+    return resident;
+}
+
+/**
+ * Get state of a monster record.
+ * @param record index of record
+ * @return RecordState
+ */
+RecordState LevelStreamer::getMonsterState(Uint32 record) const
+{
+    return monsterStates[record];
+}
+
+/**
+ * Get state of a coin record.
+ * @param record index of record
+ * @return RecordState
+ */
+RecordState LevelStreamer::getCoinState(Uint32 record) const
+{
+    return coinStates[record];
+}
+
+/**
+ * Marks a monster record as spawned as given object.
+ * @param record index of record
+ * @param id identifier of created object
+ * @return void
+ */
+void LevelStreamer::spawnMonster(Uint32 record, unsigned id)
+{
+    monsterStates[record] = RecordState::Spawned;
+    monsterRecords[id] = record;
+}
+
+/**
+ * Marks a coin record as spawned as given object.
+ * @param record index of record
+ * @param id identifier of created object
+ * @return void
+ */
+void LevelStreamer::spawnCoin(Uint32 record, unsigned id)
+{
+    coinStates[record] = RecordState::Spawned;
+    coinRecords[id] = record;
+}
+
+/**
+ * Marks record of a spawned object as stored again, because its chunk is unloaded.
+ * Objects that weren't spawned from a record are ignored.
+ * @param id identifier of object
+ * @return void
+ */
+void LevelStreamer::storeObject(unsigned id)
+{
+    std::unordered_map<unsigned, Uint32>::iterator it = monsterRecords.find(id);
+    if (it != monsterRecords.end())
+    {
+        monsterStates[it->second] = RecordState::Stored;
+        monsterRecords.erase(it);
+        return;
+    }
+    it = coinRecords.find(id);
+    if (it != coinRecords.end())
+    {
+        coinStates[it->second] = RecordState::Stored;
+        coinRecords.erase(it);
+    }
+}
+
+/**
+ * Marks record of a spawned object as removed, because it was killed or collected.
+ * Objects that weren't spawned from a record are ignored.
+ * @param id identifier of object
+ * @return void
+ */
+void LevelStreamer::removeObject(unsigned id)
+{
+    std::unordered_map<unsigned, Uint32>::iterator it = monsterRecords.find(id);
+    if (it != monsterRecords.end())
+    {
+        monsterStates[it->second] = RecordState::Removed;
+        monsterRecords.erase(it);
+        return;
+    }
+    it = coinRecords.find(id);
+    if (it != coinRecords.end())
+    {
+        coinStates[it->second] = RecordState::Removed;
+        coinRecords.erase(it);
+    }
+}
+
+/**
+ * Appends states of records and indices of resident chunks to snapshot.
+ * Objects of resident chunks aren't saved, they're saved with World.
+ * @param snapshot Snapshot that state is appended to
+ * @return void
+ * @see Snapshot
+ */
+void LevelStreamer::saveState(Snapshot& snapshot) const
+{
+    snapshot.write(Uint32(monsterStates.size()));
+    snapshot.write(monsterStates.data(), monsterStates.size() * sizeof(RecordState));
+    snapshot.write(Uint32(coinStates.size()));
+    snapshot.write(coinStates.data(), coinStates.size() * sizeof(RecordState));
+    snapshot.write(Uint32(monsterRecords.size()));
+    for (std::unordered_map<unsigned, Uint32>::const_iterator it = monsterRecords.begin(); it != monsterRecords.end(); ++it)
+    {
+        snapshot.write(it->first);
+        snapshot.write(it->second);
+    }
+    snapshot.write(Uint32(coinRecords.size()));
+    for (std::unordered_map<unsigned, Uint32>::const_iterator it = coinRecords.begin(); it != coinRecords.end(); ++it)
+    {
+        snapshot.write(it->first);
+        snapshot.write(it->second);
+    }
+    snapshot.write(Uint32(resident.size()));
+    for (std::map<int, ResidentChunk>::const_iterator it = resident.begin(); it != resident.end(); ++it)
+        snapshot.write(it->first);
+}
+
+/**
+ * Reads state appended by saveState. Records of resident chunks are read again on calling thread and their lists of objects are left empty.
+ * Snapshot has to be taken from the same level.
+ * @param snapshot Snapshot that state is read from
+ * @return void
+ * @see Snapshot
+ */
+void LevelStreamer::loadState(Snapshot& snapshot)
+{
+    monsterStates.resize(snapshot.read<Uint32>());
+    snapshot.read(monsterStates.data(), monsterStates.size() * sizeof(RecordState));
+    coinStates.resize(snapshot.read<Uint32>());
+    snapshot.read(coinStates.data(), coinStates.size() * sizeof(RecordState));
+    monsterRecords.clear();
+    for (Uint32 count = snapshot.read<Uint32>(); count > 0; --count)
+    {
+        unsigned id = snapshot.read<unsigned>();
+        monsterRecords[id] = snapshot.read<Uint32>();
+    }
+    coinRecords.clear();
+    for (Uint32 count = snapshot.read<Uint32>(); count > 0; --count)
+    {
+        unsigned id = snapshot.read<unsigned>();
+        coinRecords[id] = snapshot.read<Uint32>();
+    }
+    resident.clear();
+    for (Uint32 count = snapshot.read<Uint32>(); count > 0; --count)
+    {
+        int index = snapshot.read<int>();
+        ResidentChunk& chunk = resident[index];
+        read(index, chunk.records);
+    }
+}
+
+/**
+ * Loop of thread that reads requested chunks.
+ * Pages of mapped file are loaded here on first touch.
+ * @return void
+ */
+void LevelStreamer::readLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wake.wait(lock, [this]{ return stopping || !requests.empty(); });
+        if (stopping)
+            return;
+        int index = requests.front();
+        requests.pop_front();
+        lock.unlock();
+        LevelChunk chunk;
+        read(index, chunk);
+        lock.lock();
+        finished.push_back(std::move(chunk));
+    }
+}
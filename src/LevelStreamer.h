@@ -0,0 +1,313 @@
+#ifndef LEVELSTREAMER_H
+#define LEVELSTREAMER_H
+
+#include "LevelFile.h"
+#include "ObjectHandle.h"
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class Snapshot;
+
+/**
+ * The states of a monster or coin stored in level file.
+ * @see LevelStreamer
+ */
+enum class RecordState : unsigned char
+{
+    /**
+     * Object is only in level file.
+     */
+    Stored,
+
+    /**
+     * Object is in World.
+     */
+    Spawned,
+
+    /**
+     * Object was killed or collected and never comes back.
+     */
+    Removed
+};
+
+/**
+ * LevelChunk is a struct that holds records of objects whose left edge lies in a single chunk of level.
+ * Records are copied out of level file, so reading them doesn't touch the file.
+ */
+struct LevelChunk
+{
+    int index;                          // index of chunk
+    Uint32 firstMonster;                // index of first monster record in level file
+    Uint32 firstCoin;                   // index of first coin record in level file
+    std::vector<LevelBox> solids;       // records of solid objects
+    std::vector<LevelMonster> monsters; // records of monsters
+    std::vector<LevelPoint> coins;      // records of coins
+    std::vector<LevelTrigger> triggers; // records of triggers
+};
+
+/**
+ * LevelStreamer splits a level file into chunks of fixed width and keeps track of chunks that are in World.
+ * Chunks are read on a separate thread, so pages of mapped file are loaded off main thread.
+ * It also remembers which monsters and coins are in World or gone for good, so unloaded chunks come back as they were left.
+ * Creating and destroying objects is up to Game.
+ * @see LevelFile
+ * @see Game
+ */
+class LevelStreamer
+{
+public:
+    /**
+     * ResidentChunk is a struct that holds a chunk that is in World.
+     */
+    struct ResidentChunk
+    {
+        LevelChunk records;                // records of chunk
+        std::vector<ObjectHandle> objects; // static objects and coins created from chunk
+    };
+
+    /**
+     * The default constructor. Starts thread that reads chunks.
+     * @param chunkWidth width of a single chunk
+     */
+    LevelStreamer(double chunkWidth);
+
+    /**
+     * The default destructor. Stops thread that reads chunks.
+     */
+    ~LevelStreamer();
+
+    /**
+     * Opens level file. Every record is marked as stored and no chunk is resident.
+     * @param path path to binary level file
+     * @return bool true if level can be read
+     */
+    bool open(char const* path);
+
+    /**
+     * Get header of open level.
+     * @return LevelHeader const&
+     */
+    LevelHeader const& getHeader() const;
+
+    /**
+     * Get record of player.
+     * @return LevelPoint const&
+     */
+    LevelPoint const& getPlayer() const;
+
+    /**
+     * Get streamed level file, for records that are needed whole rather than by chunks.
+     * @return LevelFile const&
+     */
+    LevelFile const& getLevel() const;
+
+    /**
+     * Get index of chunk that contains given x, clamped to chunks of level.
+     * @param x horizontal position
+     * @return int
+     */
+    int getChunk(double x) const;
+
+    /**
+     * Get number of chunks that are crossed by objects of a single chunk on their right.
+     * @return int
+     */
+    int getReach() const;
+
+    /**
+     * Reads records of a chunk on calling thread.
+     * @param index index of chunk
+     * @param chunk chunk to which records are copied
+     * @return void
+     */
+    void read(int index, LevelChunk& chunk) const;
+
+    /**
+     * Asks thread to read a chunk. Chunk is pending until it's polled.
+     * @param index index of chunk
+     * @return void
+     */
+    void request(int index);
+
+    /**
+     * Takes a chunk that was read by thread.
+     * @param chunk chunk to which records are moved
+     * @return bool true if a chunk was taken
+     */
+    bool poll(LevelChunk& chunk);
+
+    /**
+     * Check if chunk was requested and not polled yet.
+     * @param index index of chunk
+     * @return bool
+     */
+    bool isPending(int index) const;
+
+    /**
+     * Get chunks that are in World, keyed by their index.
+     * @return std::map<int, ResidentChunk>&
+     */
+    std::map<int, ResidentChunk>& getResident();
+
+    /**
+     * Get state of a monster record.
+     * @param record index of record
+     * @return RecordState
+     */
+    RecordState getMonsterState(Uint32 record) const;
+
+    /**
+     * Get state of a coin record.
+     * @param record index of record
+     * @return RecordState
+     */
+    RecordState getCoinState(Uint32 record) const;
+
+    /**
+     * Marks a monster record as spawned as given object.
+     * @param record index of record
+     * @param id identifier of created object
+     * @return void
+     */
+    void spawnMonster(Uint32 record, unsigned id);
+
+    /**
+     * Marks a coin record as spawned as given object.
+     * @param record index of record
+     * @param id identifier of created object
+     * @return void
+     */
+    void spawnCoin(Uint32 record, unsigned id);
+
+    /**
+     * Marks record of a spawned object as stored again, because its chunk is unloaded.
+     * @param id identifier of object
+     * @return void
+     */
+    void storeObject(unsigned id);
+
+    /**
+     * Marks record of a spawned object as removed, because it was killed or collected.
+     * @param id identifier of object
+     * @return void
+     */
+    void removeObject(unsigned id);
+
+    /**
+     * Appends states of records and indices of resident chunks to snapshot.
+     * Objects of resident chunks aren't saved, they're saved with World.
+     * @param snapshot Snapshot that state is appended to
+     * @return void
+     * @see Snapshot
+     */
+    void saveState(Snapshot& snapshot) const;
+
+    /**
+     * Reads state appended by saveState. Records of resident chunks are read again on calling thread and their lists of objects are left empty.
+     * Snapshot has to be taken from the same level.
+     * @param snapshot Snapshot that state is read from
+     * @return void
+     * @see Snapshot
+     */
+    void loadState(Snapshot& snapshot);
+
+    /**
+     * Copy constructor is deleted because thread can't be copied.
+     */
+    LevelStreamer(LevelStreamer const&) = delete;
+
+    /**
+     * Assignment operator is deleted because thread can't be copied.
+     */
+    LevelStreamer& operator=(LevelStreamer const&) = delete;
+
+private:
+    /**
+     * Width of a single chunk.
+     */
+    const double chunkWidth;
+
+    /**
+     * Mapped level file.
+     */
+    LevelFile level;
+
+    /**
+     * Number of chunks of level.
+     */
+    int chunkCount;
+
+    /**
+     * Chunks that are in World.
+     */
+    std::map<int, ResidentChunk> resident;
+
+    /**
+     * Chunks that were requested and not polled yet.
+     */
+    std::set<int> pending;
+
+    /**
+     * State of every monster record.
+     */
+    std::vector<RecordState> monsterStates;
+
+    /**
+     * State of every coin record.
+     */
+    std::vector<RecordState> coinStates;
+
+    /**
+     * Monster records of spawned monsters, keyed by identifiers of objects.
+     */
+    std::unordered_map<unsigned, Uint32> monsterRecords;
+
+    /**
+     * Coin records of spawned coins, keyed by identifiers of objects.
+     */
+    std::unordered_map<unsigned, Uint32> coinRecords;
+
+    /**
+     * Thread that reads requested chunks.
+     */
+    std::thread thread;
+
+    /**
+     * Mutex guarding requests, finished chunks and stopping.
+     */
+    std::mutex mutex;
+
+    /**
+     * Wakes thread up when a chunk is requested or it should stop.
+     */
+    std::condition_variable wake;
+
+    /**
+     * Indices of chunks to be read by thread.
+     */
+    std::deque<int> requests;
+
+    /**
+     * Chunks read by thread and not polled yet.
+     */
+    std::deque<LevelChunk> finished;
+
+    /**
+     * True if thread should stop.
+     */
+    bool stopping;
+
+    /**
+     * Loop of thread that reads requested chunks.
+     * @return void
+     */
+    void readLoop();
+};
+
+#endif // LEVELSTREAMER_H
@@ -0,0 +1,111 @@
+#include "LodScheduler.h"
+#include "World.h"
+#include <algorithm>
+
+/**
+ * LodScheduler implementation
+ */
+
+/**
+ * The default constructor. Every object is near until distance is set.
+ */
+LodScheduler::LodScheduler() :
+    distance(0.0),
+    period(1),
+    hasFocus(false),
+    focusLeft(0.0),
+    focusRight(0.0)
+{
+}
+
+/**
+ * The default destructor.
+ */
+LodScheduler::~LodScheduler()
+{
+}
+
+/**
+ * Changes distance from players beyond which objects are far.
+ * @param distance horizontal distance, 0 makes every object near
+ * @return void
+ */
+void LodScheduler::setDistance(double distance)
+{
+    this->distance = std::max(distance, 0.0);
+}
+
+/**
+ * Get distance from players beyond which objects are far.
+ * @return double
+ */
+double LodScheduler::getDistance() const
+{
+    return distance;
+}
+
+/**
+ * Changes number of steps between coarse steps of far objects.
+ * @param ticks number of steps, 0 or 1 updates far objects every step
+ * @return void
+ */
+void LodScheduler::setPeriod(unsigned ticks)
+{
+    period = std::max(ticks, 1u);
+}
+
+/**
+ * Get number of steps between coarse steps of far objects.
+ * @return unsigned
+ */
+unsigned LodScheduler::getPeriod() const
+{
+    return period;
+}
+
+/**
+ * Finds horizontal span of every PlayerCreature that distance is measured from.
+ * Every object is near if there is no PlayerCreature.
+ * @param world reference to World that holds all game objects
+ * @return void
+ */
+void LodScheduler::setFocus(World const& world)
+{
+    hasFocus = false;
+    world.players.forEach([this](PlayerCreature const* player)
+    {
+        if (player->getDestroyed())
+            return;
+        double left = player->getX();
+        double right = player->getX() + player->getWidth();
+        focusLeft = hasFocus ? std::min(focusLeft, left) : left;
+        focusRight = hasFocus ? std::max(focusRight, right) : right;
+        hasFocus = true;
+    });
+}
+
+/**
+ * Check if object is far from every PlayerCreature.
+ * @param object a constant pointer to object
+ * @return bool
+ */
+bool LodScheduler::isFar(SolidObject const* object) const
+{
+    if (distance == 0.0 || period == 1 || !hasFocus)
+        return false;
+    return object->getX() + object->getWidth() < focusLeft - distance || object->getX() > focusRight + distance;
+}
+
+/**
+ * Check if far object takes a coarse step in any of steps in range (from, to].
+ * Object with a key takes its coarse steps in steps whose number plus key is divisible by period.
+ * @param key schedule key of object, see Creature::getScheduleKey
+ * @param from number of step after which range starts
+ * @param to number of last step of range
+ * @return bool
+ */
+bool LodScheduler::isDue(unsigned key, Uint32 from, Uint32 to) const
+{
+    Uint32 offset = key % period;
+    return (to + offset) / period != (from + offset) / period;
+}
@@ -0,0 +1,108 @@
+#ifndef LODSCHEDULER_H
+#define LODSCHEDULER_H
+
+#include "SolidObject.h"
+#include <SDL_stdinc.h>
+
+class World;
+
+/**
+ * LodScheduler decides how often Creatures far from players are simulated and controlled.
+ * Objects farther than a set horizontal distance from every PlayerCreature are far, others are near.
+ * Near objects are updated every step. Far objects are updated only once every period steps, in a single coarse step that catches up the skipped time.
+ * Coarse steps of far objects are spread over steps by their schedule keys, so every step updates about the same share of them.
+ * Keys are given by World in order of creation within a level, so schedule depends only on positions, keys and count of steps
+ * and runs with the same input are updated the same way.
+ * @see Physics
+ */
+class LodScheduler
+{
+public:
+    /**
+     * The default constructor. Every object is near until distance is set.
+     */
+    LodScheduler();
+
+    /**
+     * The default destructor.
+     */
+    ~LodScheduler();
+
+    /**
+     * Changes distance from players beyond which objects are far.
+     * @param distance horizontal distance, 0 makes every object near
+     * @return void
+     */
+    void setDistance(double distance);
+
+    /**
+     * Get distance from players beyond which objects are far.
+     * @return double
+     */
+    double getDistance() const;
+
+    /**
+     * Changes number of steps between coarse steps of far objects.
+     * @param ticks number of steps, 0 or 1 updates far objects every step
+     * @return void
+     */
+    void setPeriod(unsigned ticks);
+
+    /**
+     * Get number of steps between coarse steps of far objects.
+     * @return unsigned
+     */
+    unsigned getPeriod() const;
+
+    /**
+     * Finds horizontal span of every PlayerCreature that distance is measured from.
+     * Every object is near if there is no PlayerCreature.
+     * @param world reference to World that holds all game objects
+     * @return void
+     */
+    void setFocus(World const& world);
+
+    /**
+     * Check if object is far from every PlayerCreature.
+     * @param object a constant pointer to object
+     * @return bool
+     */
+    bool isFar(SolidObject const* object) const;
+
+    /**
+     * Check if far object takes a coarse step in any of steps in range (from, to].
+     * @param key schedule key of object, see Creature::getScheduleKey
+     * @param from number of step after which range starts
+     * @param to number of last step of range
+     * @return bool
+     */
+    bool isDue(unsigned key, Uint32 from, Uint32 to) const;
+
+private:
+    /**
+     * Distance from players beyond which objects are far, 0 if every object is near.
+     */
+    double distance;
+
+    /**
+     * Number of steps between coarse steps of far objects.
+     */
+    unsigned period;
+
+    /**
+     * True if there is a PlayerCreature to measure distance from.
+     */
+    bool hasFocus;
+
+    /**
+     * Left edge of span of players.
+     */
+    double focusLeft;
+
+    /**
+     * Right edge of span of players.
+     */
+    double focusRight;
+};
+
+#endif // LODSCHEDULER_H
@@ -0,0 +1,121 @@
+#include "MappedFile.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * MappedFile implementation
+ */
+
+/**
+ * The default constructor. No file is open.
+ */
+MappedFile::MappedFile() :
+    data(nullptr),
+    size(0)
+#ifdef _WIN32
+    , mapping(nullptr)
+#endif
+{
+}
+
+/**
+ * The default destructor. Unmaps file.
+ */
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+/**
+ * Maps file into memory. Previously mapped file is unmapped.
+ * Empty files can't be mapped.
+ * @param path path to file
+ * @return bool true if file was mapped
+ */
+bool MappedFile::open(char const* path)
+{
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+        return false;
+    data = static_cast<unsigned char const*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr)
+    {
+        CloseHandle(mapping);
+        mapping = nullptr;
+        return false;
+    }
+    size = size_t(fileSize.QuadPart);
+#else
+    int file = ::open(path, O_RDONLY);
+    if (file < 0)
+        return false;
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        ::close(file);
+        return false;
+    }
+    void* mapped = mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (mapped == MAP_FAILED)
+        return false;
+    data = static_cast<unsigned char const*>(mapped);
+    size = size_t(status.st_size);
+#endif
+    return true;
+}
+
+/**
+ * Unmaps file.
+ * @return void
+ */
+void MappedFile::close()
+{
+    if (data == nullptr)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(mapping);
+    mapping = nullptr;
+#else
+    munmap(const_cast<unsigned char*>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+/**
+ * Get mapped contents of file.
+ * @return unsigned char const* a pointer to first byte or nullptr if no file is open
+ */
+unsigned char const* MappedFile::getData() const
+{
+    return data;
+}
+
+/**
+ * Get size of mapped file.
+ * @return size_t size in bytes
+ */
+size_t MappedFile::getSize() const
+{
+    return size;
+}
@@ -0,0 +1,77 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+
+/**
+ * MappedFile maps a whole file into memory for reading.
+ * Pages are loaded by operating system on first access, so nothing is copied when file is opened.
+ */
+class MappedFile
+{
+public:
+    /**
+     * The default constructor. No file is open.
+     */
+    MappedFile();
+
+    /**
+     * The default destructor. Unmaps file.
+     */
+    ~MappedFile();
+
+    /**
+     * Maps file into memory. Previously mapped file is unmapped.
+     * @param path path to file
+     * @return bool true if file was mapped
+     */
+    bool open(char const* path);
+
+    /**
+     * Unmaps file.
+     * @return void
+     */
+    void close();
+
+    /**
+     * Get mapped contents of file.
+     * @return unsigned char const* a pointer to first byte or nullptr if no file is open
+     */
+    unsigned char const* getData() const;
+
+    /**
+     * Get size of mapped file.
+     * @return size_t size in bytes
+     */
+    size_t getSize() const;
+
+    /**
+     * Copy constructor is deleted because mapping can't be shared.
+     */
+    MappedFile(MappedFile const&) = delete;
+
+    /**
+     * Assignment operator is deleted because mapping can't be shared.
+     */
+    MappedFile& operator=(MappedFile const&) = delete;
+
+private:
+    /**
+     * Mapped contents of file.
+     */
+    unsigned char const* data;
+
+    /**
+     * Size of mapped file in bytes.
+     */
+    size_t size;
+
+#ifdef _WIN32
+    /**
+     * Handle of file mapping object.
+     */
+    void* mapping;
+#endif
+};
+
+#endif // MAPPEDFILE_H
@@ -17,6 +17,7 @@
 MonsterCreature::MonsterCreature(double x, double y, double width, double height, Uint8 health) :
     Creature(x, y, width, height, health)
 {
+    setKind(ObjectKind::Monster);
     SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "MonsterCreature created!");
 }
 
@@ -29,22 +30,16 @@ MonsterCreature::~MonsterCreature()
 }
 
 /**
- * Function for resolving special cases of collision.
- * If special case is not found, function calls Creature implementation of onCollision.
- * @param collider a pointer to a SolidObject with which MonsterCreature is colliding
+ * Hurts touched PlayerCreature.
+ * @param player a pointer to touched PlayerCreature
  * @return void
+ * @see CollisionDispatcher
  */
-void MonsterCreature::onCollision(SolidObject* collider)
+void MonsterCreature::attack(PlayerCreature* player)
 {
-	PlayerCreature* tmpPlayerCreature = dynamic_cast<PlayerCreature*>(collider);
-	if (tmpPlayerCreature != nullptr)
-	{
-		//some debug messages
-		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION,"I'm a generic monster!");
-        SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "HurtCollision: ME: X:%f Y:%f HIM: X:%f Y:%f\n", x, y, tmpPlayerCreature->getX(), tmpPlayerCreature->getY());
+	//some debug messages
+	SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION,"I'm a generic monster!");
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "HurtCollision: ME: X:%f Y:%f HIM: X:%f Y:%f\n", x, y, player->getX(), player->getY());
 
-		tmpPlayerCreature->hurt(1);
-		return;
-	}
-	Creature::onCollision(collider);
+	player->hurt(1);
 }
\ No newline at end of file
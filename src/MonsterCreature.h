@@ -3,6 +3,8 @@
 
 #include "Creature.h"
 
+class PlayerCreature;
+
 /**
  * MonsterCreature is a Creature that should be AI controlled as it hurts PlayerCreature.
  * It derives from Creature.
@@ -29,12 +31,17 @@ public:
 	~MonsterCreature();
 
     /**
-     * Function for resolving special cases of collision.
-     * If special case is not found, function calls Creature implementation of onCollision.
-     * @param collider a pointer to a SolidObject with which MonsterCreature is colliding
+     * Kind of objects of this class.
+     */
+    static const ObjectKind staticKind = ObjectKind::Monster;
+
+    /**
+     * Hurts touched PlayerCreature.
+     * @param player a pointer to touched PlayerCreature
      * @return void
+     * @see CollisionDispatcher
      */
-    void onCollision(SolidObject* collider) override;
+    void attack(PlayerCreature* player);
 
     /**
      * Assignment operator is deleted because of constant member initialized on Construction.
@@ -0,0 +1,408 @@
+#include "NavGraph.h"
+#include "GameDefs.h"
+#include <SDL_log.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+/**
+ * NavGraph implementation
+ */
+
+/**
+ * The default constructor. Graph is empty.
+ */
+NavGraph::NavGraph() :
+    gridLeft(0.0),
+    useCount(0)
+{
+}
+
+/**
+ * The default destructor.
+ */
+NavGraph::~NavGraph()
+{
+}
+
+/**
+ * Builds graph from boxes of solid objects of level, replacing previous one.
+ * Graphs up to GameDefinitions::navTableSegments segments have their whole table of next links built right away.
+ * @param boxes boxes of every solid object of level
+ * @return void
+ */
+void NavGraph::build(std::vector<LevelBox> boxes)
+{
+    clear();
+    std::stable_sort(boxes.begin(), boxes.end(), [](LevelBox const& a, LevelBox const& b){ return a.x < b.x; });
+    findSegments(boxes);
+    buildGrid();
+    findLinks();
+
+    reverseStarts.assign(segments.size() + 1, 0);
+    for (size_t i = 0; i < links.size(); ++i)
+        ++reverseStarts[links[i].target + 1];
+    for (size_t i = 1; i < reverseStarts.size(); ++i)
+        reverseStarts[i] += reverseStarts[i - 1];
+    reverseLinks.resize(links.size());
+    std::vector<Uint32> next(reverseStarts.begin(), reverseStarts.end() - 1);
+    for (size_t i = 0; i < links.size(); ++i)
+        reverseLinks[next[links[i].target]++] = Uint32(i);
+
+    cachedSlots.assign(segments.size() * 2, noSegment);
+    if (segments.size() <= GameDefinitions::navTableSegments)
+    {
+        rows.resize(segments.size());
+        for (Uint32 i = 0; i < segments.size(); ++i)
+            buildRow(i, true, rows[i]);
+    }
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Navigation graph has %u segments and %u links", unsigned(segments.size()), unsigned(links.size()));
+}
+
+/**
+ * Forgets graph.
+ * @return void
+ */
+void NavGraph::clear()
+{
+    segments.clear();
+    links.clear();
+    reverseStarts.clear();
+    reverseLinks.clear();
+    gridLeft = 0.0;
+    cellStarts.clear();
+    cellSegments.clear();
+    rows.clear();
+    cachedRows.clear();
+    cachedSlots.clear();
+    useCount = 0;
+}
+
+/**
+ * Get number of segments.
+ * @return size_t
+ */
+size_t NavGraph::getSegmentCount() const
+{
+    return segments.size();
+}
+
+/**
+ * Get a segment.
+ * @param segment index of segment, less than getSegmentCount()
+ * @return Segment const&
+ */
+NavGraph::Segment const& NavGraph::getSegment(Uint32 segment) const
+{
+    return segments[segment];
+}
+
+/**
+ * Finds highest segment under a point, where a Creature standing or falling there is or lands.
+ * Only segments of the cell that holds the point are tested.
+ * @param x horizontal position, center of Creature
+ * @param y height, feet of Creature
+ * @return Uint32 index of segment, noSegment if there's nothing under point
+ */
+Uint32 NavGraph::findSegment(double x, double y) const
+{
+    if (cellStarts.empty() || x < gridLeft)
+        return noSegment;
+    size_t cell = size_t((x - gridLeft) / GameDefinitions::navCellWidth);
+    if (cell + 1 >= cellStarts.size())
+        return noSegment;
+    Uint32 found = noSegment;
+    for (Uint32 i = cellStarts[cell]; i < cellStarts[cell + 1]; ++i)
+    {
+        Segment const& segment = segments[cellSegments[i]];
+        if (segment.left <= x && x <= segment.right && segment.y >= y - GameDefinitions::navStandTolerance &&
+            (found == noSegment || segment.y < segments[found].y))
+            found = cellSegments[i];
+    }
+    return found;
+}
+
+/**
+ * Get first link of shortest path between segments. Not thread-safe, because a missing row is built into cache.
+ * Rows of small graphs are read from table built with graph, others come from cache.
+ * @param from index of segment path starts at
+ * @param to index of segment path ends at
+ * @param jumps false to find paths made only of falls, for Creatures that can't jump. Defaults to true
+ * @return Link const* a constant pointer to link, nullptr if segments are equal or to can't be reached
+ */
+NavGraph::Link const* NavGraph::getNextLink(Uint32 from, Uint32 to, bool jumps) const
+{
+    if (from >= segments.size() || to >= segments.size() || from == to)
+        return nullptr;
+    Uint16 hop = jumps && !rows.empty() ? rows[to][from] : getRow(to, jumps)[from];
+    return hop != 0xFFFF ? &links[segments[from].firstLink + hop] : nullptr;
+}
+
+/**
+ * Finds shortest path between segments, in time proportional to its length. Not thread-safe, because a missing row is built into cache.
+ * @param from index of segment path starts at
+ * @param to index of segment path ends at
+ * @param path list that is filled with segments of path, from first to last, empty if to can't be reached
+ * @param jumps false to find paths made only of falls, for Creatures that can't jump. Defaults to true
+ * @return bool true if to can be reached
+ */
+bool NavGraph::findPath(Uint32 from, Uint32 to, std::vector<Uint32>& path, bool jumps) const
+{
+    path.clear();
+    if (from >= segments.size() || to >= segments.size())
+        return false;
+    path.push_back(from);
+    while (from != to)
+    {
+        Link const* link = getNextLink(from, to, jumps);
+        if (link == nullptr)
+        {
+            path.clear();
+            return false;
+        }
+        from = link->target;
+        path.push_back(from);
+    }
+    return true;
+}
+
+/**
+ * Get row of table of next links towards a segment, built into cache first if it's missing.
+ * Least recently used row is dropped when cache is full, its memory is reused by the new row.
+ * @param target index of segment
+ * @param jumps false for row of paths made only of falls
+ * @return std::vector<Uint16> const& row
+ */
+std::vector<Uint16> const& NavGraph::getRow(Uint32 target, bool jumps) const
+{
+    Uint32 key = target * 2 + (jumps ? 0 : 1);
+    Uint32 slot = cachedSlots[key];
+    if (slot == noSegment)
+    {
+        if (cachedRows.size() < GameDefinitions::navCachedRows)
+        {
+            slot = Uint32(cachedRows.size());
+            cachedRows.push_back(CachedRow());
+        }
+        else
+        {
+            slot = 0;
+            for (Uint32 i = 1; i < cachedRows.size(); ++i)
+                if (cachedRows[i].lastUse < cachedRows[slot].lastUse)
+                    slot = i;
+            cachedSlots[cachedRows[slot].key] = noSegment;
+        }
+        cachedRows[slot].key = key;
+        buildRow(target, jumps, cachedRows[slot].row);
+        cachedSlots[key] = slot;
+    }
+    cachedRows[slot].lastUse = ++useCount;
+    return cachedRows[slot].row;
+}
+
+/**
+ * Builds row of table of next links towards a segment by searching from it over reversed links.
+ * Search is Dijkstra's, ties are broken by index of segment, so every build gives the same row.
+ * @param target index of segment
+ * @param jumps false to skip jump links
+ * @param row list that is filled with row
+ * @return void
+ */
+void NavGraph::buildRow(Uint32 target, bool jumps, std::vector<Uint16>& row) const
+{
+    typedef std::pair<double, Uint32> Entry;
+    row.assign(segments.size(), 0xFFFF);
+    std::vector<double> distance(segments.size(), std::numeric_limits<double>::infinity());
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+    distance[target] = 0.0;
+    queue.push(Entry(0.0, target));
+    while (!queue.empty())
+    {
+        Entry entry = queue.top();
+        queue.pop();
+        if (entry.first > distance[entry.second])
+            continue;
+        for (Uint32 i = reverseStarts[entry.second]; i < reverseStarts[entry.second + 1]; ++i)
+        {
+            Link const& link = links[reverseLinks[i]];
+            if (!jumps && link.type == NavLinkType::Jump)
+                continue;
+            double through = entry.first + link.cost;
+            if (through < distance[link.source])
+            {
+                distance[link.source] = through;
+                row[link.source] = Uint16(reverseLinks[i] - segments[link.source].firstLink);
+                queue.push(Entry(through, link.source));
+            }
+        }
+    }
+}
+
+/**
+ * Finds walkable surfaces: tops of boxes at equal height are merged, parts without headroom are cut out.
+ * Tops are joined over gaps narrower than GameDefinitions::navMergeGap, Creatures walk over them.
+ * A part has no headroom if a box reaches into GameDefinitions::navClearance above it, pieces narrower than
+ * GameDefinitions::navMinWidth are dropped.
+ * @param boxes boxes of solid objects sorted by left edge
+ * @return void
+ */
+void NavGraph::findSegments(std::vector<LevelBox> const& boxes)
+{
+    float maxWidth = 0.0f;
+    for (size_t i = 0; i < boxes.size(); ++i)
+        maxWidth = std::max(maxWidth, boxes[i].width);
+
+    std::vector<LevelBox> tops(boxes);
+    std::stable_sort(tops.begin(), tops.end(), [](LevelBox const& a, LevelBox const& b){ return a.y < b.y || (a.y == b.y && a.x < b.x); });
+    std::vector<std::pair<double, double> > blocked;
+    for (size_t i = 0; i < tops.size();)
+    {
+        double y = tops[i].y;
+        double left = tops[i].x;
+        double right = tops[i].x + tops[i].width;
+        for (++i; i < tops.size() && tops[i].y == tops[i - 1].y && tops[i].x - right < GameDefinitions::navMergeGap; ++i)
+            right = std::max(right, double(tops[i].x + tops[i].width));
+
+        //boxes are sorted by left edge, so only those starting less than widest box before surface can reach into it
+        blocked.clear();
+        std::vector<LevelBox>::const_iterator it = std::lower_bound(boxes.begin(), boxes.end(), float(left - maxWidth),
+            [](LevelBox const& box, float x){ return box.x < x; });
+        for (; it != boxes.end() && it->x < right; ++it)
+            if (it->x + it->width > left && it->y < y && it->y + it->height > y - GameDefinitions::navClearance)
+                blocked.push_back(std::make_pair(std::max(left, double(it->x)), std::min(right, double(it->x + it->width))));
+        std::sort(blocked.begin(), blocked.end());
+
+        double free = left;
+        for (size_t j = 0; j <= blocked.size(); ++j)
+        {
+            double end = j < blocked.size() ? blocked[j].first : right;
+            if (end - free >= GameDefinitions::navMinWidth)
+            {
+                Segment segment = { free, end, y, 0, 0 };
+                segments.push_back(segment);
+            }
+            if (j < blocked.size())
+                free = std::max(free, blocked[j].second);
+        }
+    }
+}
+
+/**
+ * Sorts segments into cells of grid that findSegment and findLinks look up.
+ * Grid spans from leftmost to rightmost end of segments, a segment is in every cell it reaches into.
+ * @return void
+ */
+void NavGraph::buildGrid()
+{
+    if (segments.empty())
+        return;
+    double left = segments[0].left;
+    double right = segments[0].right;
+    for (size_t i = 1; i < segments.size(); ++i)
+    {
+        left = std::min(left, segments[i].left);
+        right = std::max(right, segments[i].right);
+    }
+    gridLeft = left;
+    size_t cellCount = size_t((right - left) / GameDefinitions::navCellWidth) + 1;
+    auto cellOf = [this, cellCount](double x){ return std::min(size_t((x - gridLeft) / GameDefinitions::navCellWidth), cellCount - 1); };
+
+    cellStarts.assign(cellCount + 1, 0);
+    for (size_t i = 0; i < segments.size(); ++i)
+        for (size_t cell = cellOf(segments[i].left); cell <= cellOf(segments[i].right); ++cell)
+            ++cellStarts[cell + 1];
+    for (size_t i = 1; i < cellStarts.size(); ++i)
+        cellStarts[i] += cellStarts[i - 1];
+    cellSegments.resize(cellStarts.back());
+    std::vector<Uint32> next(cellStarts.begin(), cellStarts.end() - 1);
+    for (size_t i = 0; i < segments.size(); ++i)
+        for (size_t cell = cellOf(segments[i].left); cell <= cellOf(segments[i].right); ++cell)
+            cellSegments[next[cell]++] = Uint32(i);
+}
+
+/**
+ * Finds jumps and falls between every pair of segments in reach of each other.
+ * Walking off an edge lands on highest segment below it within GameDefinitions::navFallReach.
+ * Jumps reach segments up to GameDefinitions::navJumpHeight higher across gaps up to GameDefinitions::navJumpDistance,
+ * they start GameDefinitions::navTakeoffRun before target but no closer than GameDefinitions::navEdgeMargin to ends of segment.
+ * Lower segments under a segment are only reached by falling.
+ * @return void
+ */
+void NavGraph::findLinks()
+{
+    double reach = std::max(GameDefinitions::navJumpDistance, GameDefinitions::navFallReach) + GameDefinitions::navTakeoffRun;
+    std::vector<Uint32> candidates;
+    for (Uint32 a = 0; a < segments.size(); ++a)
+    {
+        Segment const from = segments[a];
+        double center = (from.left + from.right) / 2;
+        segments[a].firstLink = Uint32(links.size());
+        candidates.clear();
+        querySegments(from.left - reach, from.right + reach, candidates);
+
+        auto addLink = [this, &from, a, center](Uint32 b, double x, double direction, NavLinkType type)
+        {
+            Segment const& to = segments[b];
+            Link link = { a, b, x, direction, std::fabs(x - center) + std::fabs((to.left + to.right) / 2 - x) + std::fabs(from.y - to.y), type };
+            links.push_back(link);
+        };
+
+        //take-off points stay away from ends, segments too narrow for that take off at their center
+        double takeoffLeft = std::min(from.left + GameDefinitions::navEdgeMargin, center);
+        double takeoffRight = std::max(from.right - GameDefinitions::navEdgeMargin, center);
+        Uint32 fallLeft = noSegment;
+        Uint32 fallRight = noSegment;
+        for (size_t i = 0; i < candidates.size(); ++i)
+        {
+            Segment const& to = segments[candidates[i]];
+            if (to.y <= from.y)
+                continue;
+            if (to.left < from.left && to.right > from.left - GameDefinitions::navFallReach && (fallLeft == noSegment || to.y < segments[fallLeft].y))
+                fallLeft = candidates[i];
+            if (to.right > from.right && to.left < from.right + GameDefinitions::navFallReach && (fallRight == noSegment || to.y < segments[fallRight].y))
+                fallRight = candidates[i];
+        }
+        if (fallLeft != noSegment)
+            addLink(fallLeft, from.left - GameDefinitions::navMinWidth, -1.0, NavLinkType::Fall);
+        if (fallRight != noSegment)
+            addLink(fallRight, from.right + GameDefinitions::navMinWidth, 1.0, NavLinkType::Fall);
+
+        for (size_t i = 0; i < candidates.size() && links.size() - segments[a].firstLink < 0xFFFF; ++i)
+        {
+            Uint32 b = candidates[i];
+            Segment const& to = segments[b];
+            double gap = std::max(0.0, std::max(to.left - from.right, from.left - to.right));
+            if (b == a || b == fallLeft || b == fallRight || from.y - to.y > GameDefinitions::navJumpHeight ||
+                gap > GameDefinitions::navJumpDistance || (to.y >= from.y && gap == 0.0))
+                continue;
+            if (to.left + to.right >= from.left + from.right)
+                addLink(b, std::min(std::max(takeoffLeft, to.left - GameDefinitions::navTakeoffRun), takeoffRight), 1.0, NavLinkType::Jump);
+            else
+                addLink(b, std::max(std::min(takeoffRight, to.right + GameDefinitions::navTakeoffRun), takeoffLeft), -1.0, NavLinkType::Jump);
+        }
+        segments[a].linkCount = Uint32(links.size()) - segments[a].firstLink;
+    }
+}
+
+/**
+ * Appends every segment that reaches into cells overlapping range, each of them once and in order of index.
+ * @param left left end of range
+ * @param right right end of range
+ * @param result list to which segments are appended
+ * @return void
+ */
+void NavGraph::querySegments(double left, double right, std::vector<Uint32>& result) const
+{
+    if (cellStarts.empty())
+        return;
+    size_t cellCount = cellStarts.size() - 1;
+    size_t first = left <= gridLeft ? 0 : std::min(size_t((left - gridLeft) / GameDefinitions::navCellWidth), cellCount - 1);
+    size_t last = right <= gridLeft ? 0 : std::min(size_t((right - gridLeft) / GameDefinitions::navCellWidth), cellCount - 1);
+    size_t begin = result.size();
+    result.insert(result.end(), cellSegments.begin() + cellStarts[first], cellSegments.begin() + cellStarts[last + 1]);
+    std::sort(result.begin() + begin, result.end());
+    result.erase(std::unique(result.begin() + begin, result.end()), result.end());
+}
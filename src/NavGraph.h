@@ -0,0 +1,244 @@
+#ifndef NAVGRAPH_H
+#define NAVGRAPH_H
+
+#include "LevelFile.h"
+#include <vector>
+
+/**
+ * Value of segment of NavGraph that means there's none.
+ */
+Uint32 const noSegment = 0xFFFFFFFF;
+
+/**
+ * The ways a Creature can move from one segment of NavGraph to another.
+ * @see NavGraph
+ */
+enum class NavLinkType : Uint8
+{
+    /**
+     * Creature jumps at take-off point.
+     */
+    Jump,
+
+    /**
+     * Creature walks off edge of segment and falls.
+     */
+    Fall
+};
+
+/**
+ * NavGraph is a navigation graph of static level geometry, built once when level is loaded.
+ * Its nodes are walkable segments: tops of solid objects merged where they meet, with parts that have no headroom cut out.
+ * Its links are jumps to segments in reach and falls from edges of segments to segments below them.
+ * Every segment keeps next link towards every other segment, so following a path takes constant time per link.
+ * Small graphs have the whole table built with graph. Other rows, including ones of paths without jumps, are built when a target is first asked for
+ * and kept in a cache of GameDefinitions::navCachedRows rows that drops the least recently used one, so memory stays bounded on big levels.
+ * Queries may build a row, so a graph can be queried by a single thread at a time.
+ * @see BehaviorController
+ */
+class NavGraph
+{
+public:
+    /**
+     * Segment is a struct that holds a walkable surface.
+     */
+    struct Segment
+    {
+        double left;      // left end
+        double right;     // right end
+        double y;         // height of surface, where feet of Creature are
+        Uint32 firstLink; // index of first outgoing link
+        Uint32 linkCount; // number of outgoing links
+    };
+
+    /**
+     * Link is a struct that holds a way to get from a segment to another one.
+     */
+    struct Link
+    {
+        Uint32 source;    // segment link leaves
+        Uint32 target;    // segment link leads to
+        double x;         // take-off point, where center of Creature leaves segment
+        double direction; // -1 if link leads left, 1 if it leads right
+        double cost;      // distance travelled
+        NavLinkType type; // way Creature moves
+    };
+
+    /**
+     * The default constructor. Graph is empty.
+     */
+    NavGraph();
+
+    /**
+     * The default destructor.
+     */
+    ~NavGraph();
+
+    /**
+     * Builds graph from boxes of solid objects of level, replacing previous one.
+     * @param boxes boxes of every solid object of level
+     * @return void
+     */
+    void build(std::vector<LevelBox> boxes);
+
+    /**
+     * Forgets graph.
+     * @return void
+     */
+    void clear();
+
+    /**
+     * Get number of segments.
+     * @return size_t
+     */
+    size_t getSegmentCount() const;
+
+    /**
+     * Get a segment.
+     * @param segment index of segment, less than getSegmentCount()
+     * @return Segment const&
+     */
+    Segment const& getSegment(Uint32 segment) const;
+
+    /**
+     * Finds highest segment under a point, where a Creature standing or falling there is or lands.
+     * @param x horizontal position, center of Creature
+     * @param y height, feet of Creature
+     * @return Uint32 index of segment, noSegment if there's nothing under point
+     */
+    Uint32 findSegment(double x, double y) const;
+
+    /**
+     * Get first link of shortest path between segments. Not thread-safe, because a missing row is built into cache.
+     * @param from index of segment path starts at
+     * @param to index of segment path ends at
+     * @param jumps false to find paths made only of falls, for Creatures that can't jump. Defaults to true
+     * @return Link const* a constant pointer to link, nullptr if segments are equal or to can't be reached
+     */
+    Link const* getNextLink(Uint32 from, Uint32 to, bool jumps = true) const;
+
+    /**
+     * Finds shortest path between segments, in time proportional to its length. Not thread-safe, because a missing row is built into cache.
+     * @param from index of segment path starts at
+     * @param to index of segment path ends at
+     * @param path list that is filled with segments of path, from first to last, empty if to can't be reached
+     * @param jumps false to find paths made only of falls, for Creatures that can't jump. Defaults to true
+     * @return bool true if to can be reached
+     */
+    bool findPath(Uint32 from, Uint32 to, std::vector<Uint32>& path, bool jumps = true) const;
+
+private:
+    /**
+     * Walkable segments, sorted by height and then by left end.
+     */
+    std::vector<Segment> segments;
+
+    /**
+     * Outgoing links of every segment, links of a segment are next to each other.
+     */
+    std::vector<Link> links;
+
+    /**
+     * Index of first entry of every segment in reverseLinks, followed by end of last segment.
+     */
+    std::vector<Uint32> reverseStarts;
+
+    /**
+     * Links that lead to every segment, used to search paths backwards from their target.
+     */
+    std::vector<Uint32> reverseLinks;
+
+    /**
+     * Left end of first cell of grid.
+     */
+    double gridLeft;
+
+    /**
+     * Index of first entry of every cell in cellSegments, followed by end of last cell.
+     */
+    std::vector<Uint32> cellStarts;
+
+    /**
+     * Segments that reach into every cell of grid.
+     */
+    std::vector<Uint32> cellSegments;
+
+    /**
+     * CachedRow is a struct that holds a row of table of next links built on first use.
+     */
+    struct CachedRow
+    {
+        Uint32 key;              // target segment times two, plus one if path has no jumps
+        Uint32 lastUse;          // value of useCount when row was last asked for
+        std::vector<Uint16> row; // row of table
+    };
+
+    /**
+     * Rows of table of next links, one per target segment, built with small graphs only.
+     * Row holds, for every segment, index of its link towards target among its own links, or 0xFFFF.
+     */
+    std::vector<std::vector<Uint16> > rows;
+
+    /**
+     * Rows that weren't built with graph, at most GameDefinitions::navCachedRows of them.
+     */
+    mutable std::vector<CachedRow> cachedRows;
+
+    /**
+     * Index in cachedRows of row of every key, noSegment if it isn't cached.
+     */
+    mutable std::vector<Uint32> cachedSlots;
+
+    /**
+     * Number of times a cached row was asked for, orders cached rows by their last use.
+     */
+    mutable Uint32 useCount;
+
+    /**
+     * Get row of table of next links towards a segment, built into cache first if it's missing.
+     * Least recently used row is dropped when cache is full.
+     * @param target index of segment
+     * @param jumps false for row of paths made only of falls
+     * @return std::vector<Uint16> const& row
+     */
+    std::vector<Uint16> const& getRow(Uint32 target, bool jumps) const;
+
+    /**
+     * Builds row of table of next links towards a segment by searching from it over reversed links.
+     * @param target index of segment
+     * @param jumps false to skip jump links
+     * @param row list that is filled with row
+     * @return void
+     */
+    void buildRow(Uint32 target, bool jumps, std::vector<Uint16>& row) const;
+
+    /**
+     * Finds walkable surfaces: tops of boxes at equal height are merged, parts without headroom are cut out.
+     * @param boxes boxes of solid objects sorted by left edge
+     * @return void
+     */
+    void findSegments(std::vector<LevelBox> const& boxes);
+
+    /**
+     * Sorts segments into cells of grid that findSegment and findLinks look up.
+     * @return void
+     */
+    void buildGrid();
+
+    /**
+     * Finds jumps and falls between every pair of segments in reach of each other.
+     * @return void
+     */
+    void findLinks();
+
+    /**
+     * Appends every segment that reaches into cells overlapping range, each of them once and in order of index.
+     * @param left left end of range
+     * @param right right end of range
+     * @param result list to which segments are appended
+     * @return void
+     */
+    void querySegments(double left, double right, std::vector<Uint32>& result) const;
+};
+
+#endif // NAVGRAPH_H
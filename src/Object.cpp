@@ -1,9 +1,13 @@
 #include "Object.h"
+#include "Snapshot.h"
+#include "DirtySet.h"
 
 /**
  * Object implementation
  */
 
+unsigned Object::nextId = 1;
+
 /**
  * The default constructor of Object.
  * @param x X position of Object. Defaults to 0.0
@@ -18,8 +22,14 @@ Object::Object(double x, double y, double width, double height) :
 	height(height),
 	prevX(x),
 	prevY(y),
-	destroyed(false)
+	destroyed(false),
+    id(nextId++),
+    dirtySet(nullptr),
+    dirtyIndex(DirtySet::noIndex),
+    kind(ObjectKind::Object),
+    kindMask(0)
 {
+    setKind(ObjectKind::Object);
 }
 
 /**
@@ -39,6 +49,43 @@ void Object::savePrevious()
     prevY = y;
 }
 
+/**
+ * Appends state of Object to snapshot. Derived classes append their own state after state of their base.
+ * @param snapshot Snapshot that state is appended to
+ * @return void
+ * @see Snapshot
+ */
+void Object::saveState(Snapshot& snapshot) const
+{
+    snapshot.write(id);
+    snapshot.write(x);
+    snapshot.write(y);
+    snapshot.write(width);
+    snapshot.write(height);
+    snapshot.write(prevX);
+    snapshot.write(prevY);
+    snapshot.write(destroyed);
+}
+
+/**
+ * Reads state of Object appended by saveState, including its identifier.
+ * Restored Object takes identifier of saved one, so everything that refers to it by identifier keeps working.
+ * @param snapshot Snapshot that state is read from
+ * @return void
+ * @see Snapshot
+ */
+void Object::loadState(Snapshot& snapshot)
+{
+    id = snapshot.read<unsigned>();
+    x = snapshot.read<double>();
+    y = snapshot.read<double>();
+    width = snapshot.read<double>();
+    height = snapshot.read<double>();
+    prevX = snapshot.read<double>();
+    prevY = snapshot.read<double>();
+    destroyed = snapshot.read<bool>();
+}
+
 /**
  * Destroy object by seeting it's destroyed value to true.
  * If object is destroyed, it shouldn't be used.
@@ -47,6 +94,52 @@ void Object::savePrevious()
 void Object::destroy()
 {
     destroyed = true;
+    markChanged(ChangeFlags::Destroyed);
+}
+
+/**
+ * Changes DirtySet that changes of Object are recorded in.
+ * @param dirtySet a pointer to DirtySet or nullptr to stop recording
+ * @return void
+ */
+void Object::setDirtySet(DirtySet* dirtySet)
+{
+    this->dirtySet = dirtySet;
+    dirtyIndex = DirtySet::noIndex;
+}
+
+/**
+ * Records a change of Object in its DirtySet. Object is added to set on its first change since set was cleared.
+ * Only Object itself writes its entry, so objects simulated on different threads can record changes at the same time.
+ * @param flags what has changed
+ * @return void
+ */
+void Object::markChanged(ChangeFlags flags)
+{
+    if (dirtySet == nullptr)
+        return;
+    if (dirtyIndex == DirtySet::noIndex)
+        dirtyIndex = dirtySet->add(this);
+    if (dirtyIndex != DirtySet::noIndex)
+        dirtySet->getEntry(dirtyIndex).flags |= flags;
+}
+
+/**
+ * Forgets that Object is in DirtySet. Called by DirtySet when it's cleared.
+ * @return void
+ */
+void Object::forgetChanges()
+{
+    dirtyIndex = DirtySet::noIndex;
+}
+
+/**
+ * Get index of Object in its DirtySet.
+ * @return size_t index or DirtySet::noIndex if Object hasn't changed since set was cleared
+ */
+size_t Object::getDirtyIndex() const
+{
+    return dirtyIndex;
 }
 
 /**
@@ -111,3 +204,43 @@ bool Object::getDestroyed() const
 {
 	return destroyed;
 }
+
+/**
+ * Get unique identifier of Object.
+ * Unlike address, identifier is never reused by another Object.
+ * @return unsigned
+ */
+unsigned Object::getId() const
+{
+    return id;
+}
+
+/**
+ * Get kind of Object, which is the kind of its most derived class.
+ * @return ObjectKind
+ */
+ObjectKind Object::getKind() const
+{
+    return kind;
+}
+
+/**
+ * Check if Object is of given kind or of a kind derived from it.
+ * @param kind checked kind
+ * @return bool
+ */
+bool Object::isKind(ObjectKind kind) const
+{
+    return (kindMask & (1u << static_cast<unsigned>(kind))) != 0;
+}
+
+/**
+ * Sets kind of Object. Called by constructor of every class, so the last call is made by most derived one.
+ * @param kind kind of constructed class
+ * @return void
+ */
+void Object::setKind(ObjectKind kind)
+{
+    this->kind = kind;
+    kindMask |= 1u << static_cast<unsigned>(kind);
+}
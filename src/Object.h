@@ -1,6 +1,123 @@
 #ifndef OBJECT_H
 #define OBJECT_H
 
+#include <cstddef>
+
+class Snapshot;
+class DirtySet;
+
+/**
+ * Kinds of game objects. Constructor of every class sets its kind, so type of Object can be checked without dynamic_cast.
+ * @see Object
+ */
+enum class ObjectKind
+{
+    /**
+     * Plain Object.
+     */
+    Object,
+
+    /**
+     * SolidObject, static level geometry.
+     */
+    Solid,
+
+    /**
+     * Coin that can be collected by PlayerCreature.
+     */
+    Coin,
+
+    /**
+     * Trigger that fires when touched by PlayerCreature.
+     */
+    Trigger,
+
+    /**
+     * Plain Creature.
+     */
+    Creature,
+
+    /**
+     * PlayerCreature.
+     */
+    Player,
+
+    /**
+     * MonsterCreature.
+     */
+    Monster,
+
+    /**
+     * Number of kinds, not a kind itself.
+     */
+    Count
+};
+
+/**
+ * The types of changes of a game object recorded in DirtySet.
+ * Multiple changes can be combined by treating them as bit fields.
+ * @see DirtySet
+ */
+enum class ChangeFlags : unsigned char
+{
+    /**
+     * Nothing changed.
+     */
+    None = 0x0,
+
+    /**
+     * Object was created.
+     */
+    Created = 0x1,
+
+    /**
+     * Object was moved.
+     */
+    Moved = 0x2,
+
+    /**
+     * Creature was hurt.
+     */
+    Hurt = 0x4,
+
+    /**
+     * Object was destroyed, it's going to be removed.
+     */
+    Destroyed = 0x8,
+
+    /**
+     * Object was removed from World, it can't be used anymore.
+     */
+    Removed = 0x10
+};
+
+/**
+ * OR operator overload so ChangeFlags can be used as a flag field.
+ * @see ChangeFlags
+ */
+inline ChangeFlags operator| (ChangeFlags a, ChangeFlags b)
+{
+    return static_cast<ChangeFlags>(static_cast<int>(a) | static_cast<int>(b));
+}
+
+/**
+ * AND operator overload so ChangeFlags can be used as a flag field.
+ * @see ChangeFlags
+ */
+inline ChangeFlags operator& (ChangeFlags a, ChangeFlags b)
+{
+    return static_cast<ChangeFlags>(static_cast<int>(a) & static_cast<int>(b));
+}
+
+/**
+ * OR assignment operator overload so ChangeFlags can be used as a flag field.
+ * @see ChangeFlags
+ */
+inline ChangeFlags& operator|= (ChangeFlags& a, ChangeFlags b)
+{
+    return a = a | b;
+}
+
 /**
  * Object is a base class for all game objects.
  */
@@ -27,6 +144,23 @@ public:
      */
     virtual void savePrevious();
 
+    /**
+     * Appends state of Object to snapshot. Derived classes append their own state after state of their base.
+     * @param snapshot Snapshot that state is appended to
+     * @return void
+     * @see Snapshot
+     */
+    virtual void saveState(Snapshot& snapshot) const;
+
+    /**
+     * Reads state of Object appended by saveState, including its identifier.
+     * Restored Object takes identifier of saved one, so everything that refers to it by identifier keeps working.
+     * @param snapshot Snapshot that state is read from
+     * @return void
+     * @see Snapshot
+     */
+    virtual void loadState(Snapshot& snapshot);
+
     /**
      * Destroy object by seeting it's destroyed value to true.
      * If object is destroyed, it shouldn't be used.
@@ -34,6 +168,32 @@ public:
      */
     void destroy();
 
+    /**
+     * Changes DirtySet that changes of Object are recorded in.
+     * @param dirtySet a pointer to DirtySet or nullptr to stop recording
+     * @return void
+     */
+    void setDirtySet(DirtySet* dirtySet);
+
+    /**
+     * Records a change of Object in its DirtySet. Object is added to set on its first change since set was cleared.
+     * @param flags what has changed
+     * @return void
+     */
+    void markChanged(ChangeFlags flags);
+
+    /**
+     * Forgets that Object is in DirtySet. Called by DirtySet when it's cleared.
+     * @return void
+     */
+    void forgetChanges();
+
+    /**
+     * Get index of Object in its DirtySet.
+     * @return size_t index or DirtySet::noIndex if Object hasn't changed since set was cleared
+     */
+    size_t getDirtyIndex() const;
+
     /**
      * Get Y position.
      * @return double
@@ -76,7 +236,39 @@ public:
      */
 	bool getDestroyed() const;
 
+    /**
+     * Get unique identifier of Object.
+     * Unlike address, identifier is never reused by another Object.
+     * @return unsigned
+     */
+    unsigned getId() const;
+
+    /**
+     * Get kind of Object, which is the kind of its most derived class.
+     * @return ObjectKind
+     */
+    ObjectKind getKind() const;
+
+    /**
+     * Check if Object is of given kind or of a kind derived from it.
+     * @param kind checked kind
+     * @return bool
+     */
+    bool isKind(ObjectKind kind) const;
+
+    /**
+     * Kind of objects of this class.
+     */
+    static const ObjectKind staticKind = ObjectKind::Object;
+
 protected:
+    /**
+     * Sets kind of Object. Called by constructor of every class, so the last call is made by most derived one.
+     * @param kind kind of constructed class
+     * @return void
+     */
+    void setKind(ObjectKind kind);
+
     /**
      * X position of Object.
      */
@@ -111,7 +303,49 @@ protected:
      * Is object destroyed.
      */
 	bool destroyed;
+
+    /**
+     * Unique identifier of Object. Changed only by loadState.
+     */
+    unsigned id;
+
+    /**
+     * Identifier given to next created Object.
+     */
+    static unsigned nextId;
+
+    /**
+     * DirtySet that changes are recorded in, nullptr if they aren't recorded.
+     */
+    DirtySet* dirtySet;
+
+    /**
+     * Index of Object in DirtySet, DirtySet::noIndex if it hasn't changed since set was cleared.
+     */
+    size_t dirtyIndex;
+
+    /**
+     * Kind of most derived class of Object.
+     */
+    ObjectKind kind;
+
+    /**
+     * Bit mask of kinds of Object and all of its base classes.
+     */
+    unsigned kindMask;
     
 };
 
+/**
+ * Casts Object to given class if Object is of its kind, otherwise returns nullptr.
+ * Cheap replacement of dynamic_cast for classes derived from Object.
+ * @param object a pointer to Object, may be nullptr
+ * @return T* a pointer to casted Object or nullptr
+ */
+template <class T>
+T* objectCast(Object* object)
+{
+    return (object != nullptr && object->isKind(T::staticKind)) ? static_cast<T*>(object) : nullptr;
+}
+
 #endif // OBJECT_H
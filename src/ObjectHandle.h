@@ -0,0 +1,20 @@
+#ifndef OBJECTHANDLE_H
+#define OBJECTHANDLE_H
+
+#include "Object.h"
+#include "ObjectPool.h"
+
+/**
+ * ObjectHandle refers to a game object held by World.
+ * Kind of object selects its pool, so a handle can be kept by code that doesn't know class of object.
+ * A handle of a destroyed object resolves to nullptr instead of dangling.
+ * @see World
+ * @see PoolHandle
+ */
+struct ObjectHandle
+{
+    ObjectKind kind; // kind of object, selects pool
+    PoolHandle slot; // handle in pool
+};
+
+#endif // OBJECTHANDLE_H
@@ -0,0 +1,338 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include "Arena.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * PoolHandle refers to an object in ObjectPool.
+ * Every slot of pool counts how many objects it has held, so a handle of a destroyed object never resolves to an object created later in the same slot.
+ * @see ObjectPool
+ */
+struct PoolHandle
+{
+    unsigned index;      // slot of object
+    unsigned generation; // generation of slot when handle was made
+};
+
+/**
+ * ObjectPool is a slot map that stores objects of a single class in contiguous chunks.
+ * Objects never move, so pointers to them stay valid until they are destroyed, and slots of destroyed objects are reused.
+ * Live objects are listed in a dense array of slots, which is walked by forEach.
+ * Objects are removed in two phases: release queues an object and collect destroys every queued object at once,
+ * taking it out of the dense array with swap-and-pop. Order of iteration isn't kept over removals.
+ * Chunks can be taken from an Arena, in which case clear forgets them, because arena is going to be reset.
+ * @see World
+ * @see Arena
+ */
+template <class T>
+class ObjectPool
+{
+public:
+    /**
+     * The default constructor.
+     * @param arena a pointer to Arena that chunks are taken from. Defaults to nullptr, which means chunks are allocated on heap
+     */
+    ObjectPool(Arena* arena = nullptr) :
+        arena(arena)
+    {
+    }
+
+    /**
+     * The default destructor. Destroys every object.
+     */
+    ~ObjectPool()
+    {
+        clear();
+        if (arena == nullptr)
+            for (size_t i = 0; i < chunks.size(); ++i)
+                delete[] chunks[i];
+    }
+
+    /**
+     * Constructs a new object in a free slot.
+     * @param args arguments passed to constructor of T
+     * @return T* a pointer to created object
+     */
+    template <class... Args>
+    T* create(Args&&... args)
+    {
+        unsigned slot;
+        if (!freeSlots.empty())
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            slot = unsigned(generations.size());
+            generations.push_back(0);
+            denseIndex.push_back(0);
+            queued.push_back(0);
+        }
+        //chunks forgotten by clear are taken again
+        while (chunks.size() <= slot / chunkSize)
+        {
+            if (arena != nullptr)
+                chunks.push_back(static_cast<Slot*>(arena->allocate(sizeof(Slot) * chunkSize, std::alignment_of<Slot>::value)));
+            else
+                chunks.push_back(new Slot[chunkSize]);
+            T const* first = reinterpret_cast<T const*>(chunks.back());
+            chunkOrder.insert(std::upper_bound(chunkOrder.begin(), chunkOrder.end(), first, isBefore), std::make_pair(first, unsigned(chunks.size() - 1)));
+        }
+        T* object = new (&chunks[slot / chunkSize][slot % chunkSize]) T(std::forward<Args>(args)...);
+        denseIndex[slot] = unsigned(dense.size());
+        dense.push_back(slot);
+        if (onCreate)
+            onCreate(object);
+        return object;
+    }
+
+    /**
+     * Changes function called for every object right after it's created.
+     * @param hook function called with a pointer to created object, empty to call nothing
+     * @return void
+     */
+    void setOnCreate(std::function<void(T*)> hook)
+    {
+        onCreate = hook;
+    }
+
+    /**
+     * Get handle of an object of this pool.
+     * Slot is found by binary search over addresses of chunks.
+     * @param object a constant pointer to object
+     * @return PoolHandle
+     */
+    PoolHandle getHandle(T const* object) const
+    {
+        typename std::vector<std::pair<T const*, unsigned> >::const_iterator it = std::upper_bound(chunkOrder.begin(), chunkOrder.end(), object, isBefore);
+        --it;
+        PoolHandle handle;
+        handle.index = unsigned(it->second * chunkSize + (object - it->first));
+        handle.generation = generations[handle.index];
+        return handle;
+    }
+
+    /**
+     * Get object that handle refers to.
+     * @param handle handle of object
+     * @return T* a pointer to object or nullptr if it was destroyed
+     */
+    T* get(PoolHandle handle) const
+    {
+        if (handle.index >= generations.size() || generations[handle.index] != handle.generation || !isLive(handle.index))
+            return nullptr;
+        return getSlot(handle.index);
+    }
+
+    /**
+     * Queues an object to be destroyed by next collect. Object stays valid until then.
+     * Releasing an object more than once has no effect.
+     * @param object a pointer to object of this pool
+     * @return void
+     */
+    void release(T const* object)
+    {
+        unsigned slot = getHandle(object).index;
+        if (queued[slot])
+            return;
+        queued[slot] = 1;
+        pending.push_back(slot);
+    }
+
+    /**
+     * Destroys every queued object. Each of them takes constant time.
+     * @return size_t number of destroyed objects
+     */
+    size_t collect()
+    {
+        size_t count = pending.size();
+        for (size_t i = 0; i < pending.size(); ++i)
+        {
+            unsigned slot = pending[i];
+            //swap-and-pop from dense array
+            unsigned last = dense.back();
+            dense[denseIndex[slot]] = last;
+            denseIndex[last] = denseIndex[slot];
+            dense.pop_back();
+            getSlot(slot)->~T();
+            queued[slot] = 0;
+            ++generations[slot];
+            freeSlots.push_back(slot);
+        }
+        pending.clear();
+        return count;
+    }
+
+    /**
+     * Destroys every object. Memory is kept for objects created later, unless it was taken from an Arena.
+     * Slots keep their generations, so handles of destroyed objects stay invalid.
+     * @return void
+     */
+    void clear()
+    {
+        for (size_t i = 0; i < dense.size(); ++i)
+        {
+            getSlot(dense[i])->~T();
+            ++generations[dense[i]];
+        }
+        dense.clear();
+        pending.clear();
+        freeSlots.clear();
+        for (size_t slot = generations.size(); slot > 0; --slot)
+        {
+            queued[slot - 1] = 0;
+            freeSlots.push_back(unsigned(slot - 1));
+        }
+        if (arena != nullptr)
+        {
+            chunks.clear();
+            chunkOrder.clear();
+        }
+    }
+
+    /**
+     * Get number of objects, including queued ones.
+     * @return size_t
+     */
+    size_t size() const
+    {
+        return dense.size();
+    }
+
+    /**
+     * Calls function for every object, including queued ones.
+     * Function may release objects, but mustn't create or collect them.
+     * @param function function called with a pointer to every object
+     * @return void
+     */
+    template <class F>
+    void forEach(F function)
+    {
+        for (size_t i = 0; i < dense.size(); ++i)
+            function(getSlot(dense[i]));
+    }
+
+    /**
+     * Calls function for every object, including queued ones.
+     * @param function function called with a constant pointer to every object
+     * @return void
+     */
+    template <class F>
+    void forEach(F function) const
+    {
+        for (size_t i = 0; i < dense.size(); ++i)
+            function(const_cast<T const*>(getSlot(dense[i])));
+    }
+
+    /**
+     * Copy constructor is deleted because objects can't be copied.
+     */
+    ObjectPool(ObjectPool const&) = delete;
+
+    /**
+     * Assignment operator is deleted because objects can't be copied.
+     */
+    ObjectPool& operator=(ObjectPool const&) = delete;
+
+private:
+    /**
+     * Raw memory for a single object.
+     */
+    typedef typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type Slot;
+
+    /**
+     * Number of slots in a chunk.
+     */
+    static const unsigned chunkSize = 64;
+
+    /**
+     * A pointer to Arena that chunks are taken from, nullptr if they're allocated on heap.
+     */
+    Arena* const arena;
+
+    /**
+     * Chunks of slots, every one holds chunkSize slots.
+     */
+    std::vector<Slot*> chunks;
+
+    /**
+     * First objects of chunks paired with indices of chunks, sorted by address.
+     */
+    std::vector<std::pair<T const*, unsigned> > chunkOrder;
+
+    /**
+     * Generation of every slot, incremented whenever its object is destroyed.
+     */
+    std::vector<unsigned> generations;
+
+    /**
+     * Position of every slot in dense array. Valid only for slots that hold an object.
+     */
+    std::vector<unsigned> denseIndex;
+
+    /**
+     * Flags of slots queued for destruction.
+     */
+    std::vector<unsigned char> queued;
+
+    /**
+     * Slots of live objects in order of iteration.
+     */
+    std::vector<unsigned> dense;
+
+    /**
+     * Slots queued for destruction.
+     */
+    std::vector<unsigned> pending;
+
+    /**
+     * Slots freed by destroyed objects.
+     */
+    std::vector<unsigned> freeSlots;
+
+    /**
+     * Function called for every created object.
+     */
+    std::function<void(T*)> onCreate;
+
+    /**
+     * Check if object lies before chunk in memory.
+     * @param object a constant pointer to object
+     * @param chunk first object of chunk paired with index of chunk
+     * @return bool
+     */
+    static bool isBefore(T const* object, std::pair<T const*, unsigned> const& chunk)
+    {
+        return std::less<T const*>()(object, chunk.first);
+    }
+
+    /**
+     * Check if slot holds an object.
+     * @param slot index of slot
+     * @return bool
+     */
+    bool isLive(unsigned slot) const
+    {
+        return denseIndex[slot] < dense.size() && dense[denseIndex[slot]] == slot;
+    }
+
+    /**
+     * Get object in a slot.
+     * @param slot index of slot
+     * @return T*
+     */
+    T* getSlot(unsigned slot) const
+    {
+        return reinterpret_cast<T*>(&chunks[slot / chunkSize][slot % chunkSize]);
+    }
+};
+
+#endif // OBJECTPOOL_H
@@ -1,4 +1,11 @@
 #include "Physics.h"
+#include "SpatialGrid.h"
+#include "AABBTree.h"
+#include "World.h"
+#include "Snapshot.h"
+#include <algorithm>
+#include <limits>
+#include <cmath>
 
 /**
  * Physics implementation
@@ -6,17 +13,27 @@
 
 /**
  * Default constructor of Physics.
- * Sets currentTime, t, dt, accumulator and boundaries of physical simulation.
+ * Sets t, dt, accumulator and boundaries of physical simulation.
  * @param boundaryWidth width of bounding box in which physical simulation is simulated
  * @param boundaryHeight height of bounding box in which physical simulation is simulated
  */
 Physics::Physics(int boundaryWidth, int boundaryHeight) :
     t(0.0),
     dt(0.01),
-    currentTime(SDL_GetTicks() / 1000.0),
+    gravity(9.81),
     accumulator(0.0),
+    tickCount(0),
     boundaryWidth(boundaryWidth),
-    boundaryHeight(boundaryHeight)
+    boundaryHeight(boundaryHeight),
+    sleepTicks(30),
+    broadphaseType(BroadphaseType::Tree),
+    integratorType(IntegratorType::RK4),
+    continuousCollision(false),
+    staticGrid(new SpatialGrid()),
+    staticTree(new AABBTree()),
+    contactCache(1.0),
+    batchSize(64),
+    workerPool(nullptr)
 {
     SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Physics object created!");
 }
@@ -26,159 +43,892 @@ Physics::Physics(int boundaryWidth, int boundaryHeight) :
  */
 Physics::~Physics()
 {
+    delete staticGrid;
+    delete staticTree;
+    delete workerPool;
     SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Physics object destroyed!");
 }
 
 /**
- * Calculate next steps of simulation.
- * @param objectList reference to a list of all game objects
- * @return double because physical simulation is calculated in fixed steps, function returns coefficient of game state between steps, where 0 is previous step and 1 is current step
+ * Adds time that has passed since last update and takes out of it every whole step that is due, without simulating it.
+ * Caller runs due steps one by one with step, so it can do its own per-step work before each of them.
+ * Frame time is capped at 0.25 s, so a long hitch doesn't stall the game with too many steps.
+ * @param frameTime time in seconds that has passed since last update
+ * @return unsigned number of steps that are due
  */
-double Physics::update(std::list<Object*> &objectList)
+unsigned Physics::advance(double frameTime)
 {
-	double newTime = SDL_GetTicks() / 1000.0;
-	double frameTime = newTime - currentTime;
 	if (frameTime > 0.25)
 		frameTime = 0.25;
-	currentTime = newTime;
 
 	accumulator += frameTime;
 
+	unsigned ticks = 0;
 	while (accumulator >= dt)
 	{
-		for (std::list<Object*>::iterator it = objectList.begin(); it != objectList.end(); ++it)
-		{
-			Creature* tmpC = dynamic_cast<Creature*>(*it);
-			if (tmpC == nullptr)
-				continue;
-            tmpC->savePrevious();
-			State stateX = { tmpC->getX(), tmpC->getSpeedX() };
-			State stateY = { tmpC->getY(), tmpC->getSpeedY() };
-			integrate(stateX, t, dt, false);
-			integrate(stateY, t, dt, true);
-			tmpC->moveBy(stateX.x - tmpC->getX(), stateY.x - tmpC->getY());
-			tmpC->setSpeedVector(stateX.v, stateY.v);
-		}
-		t += dt;
+		++ticks;
 		accumulator -= dt;
-		checkCollision(objectList);
 	}
 
-	return accumulator / dt;
+	return ticks;
+}
 
+/**
+ * Get coefficient of game state between steps, where 0 is previous step and 1 is current step.
+ * Physical simulation is calculated in fixed steps, so time left over by advance falls between them.
+ * @return double
+ */
+double Physics::getAlpha() const
+{
+    return accumulator / dt;
 }
 
 /**
- * An RK4 integrator used to calculate next State based on current State.
- * @param state reference to state that will be changed
- * @param t current point in discrete time
- * @param dt a timestep
- * @param isY if false gravity won't be added into calculation, otherwise it will be
+ * Calculate exact number of steps of simulation, regardless of time that has passed.
+ * First step keeps focus of LodScheduler set by focusLevelOfDetail, later ones focus on players as they are then.
+ * @param world reference to World that holds all game objects
+ * @param ticks number of steps
  * @return void
  */
-void Physics::integrate(State &state, double t, double dt, bool isY)
+void Physics::step(World& world, unsigned ticks)
 {
-    Derivative a, b, c, d;
+    for (unsigned i = 0; i < ticks; ++i)
+    {
+        if (i > 0)
+            lod.setFocus(world);
+        tick(world);
+    }
+}
 
-    a = evaluate(state, t, 0.0f, Derivative(), isY);
-    b = evaluate(state, t, dt*0.5f, a, isY);
-    c = evaluate(state, t, dt*0.5f, b, isY);
-    d = evaluate(state, t, dt, c, isY);
+/**
+ * Get timestep of simulation.
+ * @return double timestep in seconds
+ */
+double Physics::getTimestep() const
+{
+    return dt;
+}
 
-    double dxdt = 1.0f / 6.0f *
-        (a.dx + 2.0f*(b.dx + c.dx) + d.dx);
+/**
+ * Changes timestep of simulation.
+ * Long timesteps should be used together with continuous collision, so fast bodies don't pass through thin objects.
+ * @param seconds new timestep in seconds, must be greater than 0
+ * @return void
+ */
+void Physics::setTimestep(double seconds)
+{
+    if (seconds > 0.0)
+        dt = seconds;
+}
 
-    double dvdt = 1.0f / 6.0f *
-        (a.dv + 2.0f*(b.dv + c.dv) + d.dv);
+/**
+ * Get current discrete time of simulation.
+ * @return double time in seconds
+ */
+double Physics::getTime() const
+{
+    return t;
+}
+
+/**
+ * Calculate a single step of simulation.
+ * @param world reference to World that holds all game objects
+ * @return void
+ */
+void Physics::tick(World& world)
+{
+    //objects removed since last step are dropped from cached contacts and woken sleepers at once
+    contactCache.applyRemovals();
+    wakeUncovered();
+    if (broadphaseType == BroadphaseType::BruteForce)
+    {
+        for (size_t i = 0; i < bodies.size(); ++i)
+        {
+            if (!scheduleBody(i))
+                continue;
+            bodies.creatures[i]->savePrevious();
+            bodies.creatures[i]->advanceTime(bodies.timestep[i]);
+        }
+        bodies.pull(0, bodies.size());
+        integrate(0, bodies.size());
+        bodies.push(0, bodies.size());
+        if (continuousCollision)
+        {
+            //brute force has no index of its own, so bodies are swept through the tree
+            if (batches.empty())
+                batches.resize(1);
+            std::vector<SolidObject*>& candidates = batches[0].candidates;
+            batches[0].sweptSensors.clear();
+            for (size_t i = 0; i < bodies.size(); ++i)
+            {
+                Creature* tmpC = bodies.creatures[i];
+                if (bodies.timestep[i] == 0.0)
+                    continue;
+                candidates.clear();
+                staticTree->query(std::min(tmpC->getPrevX(), tmpC->getX()), std::min(tmpC->getPrevY(), tmpC->getY()),
+                    std::max(tmpC->getPrevX(), tmpC->getX()) + bodies.width[i], std::max(tmpC->getPrevY(), tmpC->getY()) + bodies.height[i], candidates);
+                sweepStatic(tmpC, candidates, batches[0].sweptSensors);
+            }
+        }
+        t += dt;
+        ++tickCount;
+        checkCollision(world);
+        if (continuousCollision)
+            touchSweptSensors(batches[0]);
+        triggerSystem.update(world, continuousCollision);
+        updateSleep();
+        return;
+    }
 
-    state.x = state.x + dxdt * dt;
-    state.v = state.v + dvdt * dt;
+    unsigned batchCount = unsigned((bodies.size() + batchSize - 1) / batchSize);
+    if (batches.size() < batchCount)
+        batches.resize(batchCount);
+    if (workerPool != nullptr && batchCount > 1)
+        workerPool->run(batchCount, [this](unsigned index){ simulateBatch(index); });
+    else
+        for (unsigned i = 0; i < batchCount; ++i)
+            simulateBatch(i);
+    t += dt;
+    ++tickCount;
+    resolveSharedContacts();
+    triggerSystem.update(world, continuousCollision);
+    updateSleep();
 }
 
 /**
- * Calculate a derivative of initial state in discrete time.
- * @param state Reference to state that will be changed
- * @param t current point in discrete time
- * @param dt a timestep
- * @param d a derivative by which state should be changed in time
- * @param isY if false gravity won't be added into calculation, otherwise it will be
- * @return Derivative new derivative after calculations
+ * Sorts game objects into Creatures and static objects and builds broadphase over static ones and index of Triggers.
+ * Should be called once level is loaded.
+ * @param world reference to World that holds all game objects
+ * @return void
  */
-Derivative Physics::evaluate(const State &initial, double t, double dt, const Derivative &d, bool isY)
+void Physics::buildBroadphase(World& world)
 {
-	State state;
-	state.x = initial.x + d.dx*dt;
-	state.v = initial.v + d.dv*dt;
+    bodies.clear();
+    contactCache.clear();
+    removedBoxes.clear();
+    world.forEachCreature([this](Creature* creature){ bodies.add(creature, tickCount); contactCache.addBody(creature->getId()); });
+    lod.setFocus(world);
+    rebuildStatic(world);
+}
 
-	Derivative output;
-	output.dx = state.v;
-	if (isY)
-		output.dv = acceleration(state, t + dt);
-	else
-		output.dv = 0;
-	return output;
+/**
+ * Builds broadphase again over static objects of World and index of Triggers, keeping Creatures.
+ * Cached contacts are found again, so Creatures notice objects that were added.
+ * Should be called once static objects were added to World, removed ones are forgotten by removeObject.
+ * @param world reference to World that holds all game objects
+ * @return void
+ */
+void Physics::rebuildStatic(World& world)
+{
+    std::vector<SolidObject*> staticObjects;
+    contactCache.invalidate();
+    staticObjects.reserve(world.solids.size() + world.coins.size());
+    world.solids.forEach([&staticObjects](SolidObject* o){ staticObjects.push_back(o); });
+    world.coins.forEach([&staticObjects](Coin* o){ staticObjects.push_back(o); });
+    staticGrid->build(staticObjects);
+    staticTree->build(staticObjects);
+    triggerSystem.build(world);
 }
 
 /**
- * Calculate acceleration by applying spring and damper forces.
- * Currently is changed to return constant 9.81 which is Earth's gravitational acceleration.
- * @param state reference to state that is used in calculations
- * @param t current point in discrete time
- * @return double used to be calculated spring and damper forces. Now always constant 9.81
+ * Adds Creature that was created after broadphase was built.
+ * Static objects are added by rebuildStatic.
+ * @param object a pointer to added object
+ * @return void
  */
-double Physics::acceleration(const State& state, double t)
+void Physics::addObject(Object* object)
 {
-	//const float k = -10;
-	//const float b = 1;
-	//return -k * state.x - b*state.v;
-	return 9.81;
+    Creature* tmpC = objectCast<Creature>(object);
+    if (tmpC == nullptr)
+        return;
+    bodies.add(tmpC, tickCount);
+    contactCache.addBody(tmpC->getId());
 }
 
 /**
- * Performs check on Axis-Aligned Bounding Boxes if they collide and calls proper collision resolving functions.
- * @param objectList reference to a list of all game objects
+ * Appends simulated time, accumulated time and state of every body in order of simulation to snapshot.
+ * @param snapshot Snapshot that state is appended to
  * @return void
+ * @see Snapshot
  */
-void Physics::checkCollision(std::list<Object*> &objectList)
+void Physics::saveState(Snapshot& snapshot) const
 {
-	std::list<Object*>::iterator it;
-	for (it = objectList.begin(); it != objectList.end(); ++it)
-	{
-		Creature* tmpC = dynamic_cast<Creature*>(*it);
-		if (tmpC == nullptr)
-			continue;
-        if (tmpC->getX() < 0)
+    snapshot.write(t);
+    snapshot.write(accumulator);
+    snapshot.write(tickCount);
+    snapshot.write(Uint32(bodies.size()));
+    for (size_t i = 0; i < bodies.size(); ++i)
+    {
+        snapshot.write(bodies.creatures[i]->getId());
+        snapshot.write(bodies.idleTicks[i]);
+        snapshot.write(bodies.lastCollisionState[i]);
+        snapshot.write(bodies.lastTick[i]);
+    }
+}
+
+/**
+ * Reads state appended by saveState and builds broadphase over World restored from the same snapshot.
+ * Bodies are found by identifiers of their Creatures and simulated in the saved order. Used instead of buildBroadphase.
+ * @param snapshot Snapshot that state is read from
+ * @param world reference to World that holds restored game objects
+ * @return void
+ * @see Snapshot
+ */
+void Physics::loadState(Snapshot& snapshot, World& world)
+{
+    t = snapshot.read<double>();
+    accumulator = snapshot.read<double>();
+    tickCount = snapshot.read<Uint32>();
+    creaturesById.clear();
+    world.forEachCreature([this](Creature* creature){ creaturesById.push_back(creature); });
+    std::sort(creaturesById.begin(), creaturesById.end(), [](Creature const* a, Creature const* b){ return a->getId() < b->getId(); });
+    bodies.clear();
+    contactCache.clear();
+    removedBoxes.clear();
+    Uint32 count = snapshot.read<Uint32>();
+    for (Uint32 i = 0; i < count; ++i)
+    {
+        unsigned id = snapshot.read<unsigned>();
+        unsigned idleTicks = snapshot.read<unsigned>();
+        CollisionState lastCollisionState = snapshot.read<CollisionState>();
+        Uint32 lastTick = snapshot.read<Uint32>();
+        std::vector<Creature*>::const_iterator it = std::lower_bound(creaturesById.begin(), creaturesById.end(), id, [](Creature const* creature, unsigned id){ return creature->getId() < id; });
+        if (it == creaturesById.end() || (*it)->getId() != id)
+            continue;
+        bodies.add(*it, lastTick);
+        bodies.idleTicks.back() = idleTicks;
+        bodies.lastCollisionState.back() = lastCollisionState;
+        contactCache.addBody(id);
+    }
+    lod.setFocus(world);
+    rebuildStatic(world);
+    //Triggers touched when snapshot was taken mustn't fire again
+    triggerSystem.restore(world);
+}
+
+/**
+ * Forgets object that is about to be deleted.
+ * Sleeping Creatures that rested on removed static object are woken at once by next step.
+ * @param object a pointer to removed object
+ * @return void
+ */
+void Physics::removeObject(Object* object)
+{
+    SolidObject* tmpSolidObject = objectCast<SolidObject>(object);
+    if (tmpSolidObject == nullptr)
+        return;
+    if (tmpSolidObject->getKind() == ObjectKind::Trigger)
+    {
+        triggerSystem.remove(static_cast<Trigger*>(tmpSolidObject));
+        return;
+    }
+    Creature* tmpC = objectCast<Creature>(object);
+    if (tmpC != nullptr && bodies.remove(tmpC))
+        contactCache.removeBody(tmpC->getId());
+    else
+    {
+        staticGrid->remove(tmpSolidObject);
+        staticTree->remove(tmpSolidObject);
+        contactCache.removeObstacle();
+        //Creatures resting on removed object have to fall, they are woken by next step
+        Box box;
+        box.left = object->getX();
+        box.top = object->getY();
+        box.right = object->getX() + object->getWidth();
+        box.bottom = object->getY() + object->getHeight();
+        removedBoxes.push_back(box);
+    }
+}
+
+/**
+ * Changes broadphase used to find collision candidates.
+ * @param type new BroadphaseType
+ * @return void
+ */
+void Physics::setBroadphaseType(BroadphaseType type)
+{
+    broadphaseType = type;
+}
+
+/**
+ * Get currently used broadphase.
+ * @return BroadphaseType
+ */
+BroadphaseType Physics::getBroadphaseType() const
+{
+    return broadphaseType;
+}
+
+/**
+ * Changes integrator used to advance bodies.
+ * @param type new IntegratorType
+ * @return void
+ */
+void Physics::setIntegratorType(IntegratorType type)
+{
+    integratorType = type;
+}
+
+/**
+ * Get currently used integrator.
+ * @return IntegratorType
+ */
+IntegratorType Physics::getIntegratorType() const
+{
+    return integratorType;
+}
+
+/**
+ * Turns continuous collision against static objects on or off.
+ * When on, every Creature is swept from its previous position and stopped at first plain SolidObject it would sink too deep into.
+ * Coins and Triggers on the way there are touched even if Creature doesn't overlap them at the end of step.
+ * @param enabled true to turn continuous collision on
+ * @return void
+ */
+void Physics::setContinuousCollision(bool enabled)
+{
+    continuousCollision = enabled;
+}
+
+/**
+ * Check if continuous collision is on.
+ * @return bool
+ */
+bool Physics::getContinuousCollision() const
+{
+    return continuousCollision;
+}
+
+/**
+ * Changes after how many steps of rest a Creature is put to sleep.
+ * Creature rests if it hasn't moved, has no velocity and its CollisionState hasn't changed.
+ * Sleeping Creatures skip collision checks until they're moved, their velocity changes, they're hurt or touched by awake Creature.
+ * @param ticks number of steps, 0 turns sleeping off
+ * @return void
+ */
+void Physics::setSleepTicks(unsigned ticks)
+{
+    sleepTicks = ticks;
+}
+
+/**
+ * Changes how Creatures far from players are simulated.
+ * Far Creatures skip steps and catch up in a single coarse step once every period steps.
+ * @param distance horizontal distance from players beyond which Creatures are far, 0 simulates every Creature in every step
+ * @param period number of steps between coarse steps of far Creatures
+ * @return void
+ * @see LodScheduler
+ */
+void Physics::setLevelOfDetail(double distance, unsigned period)
+{
+    lod.setDistance(distance);
+    lod.setPeriod(period);
+}
+
+/**
+ * Focuses LodScheduler on players as they are now. Called at start of every step, so Controllers and bodies see the same Creatures as far.
+ * @param world reference to World that holds all game objects
+ * @return void
+ */
+void Physics::focusLevelOfDetail(World const& world)
+{
+    lod.setFocus(world);
+}
+
+/**
+ * Get LodScheduler that decides which Creatures are far, focused by focusLevelOfDetail.
+ * @return LodScheduler const&
+ */
+LodScheduler const& Physics::getLodScheduler() const
+{
+    return lod;
+}
+
+/**
+ * Get number of steps simulated since level was loaded.
+ * @return Uint32
+ */
+Uint32 Physics::getTickCount() const
+{
+    return tickCount;
+}
+
+/**
+ * Changes number of threads that simulate bodies.
+ * Bodies are split into batches that are integrated and tested against static objects in parallel.
+ * Results don't depend on number of threads.
+ * @param count number of threads including calling thread. 0 or 1 turns worker pool off
+ * @return void
+ */
+void Physics::setWorkerCount(unsigned count)
+{
+    delete workerPool;
+    workerPool = nullptr;
+    if (count > 1)
+        workerPool = new WorkerPool(count - 1);
+}
+
+/**
+ * Appends to result every object that overlaps given rectangle.
+ * Static objects and Triggers are looked up in AABBTrees regardless of used broadphase, Creatures are tested one by one.
+ * @param left left edge of queried rectangle
+ * @param top top edge of queried rectangle
+ * @param right right edge of queried rectangle
+ * @param bottom bottom edge of queried rectangle
+ * @param result a list to which objects are appended
+ * @return void
+ */
+void Physics::queryObjects(double left, double top, double right, double bottom, std::vector<SolidObject*>& result) const
+{
+    size_t first = result.size();
+    staticTree->query(left, top, right, bottom, result);
+    triggerSystem.query(left, top, right, bottom, result);
+    result.insert(result.end(), bodies.creatures.begin(), bodies.creatures.end());
+    //tree reports candidates only, so drop everything that doesn't really overlap
+    result.erase(std::remove_if(result.begin() + first, result.end(), [=](SolidObject const* o){
+        return !(o->getX() < right && o->getX() + o->getWidth() > left && o->getY() < bottom && o->getY() + o->getHeight() > top);
+    }), result.end());
+}
+
+/**
+ * Advances bodies in range [begin, end) by one timestep with chosen integrator.
+ * Integrator is picked once per call, so the kernel itself has no branches.
+ * @param begin index of first body
+ * @param end index after last body
+ * @return void
+ */
+void Physics::integrate(size_t begin, size_t end)
+{
+    switch (integratorType)
+    {
+    case IntegratorType::SemiImplicitEuler:
+        bodies.integrate<SemiImplicitEulerIntegrator>(begin, end, gravity);
+        break;
+    case IntegratorType::ConstantAcceleration:
+        bodies.integrate<ConstantAccelerationIntegrator>(begin, end, gravity);
+        break;
+    case IntegratorType::RK4:
+    default:
+        bodies.integrate<RK4Integrator>(begin, end, gravity);
+        break;
+    }
+}
+
+/**
+ * Picks timestep of body for current step.
+ * Far body is skipped until its coarse step, which catches up every step it has skipped. Sleeping body doesn't accumulate skipped steps.
+ * @param index index of body
+ * @return bool true if body is simulated in current step
+ */
+bool Physics::scheduleBody(size_t index)
+{
+    Uint32 tick = tickCount + 1;
+    Creature* tmpC = bodies.creatures[index];
+    if (tmpC->getIsSleeping())
+    {
+        bodies.timestep[index] = 0.0;
+        bodies.lastTick[index] = tick;
+        return false;
+    }
+    if (lod.isFar(tmpC) && !lod.isDue(tmpC->getScheduleKey(), tickCount, tick))
+    {
+        bodies.timestep[index] = 0.0;
+        return false;
+    }
+    bodies.timestep[index] = dt * (tick - bodies.lastTick[index]);
+    bodies.lastTick[index] = tick;
+    return true;
+}
+
+/**
+ * Integrates bodies of a Batch and resolves their collisions with static objects.
+ * Candidates come from ContactCache, plain SolidObjects that were touched in previous step are resolved from cached side.
+ * Touches only Creatures of the Batch, so batches can be simulated in parallel.
+ * Contacts with objects that change anything else are stored for resolveSharedContacts.
+ * @param index index of Batch
+ * @return void
+ */
+void Physics::simulateBatch(unsigned index)
+{
+    Batch& batch = batches[index];
+    size_t begin = size_t(index) * batchSize;
+    size_t end = std::min(begin + batchSize, bodies.size());
+    batch.sharedContacts.clear();
+    batch.sweptSensors.clear();
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        if (!scheduleBody(i))
+            continue;
+        bodies.creatures[i]->savePrevious();
+        bodies.creatures[i]->advanceTime(bodies.timestep[i]);
+    }
+    //bodies that aren't simulated go through the kernel too, it's cheaper than compacting, but push drops their results
+    bodies.pull(begin, end);
+    integrate(begin, end);
+    bodies.push(begin, end);
+
+    Broadphase* broadphase = (broadphaseType == BroadphaseType::UniformGrid) ? staticGrid : staticTree;
+    for (size_t i = begin; i < end; ++i)
+    {
+        Creature* tmpC = bodies.creatures[i];
+        if (bodies.timestep[i] == 0.0)
+            continue;
+        ContactCache::Contacts& contacts = contactCache.getContacts(tmpC->getId(),
+            std::min(tmpC->getPrevX(), tmpC->getX()), std::min(tmpC->getPrevY(), tmpC->getY()),
+            std::max(tmpC->getPrevX(), tmpC->getX()) + bodies.width[i], std::max(tmpC->getPrevY(), tmpC->getY()) + bodies.height[i],
+            broadphase, batch.candidates);
+        if (continuousCollision)
+            sweepStatic(tmpC, contacts.obstacles, batch.sweptSensors);
+        checkBoundaries(tmpC);
+        //boundaries may have pushed Creature out of cached box
+        contactCache.getContacts(tmpC->getId(), tmpC->getX(), tmpC->getY(), tmpC->getX() + bodies.width[i], tmpC->getY() + bodies.height[i],
+            broadphase, batch.candidates);
+
+        for (size_t k = 0; k < contacts.obstacles.size(); ++k)
+        {
+            SolidObject* tmpSolidObject = contacts.obstacles[k];
+            if (!intersects(tmpC, tmpSolidObject))
+            {
+                contacts.sides[k] = CollisionState::None;
+                continue;
+            }
+            //plain geometry only pushes the Creature, anything special (coins, triggers) is resolved later in order
+            if (tmpSolidObject->getKind() != ObjectKind::Solid)
+                batch.sharedContacts.push_back(std::make_pair(tmpC, tmpSolidObject));
+            else
+                contacts.sides[k] = tmpC->resolveContact(tmpSolidObject, contacts.sides[k]);
+        }
+    }
+}
+
+/**
+ * Moves Creature back along its path if it has sunk too deep into or passed through a plain SolidObject since previous step.
+ * Creature is left slightly inside the object, so discrete collision resolves the contact the usual way.
+ * Coins entered before that point that Creature doesn't overlap anymore are reported, so fast Creatures can't pass through them.
+ * @param creature a pointer to Creature that has been integrated
+ * @param candidates static objects that may lie on path of Creature
+ * @param sensors list to which coins passed through on the way are appended
+ * @return void
+ */
+void Physics::sweepStatic(Creature* creature, std::vector<SolidObject*> const& candidates, std::vector<std::pair<Creature*, SolidObject*> >& sensors)
+{
+    //Creature::onCollision pushes objects out the right way only when they are less than 0.2 inside
+    const double maxDepth = 0.2;
+    const double penetration = 0.1;
+    double startX = creature->getPrevX();
+    double startY = creature->getPrevY();
+    double moveX = creature->getX() - startX;
+    double moveY = creature->getY() - startY;
+    double width = creature->getWidth();
+    double height = creature->getHeight();
+    if (moveX == 0.0 && moveY == 0.0)
+        return;
+
+    double firstImpact = 1.0;
+    double firstOvershoot = 0.0;
+    for (std::vector<SolidObject*>::const_iterator it = candidates.begin(); it != candidates.end(); ++it)
+    {
+        //coins, triggers and the like don't block the path
+        if ((*it)->getKind() != ObjectKind::Solid)
+            continue;
+        bool alongX;
+        double impact = timeOfImpact(startX, startY, width, height, moveX, moveY, *it, alongX);
+        if (impact >= firstImpact)
+            continue;
+
+        //shallow contacts are left for discrete collision
+        double depth;
+        double overshoot;
+        if (alongX)
         {
-            tmpC->moveBy(-tmpC->getX(), 0);
-            tmpC->addCollisionState(CollisionState::FromRight);
+            depth = (moveX > 0.0) ? creature->getX() + width - (*it)->getX() : (*it)->getX() + (*it)->getWidth() - creature->getX();
+            overshoot = std::min(penetration, (*it)->getWidth() / 2.0) / std::fabs(moveX);
         }
-        else if (tmpC->getX() > boundaryWidth - tmpC->getWidth())
+        else
         {
-            tmpC->moveBy(-((tmpC->getWidth() + tmpC->getX()) - boundaryWidth), 0);
-            tmpC->addCollisionState(CollisionState::FromLeft);
+            depth = (moveY > 0.0) ? creature->getY() + height - (*it)->getY() : (*it)->getY() + (*it)->getHeight() - creature->getY();
+            overshoot = std::min(penetration, (*it)->getHeight() / 2.0) / std::fabs(moveY);
         }
-        if (tmpC->getY() < 0)
+        if (depth > maxDepth)
         {
-            tmpC->moveBy(0, -tmpC->getY());
-            tmpC->addCollisionState(CollisionState::FromBelow);
+            firstImpact = impact;
+            firstOvershoot = overshoot;
         }
+    }
+    double fraction = 1.0;
+    if (firstImpact < 1.0)
+    {
+        fraction = std::min(1.0, firstImpact + firstOvershoot);
+        creature->moveBy(startX + moveX * fraction - creature->getX(), startY + moveY * fraction - creature->getY());
+    }
 
-		std::list<Object*>::iterator it2;
-		for (it2 = objectList.begin(); it2 != objectList.end(); ++it2)
-		{
-			SolidObject* tmpSolidObject = dynamic_cast<SolidObject*>(*it2);
-			if (tmpSolidObject == nullptr || tmpC == tmpSolidObject)
-				continue;
+    //coins that are still overlapped are resolved by discrete collision
+    for (std::vector<SolidObject*>::const_iterator it = candidates.begin(); it != candidates.end(); ++it)
+    {
+        bool alongX;
+        if ((*it)->getKind() != ObjectKind::Solid && !intersects(creature, *it) &&
+            timeOfImpact(startX, startY, width, height, moveX, moveY, *it, alongX) < fraction)
+            sensors.push_back(std::make_pair(creature, *it));
+    }
+}
 
-			if (tmpC->getX() < tmpSolidObject->getX() + tmpSolidObject->getWidth() &&
-				tmpC->getX() + tmpC->getWidth() > tmpSolidObject->getX() &&
-				tmpC->getY() < tmpSolidObject->getY() + tmpSolidObject->getHeight() &&
-				tmpC->getHeight() + tmpC->getY() > tmpSolidObject->getY())
-			{
-				tmpC->onCollision(tmpSolidObject);
-			}
+/**
+ * Resolves coins that Creatures of a Batch passed through during current step.
+ * They are resolved like any other contact, only without testing overlap.
+ * @param batch Batch whose sensors are resolved
+ * @return void
+ */
+void Physics::touchSweptSensors(Batch& batch)
+{
+    for (std::vector<std::pair<Creature*, SolidObject*> >::iterator it = batch.sweptSensors.begin(); it != batch.sweptSensors.end(); ++it)
+        it->first->onCollision(it->second);
+}
 
-		}
+/**
+ * Resolves contacts stored by batches in order of batches, then contacts between Creatures.
+ * Creatures are tested only against ones whose left edges are close enough along X axis, found in a sorted list.
+ * Candidates are tested in order of bodies, so pairs are resolved in the same order as if every pair was tested.
+ * @return void
+ */
+void Physics::resolveSharedContacts()
+{
+    unsigned batchCount = unsigned((bodies.size() + batchSize - 1) / batchSize);
+    for (unsigned i = 0; i < batchCount; ++i)
+    {
+        std::vector<std::pair<Creature*, SolidObject*> >& contacts = batches[i].sharedContacts;
+        for (std::vector<std::pair<Creature*, SolidObject*> >::iterator it = contacts.begin(); it != contacts.end(); ++it)
+        {
+            if (intersects(it->first, it->second))
+                it->first->onCollision(it->second);
+        }
+        touchSweptSensors(batches[i]);
+    }
 
-	}
+    //left edges are taken once, so margin covers Creatures pushed while pairs are resolved
+    const double margin = 1.0;
+    double maxWidth = 0.0;
+    creaturesByLeft.clear();
+    for (size_t i = 0; i < bodies.size(); ++i)
+    {
+        creaturesByLeft.push_back(std::make_pair(bodies.creatures[i]->getX(), unsigned(i)));
+        maxWidth = std::max(maxWidth, bodies.width[i]);
+    }
+    std::sort(creaturesByLeft.begin(), creaturesByLeft.end());
+    for (size_t i = 0; i < bodies.size(); ++i)
+    {
+        Creature* tmpC = bodies.creatures[i];
+        std::vector<std::pair<double, unsigned> >::const_iterator first = std::lower_bound(creaturesByLeft.begin(), creaturesByLeft.end(),
+            std::make_pair(tmpC->getX() - maxWidth - margin, 0u));
+        double right = tmpC->getX() + bodies.width[i] + margin;
+        creatureCandidates.clear();
+        for (; first != creaturesByLeft.end() && first->first <= right; ++first)
+            creatureCandidates.push_back(first->second);
+        std::sort(creatureCandidates.begin(), creatureCandidates.end());
+        for (std::vector<unsigned>::const_iterator it = creatureCandidates.begin(); it != creatureCandidates.end(); ++it)
+        {
+            Creature* tmpOther = bodies.creatures[*it];
+            if (tmpC == tmpOther || (tmpC->getIsSleeping() && tmpOther->getIsSleeping()) || !intersects(tmpC, tmpOther))
+                continue;
+            tmpC->wake();
+            tmpOther->wake();
+            tmpC->onCollision(tmpOther);
+        }
+    }
+}
+
+/**
+ * Wakes sleeping Creatures that touch static objects removed since last step, so they fall.
+ * Boxes are sorted by left edge, so every sleeping Creature looks only at boxes that reach it along X axis.
+ * @return void
+ */
+void Physics::wakeUncovered()
+{
+    if (removedBoxes.empty())
+        return;
+    std::sort(removedBoxes.begin(), removedBoxes.end(), [](Box const& a, Box const& b){ return a.left < b.left; });
+    //margin keeps boxes whose right edge is rounded onto left edge of Creature
+    const double margin = 1.0;
+    double maxWidth = 0.0;
+    for (std::vector<Box>::const_iterator it = removedBoxes.begin(); it != removedBoxes.end(); ++it)
+        maxWidth = std::max(maxWidth, it->right - it->left);
+    for (size_t i = 0; i < bodies.size(); ++i)
+    {
+        Creature* tmpC = bodies.creatures[i];
+        if (!tmpC->getIsSleeping())
+            continue;
+        std::vector<Box>::const_iterator it = std::lower_bound(removedBoxes.begin(), removedBoxes.end(), tmpC->getX() - maxWidth - margin,
+            [](Box const& box, double left){ return box.left < left; });
+        for (; it != removedBoxes.end() && it->left <= tmpC->getX() + tmpC->getWidth(); ++it)
+        {
+            if (tmpC->getX() <= it->right && tmpC->getY() <= it->bottom && tmpC->getY() + tmpC->getHeight() >= it->top)
+            {
+                tmpC->wake();
+                break;
+            }
+        }
+    }
+    removedBoxes.clear();
+}
+
+/**
+ * Counts steps in which awake Creatures have been resting and puts them to sleep after sleepTicks.
+ * @return void
+ */
+void Physics::updateSleep()
+{
+    if (sleepTicks == 0)
+        return;
+    for (size_t i = 0; i < bodies.size(); ++i)
+    {
+        Creature* tmpC = bodies.creatures[i];
+        if (tmpC->getIsSleeping())
+            continue;
+        bool resting = tmpC->getX() == tmpC->getPrevX() && tmpC->getY() == tmpC->getPrevY() &&
+            tmpC->getSpeedX() == 0.0 && tmpC->getSpeedY() == 0.0 &&
+            tmpC->getCollisionState() == bodies.lastCollisionState[i] && !tmpC->getIsInvulnerable();
+        bodies.lastCollisionState[i] = tmpC->getCollisionState();
+        if (!resting)
+            bodies.idleTicks[i] = 0;
+        else if (++bodies.idleTicks[i] >= sleepTicks)
+        {
+            tmpC->sleep();
+            bodies.idleTicks[i] = 0;
+        }
+    }
+}
+
+/**
+ * Performs check on Axis-Aligned Bounding Boxes if they collide and calls proper collision resolving functions.
+ * Every Creature is tested against every SolidObject, it's used only by BroadphaseType::BruteForce.
+ * @param world reference to World that holds all game objects
+ * @return void
+ */
+void Physics::checkCollision(World& world)
+{
+    world.forEachCreature([this, &world](Creature* tmpC)
+    {
+        if (tmpC->getIsSleeping())
+            return;
+        checkBoundaries(tmpC);
+        world.forEachObject([tmpC](SolidObject* tmpSolidObject)
+        {
+            if (tmpC == tmpSolidObject || !intersects(tmpC, tmpSolidObject))
+                return;
+            Creature* tmpOther = objectCast<Creature>(tmpSolidObject);
+            if (tmpOther != nullptr)
+                tmpOther->wake();
+            tmpC->onCollision(tmpSolidObject);
+        });
+    });
+}
+
+/**
+ * Keeps Creature inside of bounding box of simulation.
+ * @param creature a pointer to Creature
+ * @return void
+ */
+void Physics::checkBoundaries(Creature* creature)
+{
+    if (creature->getX() < 0)
+    {
+        creature->moveBy(-creature->getX(), 0);
+        creature->addCollisionState(CollisionState::FromRight);
+    }
+    else if (creature->getX() > boundaryWidth - creature->getWidth())
+    {
+        creature->moveBy(-((creature->getWidth() + creature->getX()) - boundaryWidth), 0);
+        creature->addCollisionState(CollisionState::FromLeft);
+    }
+    if (creature->getY() < 0)
+    {
+        creature->moveBy(0, -creature->getY());
+        creature->addCollisionState(CollisionState::FromBelow);
+    }
+}
+
+/**
+ * Check if Axis-Aligned Bounding Boxes of two objects overlap.
+ * @param a first object
+ * @param b second object
+ * @return bool
+ */
+bool Physics::intersects(Object const* a, Object const* b)
+{
+    return a->getX() < b->getX() + b->getWidth() &&
+        a->getX() + a->getWidth() > b->getX() &&
+        a->getY() < b->getY() + b->getHeight() &&
+        a->getHeight() + a->getY() > b->getY();
+}
+
+
+/**
+ * Calculates when a moving box enters a static object.
+ * Box is shrunk by a small skin, so boxes that merely touch the object (e.g. standing on it) don't hit its sides.
+ * @param x X position of box at start of motion
+ * @param y Y position of box at start of motion
+ * @param width width of box
+ * @param height height of box
+ * @param moveX motion on X axis
+ * @param moveY motion on Y axis
+ * @param obstacle static object
+ * @param alongX set to true if box hits side of object, false if it hits top or bottom
+ * @return double fraction of motion in range [0, 1) at which box hits object, 1 if there is no hit
+ */
+double Physics::timeOfImpact(double x, double y, double width, double height, double moveX, double moveY, Object const* obstacle, bool& alongX)
+{
+    const double skin = 1e-6;
+    const double infinity = std::numeric_limits<double>::infinity();
+    double left = x + skin;
+    double right = x + width - skin;
+    double top = y + skin;
+    double bottom = y + height - skin;
+    double obstacleRight = obstacle->getX() + obstacle->getWidth();
+    double obstacleBottom = obstacle->getY() + obstacle->getHeight();
+
+    double entryX, exitX;
+    if (moveX > 0.0)
+    {
+        entryX = (obstacle->getX() - right) / moveX;
+        exitX = (obstacleRight - left) / moveX;
+    }
+    else if (moveX < 0.0)
+    {
+        entryX = (obstacleRight - left) / moveX;
+        exitX = (obstacle->getX() - right) / moveX;
+    }
+    else if (left < obstacleRight && right > obstacle->getX())
+    {
+        entryX = -infinity;
+        exitX = infinity;
+    }
+    else
+        return 1.0;
+
+    double entryY, exitY;
+    if (moveY > 0.0)
+    {
+        entryY = (obstacle->getY() - bottom) / moveY;
+        exitY = (obstacleBottom - top) / moveY;
+    }
+    else if (moveY < 0.0)
+    {
+        entryY = (obstacleBottom - top) / moveY;
+        exitY = (obstacle->getY() - bottom) / moveY;
+    }
+    else if (top < obstacleBottom && bottom > obstacle->getY())
+    {
+        entryY = -infinity;
+        exitY = infinity;
+    }
+    else
+        return 1.0;
+
+    double entry = std::max(entryX, entryY);
+    double exit = std::min(exitX, exitY);
+    //boxes that already overlap are left for discrete collision
+    if (entry > exit || entry < 0.0 || entry >= 1.0)
+        return 1.0;
+    alongX = entryX > entryY;
+    return entry;
 }
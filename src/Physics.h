@@ -2,36 +2,52 @@
 #define PHYSICS_H
 
 #include "Creature.h"
-#include <list>
-#include <SDL_timer.h>
+#include "Broadphase.h"
+#include "BodyStore.h"
+#include "ContactCache.h"
+#include "TriggerSystem.h"
+#include "LodScheduler.h"
+#include "WorkerPool.h"
+#include <vector>
 
-/**
- * State is a struct that holds current state of position and velocity.
- */
-struct State
-{
-	double x;      // position
-	double v;      // velocity
-};
+class World;
+class Snapshot;
 
 /**
- * Derivative is a struct that holds current derivative of position and velocity.
+ * The types of broadphase that can be used by Physics to find collision candidates.
+ * @see Physics
  */
-struct Derivative
+enum class BroadphaseType
 {
-	double dx;      // dx/dt = velocity
-	double dv;      // dv/dt = acceleration
+    /**
+     * Every Creature is tested against every SolidObject.
+     */
+    BruteForce,
+
+    /**
+     * Static objects are looked up in a uniform grid.
+     * @see SpatialGrid
+     */
+    UniformGrid,
+
+    /**
+     * Static objects are looked up in a bounding volume hierarchy.
+     * @see AABBTree
+     */
+    Tree
 };
 
 /**
  * Physics is a class that is responsible for simulating physics.
+ * Triggers aren't collided with, every step ends with TriggerSystem firing Triggers touched by PlayerCreatures.
+ * @see TriggerSystem
  */
 class Physics
 {
 public:
     /**
      * Default constructor of Physics.
-     * Sets currentTime, t, dt, accumulator and boundaries of physical simulation.
+     * Sets t, dt, accumulator and boundaries of physical simulation.
      * @param boundaryWidth width of bounding box in which physical simulation is simulated
      * @param boundaryHeight height of bounding box in which physical simulation is simulated
      */
@@ -48,11 +64,214 @@ public:
     ~Physics();
 	
     /**
-     * Calculate next steps of simulation.
-     * @param objectList reference to a list of all game objects
-     * @return double because physical simulation is calculated in fixed steps, function returns coefficient of game state between steps, where 0 is previous step and 1 is current step
+     * Adds time that has passed since last update and takes out of it every whole step that is due, without simulating it.
+     * Caller runs due steps one by one with step, so it can do its own per-step work before each of them.
+     * Frame time is capped at 0.25 s, so a long hitch doesn't stall the game with too many steps.
+     * @param frameTime time in seconds that has passed since last update
+     * @return unsigned number of steps that are due
+     */
+    unsigned advance(double frameTime);
+
+    /**
+     * Get coefficient of game state between steps, where 0 is previous step and 1 is current step.
+     * Physical simulation is calculated in fixed steps, so time left over by advance falls between them.
+     * @return double
+     */
+    double getAlpha() const;
+
+    /**
+     * Calculate exact number of steps of simulation, regardless of time that has passed.
+     * First step keeps focus of LodScheduler set by focusLevelOfDetail, later ones focus on players as they are then.
+     * @param world reference to World that holds all game objects
+     * @param ticks number of steps
+     * @return void
+     */
+    void step(World& world, unsigned ticks);
+
+    /**
+     * Get timestep of simulation.
+     * @return double timestep in seconds
+     */
+    double getTimestep() const;
+
+    /**
+     * Changes timestep of simulation.
+     * Long timesteps should be used together with continuous collision, so fast bodies don't pass through thin objects.
+     * @param seconds new timestep in seconds, must be greater than 0
+     * @return void
      */
-    double update(std::list<Object*>& objectList);
+    void setTimestep(double seconds);
+
+    /**
+     * Get current discrete time of simulation.
+     * @return double time in seconds
+     */
+    double getTime() const;
+
+    /**
+     * Sorts game objects into Creatures and static objects and builds broadphase over static ones and index of Triggers.
+     * Should be called once level is loaded.
+     * @param world reference to World that holds all game objects
+     * @return void
+     */
+    void buildBroadphase(World& world);
+
+    /**
+     * Builds broadphase again over static objects of World and index of Triggers, keeping Creatures.
+     * Should be called once static objects were added to World, removed ones are forgotten by removeObject.
+     * @param world reference to World that holds all game objects
+     * @return void
+     */
+    void rebuildStatic(World& world);
+
+    /**
+     * Adds Creature that was created after broadphase was built.
+     * Static objects are added by rebuildStatic.
+     * @param object a pointer to added object
+     * @return void
+     */
+    void addObject(Object* object);
+
+    /**
+     * Appends simulated time, accumulated time and state of every body in order of simulation to snapshot.
+     * @param snapshot Snapshot that state is appended to
+     * @return void
+     * @see Snapshot
+     */
+    void saveState(Snapshot& snapshot) const;
+
+    /**
+     * Reads state appended by saveState and builds broadphase over World restored from the same snapshot.
+     * Bodies are found by identifiers of their Creatures and simulated in the saved order. Used instead of buildBroadphase.
+     * @param snapshot Snapshot that state is read from
+     * @param world reference to World that holds restored game objects
+     * @return void
+     * @see Snapshot
+     */
+    void loadState(Snapshot& snapshot, World& world);
+
+    /**
+     * Forgets object that is about to be deleted.
+     * Sleeping Creatures that rested on removed static object are woken at once by next step.
+     * @param object a pointer to removed object
+     * @return void
+     */
+    void removeObject(Object* object);
+
+    /**
+     * Changes broadphase used to find collision candidates.
+     * @param type new BroadphaseType
+     * @return void
+     */
+    void setBroadphaseType(BroadphaseType type);
+
+    /**
+     * Get currently used broadphase.
+     * @return BroadphaseType
+     */
+    BroadphaseType getBroadphaseType() const;
+
+    /**
+     * Changes integrator used to advance bodies.
+     * @param type new IntegratorType
+     * @return void
+     */
+    void setIntegratorType(IntegratorType type);
+
+    /**
+     * Get currently used integrator.
+     * @return IntegratorType
+     */
+    IntegratorType getIntegratorType() const;
+
+    /**
+     * Turns continuous collision against static objects on or off.
+     * When on, every Creature is swept from its previous position and stopped at first plain SolidObject it would sink too deep into.
+     * Coins and Triggers on the way there are touched even if Creature doesn't overlap them at the end of step.
+     * @param enabled true to turn continuous collision on
+     * @return void
+     */
+    void setContinuousCollision(bool enabled);
+
+    /**
+     * Check if continuous collision is on.
+     * @return bool
+     */
+    bool getContinuousCollision() const;
+
+    /**
+     * Changes after how many steps of rest a Creature is put to sleep.
+     * Creature rests if it hasn't moved, has no velocity and its CollisionState hasn't changed.
+     * Sleeping Creatures skip collision checks until they're moved, their velocity changes, they're hurt or touched by awake Creature.
+     * @param ticks number of steps, 0 turns sleeping off
+     * @return void
+     */
+    void setSleepTicks(unsigned ticks);
+
+    /**
+     * Changes how Creatures far from players are simulated.
+     * Far Creatures skip steps and catch up in a single coarse step once every period steps.
+     * @param distance horizontal distance from players beyond which Creatures are far, 0 simulates every Creature in every step
+     * @param period number of steps between coarse steps of far Creatures
+     * @return void
+     * @see LodScheduler
+     */
+    void setLevelOfDetail(double distance, unsigned period);
+
+    /**
+     * Focuses LodScheduler on players as they are now. Called at start of every step, so Controllers and bodies see the same Creatures as far.
+     * @param world reference to World that holds all game objects
+     * @return void
+     */
+    void focusLevelOfDetail(World const& world);
+
+    /**
+     * Get LodScheduler that decides which Creatures are far, focused by focusLevelOfDetail.
+     * @return LodScheduler const&
+     */
+    LodScheduler const& getLodScheduler() const;
+
+    /**
+     * Get number of steps simulated since level was loaded.
+     * @return Uint32
+     */
+    Uint32 getTickCount() const;
+
+    /**
+     * Changes number of threads that simulate bodies.
+     * Bodies are split into batches that are integrated and tested against static objects in parallel.
+     * Results don't depend on number of threads.
+     * @param count number of threads including calling thread. 0 or 1 turns worker pool off
+     * @return void
+     */
+    void setWorkerCount(unsigned count);
+
+    /**
+     * Appends to result every object that overlaps given rectangle.
+     * Static objects and Triggers are looked up in AABBTrees regardless of used broadphase, Creatures are tested one by one.
+     * @param left left edge of queried rectangle
+     * @param top top edge of queried rectangle
+     * @param right right edge of queried rectangle
+     * @param bottom bottom edge of queried rectangle
+     * @param result a list to which objects are appended
+     * @return void
+     */
+    void queryObjects(double left, double top, double right, double bottom, std::vector<SolidObject*>& result) const;
+
+    /**
+     * Calculates when a moving box enters a static object.
+     * Box is shrunk by a small skin, so boxes that merely touch the object (e.g. standing on it) don't hit its sides.
+     * @param x X position of box at start of motion
+     * @param y Y position of box at start of motion
+     * @param width width of box
+     * @param height height of box
+     * @param moveX motion on X axis
+     * @param moveY motion on Y axis
+     * @param obstacle static object
+     * @param alongX set to true if box hits side of object, false if it hits top or bottom
+     * @return double fraction of motion in range [0, 1) at which box hits object, 1 if there is no hit
+     */
+    static double timeOfImpact(double x, double y, double width, double height, double moveX, double moveY, Object const* obstacle, bool& alongX);
 
     /**
      * Assigment operator is overloaded because it cannot be generated by compiler but because it shouldn't be used it's deleted.
@@ -68,18 +287,23 @@ private:
     /**
      * Timestep of simulation.
      */
-    const double dt;
-	
+    double dt;
+
     /**
-     * Current time of game.
+     * Constant vertical acceleration, Earth's gravitational acceleration.
      */
-    double currentTime;
-
+    const double gravity;
+	
     /**
      * Time of simulation still to be processed.
      */
 	double accumulator;
 
+    /**
+     * Number of simulated steps.
+     */
+    Uint32 tickCount;
+
     /**
      * Width of bounding box by which simulation is constrained.
      */
@@ -91,41 +315,203 @@ private:
     int boundaryHeight;
 
     /**
-     * An RK4 integrator used to calculate next State based on current State.
-     * @param state reference to state that will be changed
-     * @param t current point in discrete time
-     * @param dt a timestep
-     * @param isY if false gravity won't be added into calculation, otherwise it will be
+     * Number of steps of rest after which a Creature is put to sleep, 0 if Creatures never sleep.
+     */
+    unsigned sleepTicks;
+
+    /**
+     * Currently used broadphase.
+     */
+    BroadphaseType broadphaseType;
+
+    /**
+     * Currently used integrator.
+     */
+    IntegratorType integratorType;
+
+    /**
+     * True if Creatures are swept against static objects.
+     */
+    bool continuousCollision;
+
+    /**
+     * A pointer to uniform grid over static objects.
+     */
+    Broadphase* staticGrid;
+
+    /**
+     * A pointer to bounding volume hierarchy over static objects.
+     */
+    Broadphase* staticTree;
+
+    /**
+     * Index of Triggers and pairs touching them.
+     */
+    TriggerSystem triggerSystem;
+
+    /**
+     * Decides which Creatures are simulated in coarse steps.
+     */
+    LodScheduler lod;
+
+    /**
+     * Contiguous copy of state of every Creature. Creatures are tested against each other without broadphase.
+     */
+    BodyStore bodies;
+
+    /**
+     * Collision candidates and last contacts of every Creature, reused between steps.
+     */
+    ContactCache contactCache;
+
+    /**
+     * Batch is a struct that holds scratch lists of a range of bodies simulated together.
+     */
+    struct Batch
+    {
+        std::vector<SolidObject*> candidates;                           // collision candidates reused between queries
+        std::vector<std::pair<Creature*, SolidObject*> > sharedContacts; // contacts that change more than the Creature itself
+        std::vector<std::pair<Creature*, SolidObject*> > sweptSensors;   // coins passed through by swept Creatures, no longer overlapping
+    };
+
+    /**
+     * Maximum number of bodies in a single Batch.
+     */
+    const unsigned batchSize;
+
+    /**
+     * Scratch lists of every Batch.
+     */
+    std::vector<Batch> batches;
+
+    /**
+     * A pointer to WorkerPool, nullptr if bodies are simulated on calling thread.
+     */
+    WorkerPool* workerPool;
+
+    /**
+     * Creatures sorted by identifier, reused by every loadState.
+     */
+    std::vector<Creature*> creaturesById;
+
+    /**
+     * Left edges of Creatures paired with their indices, sorted by edge. Reused by every step.
+     */
+    std::vector<std::pair<double, unsigned> > creaturesByLeft;
+
+    /**
+     * Indices of Creatures that may touch tested Creature, reused by every test.
+     */
+    std::vector<unsigned> creatureCandidates;
+
+    /**
+     * Box is a struct that holds edges of a static object removed since last step.
+     */
+    struct Box
+    {
+        double left;   // edges of removed object
+        double top;
+        double right;
+        double bottom;
+    };
+
+    /**
+     * Boxes of static objects removed since last step, sorted by left edge when Creatures resting on them are woken.
+     */
+    std::vector<Box> removedBoxes;
+
+    /**
+     * Calculate a single step of simulation.
+     * @param world reference to World that holds all game objects
      * @return void
      */
-	void integrate(State& state, double t, double dt, bool isY);
-	
+    void tick(World& world);
+
+    /**
+     * Advances bodies in range [begin, end) by one timestep with chosen integrator.
+     * Integrator is picked once per call, so the kernel itself has no branches.
+     * @param begin index of first body
+     * @param end index after last body
+     * @return void
+     */
+    void integrate(size_t begin, size_t end);
+
+    /**
+     * Picks timestep of body for current step.
+     * Far body is skipped until its coarse step, which catches up every step it has skipped. Sleeping body doesn't accumulate skipped steps.
+     * @param index index of body
+     * @return bool true if body is simulated in current step
+     */
+    bool scheduleBody(size_t index);
+
     /**
-     * Calculate a derivative of initial state in discrete time.
-     * @param state Reference to state that will be changed
-     * @param t current point in discrete time
-     * @param dt a timestep
-     * @param d a derivative by which state should be changed in time
-     * @param isY if false gravity won't be added into calculation, otherwise it will be
-     * @return Derivative new derivative after calculations
+     * Integrates bodies of a Batch and resolves their collisions with static objects.
+     * Candidates come from ContactCache, plain SolidObjects that were touched in previous step are resolved from cached side.
+     * Touches only Creatures of the Batch, so batches can be simulated in parallel.
+     * Contacts with objects that change anything else are stored for resolveSharedContacts.
+     * @param index index of Batch
+     * @return void
      */
-    Derivative evaluate(State const& initial, double t, double dt, Derivative const& d, bool isY);
+    void simulateBatch(unsigned index);
 
     /**
-     * Calculate acceleration by applying spring and damper forces.
-     * Currently is changed to return constant 9.81 which is Earth's gravitational acceleration.
-     * @param state reference to state that is used in calculations
-     * @param t current point in discrete time
-     * @return double used to be calculated spring and damper forces. Now always constant 9.81
+     * Moves Creature back along its path if it has sunk too deep into or passed through a plain SolidObject since previous step.
+     * Creature is left slightly inside the object, so discrete collision resolves the contact the usual way.
+     * @param creature a pointer to Creature that has been integrated
+     * @param candidates static objects that may lie on path of Creature
+     * @param sensors list to which coins passed through on the way are appended
+     * @return void
      */
-	double acceleration(const State &state, double t);
+    void sweepStatic(Creature* creature, std::vector<SolidObject*> const& candidates, std::vector<std::pair<Creature*, SolidObject*> >& sensors);
+
+    /**
+     * Resolves coins that Creatures of a Batch passed through during current step.
+     * @param batch Batch whose sensors are resolved
+     * @return void
+     */
+    static void touchSweptSensors(Batch& batch);
+
+    /**
+     * Resolves contacts stored by batches in order of batches, then contacts between Creatures.
+     * Creatures are tested only against ones whose left edges are close enough along X axis, found in a sorted list.
+     * @return void
+     */
+    void resolveSharedContacts();
+
+    /**
+     * Counts steps in which awake Creatures have been resting and puts them to sleep after sleepTicks.
+     * @return void
+     */
+    void updateSleep();
+
+    /**
+     * Wakes sleeping Creatures that touch static objects removed since last step, so they fall.
+     * @return void
+     */
+    void wakeUncovered();
 
     /**
      * Performs check on Axis-Aligned Bounding Boxes if they collide and calls proper collision resolving functions.
-     * @param objectList reference to a list of all game objects
+     * Every Creature is tested against every SolidObject, it's used only by BroadphaseType::BruteForce.
+     * @param world reference to World that holds all game objects
+     * @return void
+     */
+	void checkCollision(World& world);
+
+    /**
+     * Keeps Creature inside of bounding box of simulation.
+     * @param creature a pointer to Creature
      * @return void
      */
-	void checkCollision(std::list<Object*>& objectList);
+    void checkBoundaries(Creature* creature);
+
+    /**
+     * Check if Axis-Aligned Bounding Boxes of two objects overlap.
+     * @param a first object
+     * @param b second object
+     * @return bool
+     */
+    static bool intersects(Object const* a, Object const* b);
 };
 
 #endif // PHYSICS_H
\ No newline at end of file
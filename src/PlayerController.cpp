@@ -1,5 +1,6 @@
 #include "PlayerController.h"
 #include "GameDefs.h"
+#include "Snapshot.h"
 
 /**
  * PlayerController implementation
@@ -7,13 +8,15 @@
 
 /**
  * The default constructor with PlayerCreature possesion.
- * @param creature association of Creature object
+ * @param world a constant pointer to World that holds PlayerCreature
+ * @param creature handle of associated PlayerCreature
  * @param maxSpeed an absolute value of a maximum horizontal velocity that PlayerController should set
  * @see PlayerCreature
  * @see Controller
  */
-PlayerController::PlayerController(PlayerCreature* creature) :
-    Controller(creature, 5.0),
+PlayerController::PlayerController(World const* world, ObjectHandle creature) :
+    Controller(world, creature, 5.0),
+    buttons(InputButton::None),
     doJump(false),
     stopJump(false),
     grounded(false),
@@ -33,9 +36,10 @@ PlayerController::~PlayerController()
 
 /**
  * Tell controlled PlayerCreature to jump.
+ * @param creature a pointer to controlled PlayerCreature
  * @return void
  */
-void PlayerController::jump()
+void PlayerController::jump(Creature* creature)
 {
 	/*if (!hasJumped)
 	{
@@ -65,6 +69,32 @@ void PlayerController::jump()
 	}
 }
 
+/**
+ * Appends state of PlayerController to snapshot.
+ * @param snapshot Snapshot that state is appended to
+ * @return void
+ */
+void PlayerController::saveState(Snapshot& snapshot) const
+{
+    Controller::saveState(snapshot);
+    snapshot.write(doJump);
+    snapshot.write(stopJump);
+    snapshot.write(grounded);
+}
+
+/**
+ * Reads state of PlayerController appended by saveState.
+ * @param snapshot Snapshot that state is read from
+ * @return void
+ */
+void PlayerController::loadState(Snapshot& snapshot)
+{
+    Controller::loadState(snapshot);
+    doJump = snapshot.read<bool>();
+    stopJump = snapshot.read<bool>();
+    grounded = snapshot.read<bool>();
+}
+
 /**
  * An implementation of how to control associated PlayerCreature.
  * @see PlayerCreature
@@ -74,6 +104,9 @@ void PlayerController::jump()
  */
 void PlayerController::control()
 {
+	Creature* creature = getCreature();
+	if (creature == nullptr)
+		return;
 	if ((creature->getCollisionState() & CollisionState::FromAbove) == CollisionState::FromAbove)
 	{
 		//hasJumped = false;
@@ -88,25 +121,36 @@ void PlayerController::control()
     //{
         //hasJumped = true;
     //}
-    inputHandling();
-	jump();
+    inputHandling(creature);
+	jump(creature);
 	//creature->move();
 }
 
+/**
+ * Changes buttons that are interpreted by next control.
+ * @param buttons buttons held by player
+ * @return void
+ * @see InputSource
+ */
+void PlayerController::setButtons(InputButton buttons)
+{
+    this->buttons = buttons;
+}
+
 /**
 * Interpret player input.
+* @param creature a pointer to controlled PlayerCreature
 * @return void
 */
-void PlayerController::inputHandling()
+void PlayerController::inputHandling(Creature* creature)
 {
-	const Uint8 *state = SDL_GetKeyboardState(nullptr);
-	if (state[SDL_SCANCODE_LEFT])
-		goLeft();
-	else if (state[SDL_SCANCODE_RIGHT])
-		goRight();
+	if ((buttons & InputButton::Left) == InputButton::Left)
+		goLeft(creature);
+	else if ((buttons & InputButton::Right) == InputButton::Right)
+		goRight(creature);
 	else
-		stopGoing();
-	if (state[SDL_SCANCODE_SPACE])
+		stopGoing(creature);
+	if ((buttons & InputButton::Jump) == InputButton::Jump)
 	{
 		if (grounded)
 			doJump = true;
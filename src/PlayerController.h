@@ -4,8 +4,7 @@
 #include "Controller.h"
 #include "PlayerCreature.h"
 #include "Timer.h"
-#include <SDL_keyboard.h>
-#include <SDL_events.h>
+#include "InputSource.h"
 
 /**
  * PlayerController is a special Controller that takes interprets player input.
@@ -16,12 +15,13 @@ public:
     
     /**
      * The default constructor with PlayerCreature possesion.
-     * @param creature association of Creature object
+     * @param world a constant pointer to World that holds PlayerCreature
+     * @param creature handle of associated PlayerCreature
      * @param maxSpeed an absolute value of a maximum horizontal velocity that PlayerController should set
      * @see PlayerCreature
      * @see Controller
      */
-    PlayerController(PlayerCreature* creature);
+    PlayerController(World const* world, ObjectHandle creature);
     
     /**
      * The default destructor.
@@ -30,9 +30,10 @@ public:
     
     /**
      * Tell controlled PlayerCreature to jump.
+     * @param creature a pointer to controlled PlayerCreature
      * @return void
      */
-    void jump();
+    void jump(Creature* creature);
     
     /**
      * An implementation of how to control associated PlayerCreature.
@@ -43,12 +44,39 @@ public:
      */
     void control() override;
 
+    /**
+     * Changes buttons that are interpreted by next control.
+     * @param buttons buttons held by player
+     * @return void
+     * @see InputSource
+     */
+    void setButtons(InputButton buttons);
+
+    /**
+     * Appends state of PlayerController to snapshot.
+     * @param snapshot Snapshot that state is appended to
+     * @return void
+     */
+    void saveState(Snapshot& snapshot) const override;
+
+    /**
+     * Reads state of PlayerController appended by saveState.
+     * @param snapshot Snapshot that state is read from
+     * @return void
+     */
+    void loadState(Snapshot& snapshot) override;
+
     /**
      * Assignment operator is deleted because PlayerController has constant variable.
      */
     PlayerController& operator=(PlayerController const&) = delete;
 
 private:
+    /**
+     * Buttons held by player.
+     */
+    InputButton buttons;
+
     /**
      * Should controlled PlayerCreature jump.
      */
@@ -76,9 +104,10 @@ private:
 
     /**
      * Interpret player input.
+     * @param creature a pointer to controlled PlayerCreature
      * @return void
      */
-	void inputHandling();
+	void inputHandling(Creature* creature);
 };
 
 #endif // PLAYERCONTROLLER_H
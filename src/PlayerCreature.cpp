@@ -1,6 +1,6 @@
 #include "PlayerCreature.h"
 #include "Coin.h"
-#include "Trigger.h"
+#include "Snapshot.h"
 
 /**
  * PlayerCreature implementation
@@ -19,6 +19,7 @@ PlayerCreature::PlayerCreature(double x, double y, double width, double height,
     Creature(x, y, width, height, health),
     coins(0)
 {
+    setKind(ObjectKind::Player);
     SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "PlayerCreature created!");
 }
 
@@ -31,42 +32,40 @@ PlayerCreature::~PlayerCreature()
 }
 
 /**
- * Function for resolving special cases of collision.
- * If special case is not found, function calls Creature implementation of onCollision.
- * @param collider a pointer to a SolidObject with which MonsterCreature is colliding
+ * Appends state of PlayerCreature to snapshot.
+ * @param snapshot Snapshot that state is appended to
  * @return void
  */
-void PlayerCreature::onCollision(SolidObject* collider)
+void PlayerCreature::saveState(Snapshot& snapshot) const
 {
-    Trigger* tmpT = dynamic_cast<Trigger*>(collider);
-    if (tmpT != nullptr)
-    {
-        if (!tmpT->getDestroyed())
-        {
-            tmpT->trigger();
-        }
-    }
+    Creature::saveState(snapshot);
+    snapshot.write(coins);
+}
 
-	//here do something if got a coin
-	Coin* tmpCoin = dynamic_cast<Coin*>(collider);
-	if (tmpCoin != nullptr)
-	{
-		if (!tmpCoin->getDestroyed())
-		{
-			++coins;
-			tmpCoin->destroy();
-		}
-		return;
-	}
+/**
+ * Reads state of PlayerCreature appended by saveState.
+ * @param snapshot Snapshot that state is read from
+ * @return void
+ */
+void PlayerCreature::loadState(Snapshot& snapshot)
+{
+    Creature::loadState(snapshot);
+    coins = snapshot.read<Uint32>();
+}
 
-	Creature* tmpCreature = dynamic_cast<Creature*>(collider);
-	if (tmpCreature != nullptr)
+/**
+ * Collects touched Coin unless it was already collected.
+ * @param coin a pointer to touched Coin
+ * @return void
+ * @see CollisionDispatcher
+ */
+void PlayerCreature::collectCoin(Coin* coin)
+{
+	if (!coin->getDestroyed())
 	{
-		//if collided with creature, ignore it
-		return;
+		++coins;
+		coin->destroy();
 	}
-
-	Creature::onCollision(collider);
 }
 
 /**
@@ -3,6 +3,8 @@
 
 #include "Creature.h"
 
+class Coin;
+
 /**
  * PlayerCreature is a Creature that should be controlled by Player.
  * It derives from Creature.
@@ -27,14 +29,33 @@ public:
      * Default destructor
      */
 	~PlayerCreature();
+
+    /**
+     * Kind of objects of this class.
+     */
+    static const ObjectKind staticKind = ObjectKind::Player;
+
+    /**
+     * Appends state of PlayerCreature to snapshot.
+     * @param snapshot Snapshot that state is appended to
+     * @return void
+     */
+    void saveState(Snapshot& snapshot) const override;
+
+    /**
+     * Reads state of PlayerCreature appended by saveState.
+     * @param snapshot Snapshot that state is read from
+     * @return void
+     */
+    void loadState(Snapshot& snapshot) override;
     
     /**
-     * Function for resolving special cases of collision.
-     * If special case is not found, function calls Creature implementation of onCollision.
-     * @param collider a pointer to a SolidObject with which MonsterCreature is colliding
+     * Collects touched Coin unless it was already collected.
+     * @param coin a pointer to touched Coin
      * @return void
+     * @see CollisionDispatcher
      */
-    void onCollision(SolidObject* collider) override;
+    void collectCoin(Coin* coin);
 
     /**
      * Get number of collected coins.
@@ -0,0 +1,112 @@
+#ifndef RENDERFRAME_H
+#define RENDERFRAME_H
+
+#include "Game.h"
+#include <vector>
+
+/**
+ * The flags of a drawn object that pick its sprite.
+ * Multiple flags can be combined by treating them as bit fields.
+ * @see RenderObject
+ */
+enum class RenderFlags : Uint8
+{
+    /**
+     * Object doesn't move sideways.
+     */
+    None = 0x0,
+
+    /**
+     * Object moves left.
+     */
+    FacingLeft = 0x1,
+
+    /**
+     * Object moves right.
+     */
+    FacingRight = 0x2,
+
+    /**
+     * Object is a Creature that can't be hurt, so it blinks.
+     */
+    Invulnerable = 0x4
+};
+
+/**
+ * OR operator overload so RenderFlags can be used as a flag field.
+ * @see RenderFlags
+ */
+inline RenderFlags operator| (RenderFlags a, RenderFlags b)
+{
+    return static_cast<RenderFlags>(static_cast<int>(a) | static_cast<int>(b));
+}
+
+/**
+ * AND operator overload so RenderFlags can be used as a flag field.
+ * @see RenderFlags
+ */
+inline RenderFlags operator& (RenderFlags a, RenderFlags b)
+{
+    return static_cast<RenderFlags>(static_cast<int>(a) & static_cast<int>(b));
+}
+
+/**
+ * RenderObject is a struct that holds everything needed to draw a single game object.
+ */
+struct RenderObject
+{
+    float x;           // horizontal position
+    float y;           // vertical position
+    float prevX;       // horizontal position before last step
+    float prevY;       // vertical position before last step
+    float width;       // width
+    float height;      // height
+    ObjectKind kind;   // kind of object
+    RenderFlags flags; // flags that pick sprite
+};
+
+/**
+ * RenderFrame is an immutable copy of game state that is drawn by ViewModel.
+ * It's captured by simulation thread after every update and handed to render thread, so drawing never reads live game objects.
+ * @see Game
+ * @see SimulationThread
+ */
+struct RenderFrame
+{
+    GameState state;                  // state of game
+    bool posUpdated;                  // true if state of game objects changed during last update
+    Uint32 changeVersion;             // increases with every update in which game objects changed
+    bool blinking;                    // true if an object blinks, so frame is redrawn even if nothing changed
+    double posAlpha;                  // coefficient of game state between steps
+    int levelWidth;                   // width of loaded level
+    int levelHeight;                  // height of loaded level
+    Uint32 levelCoins;                // number of coins on loaded level
+    BroadphaseType broadphaseType;    // broadphase used by Physics
+    bool hasPlayer;                   // true if player is alive
+    RenderObject player;              // player, valid if hasPlayer
+    Uint8 playerHealth;               // health of player
+    Uint32 playerCoins;               // coins collected by player
+    std::vector<RenderObject> objects; // objects around player, including player
+
+    /**
+     * The default constructor. Frame shows menu.
+     */
+    RenderFrame() :
+        state(GameState::Menu),
+        posUpdated(false),
+        changeVersion(0),
+        blinking(false),
+        posAlpha(1.0),
+        levelWidth(0),
+        levelHeight(0),
+        levelCoins(0),
+        broadphaseType(BroadphaseType::Tree),
+        hasPlayer(false),
+        player(),
+        playerHealth(0),
+        playerCoins(0)
+    {
+    }
+};
+
+#endif // RENDERFRAME_H
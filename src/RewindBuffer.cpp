@@ -0,0 +1,309 @@
+#include "RewindBuffer.h"
+#include <SDL_log.h>
+#include <SDL_stdinc.h>
+#include <algorithm>
+#include <cstring>
+
+/**
+ * RewindBuffer implementation
+ */
+
+/**
+ * The default constructor.
+ * @param capacity size of ring in bytes
+ * @param duration seconds of simulation that are kept
+ * @param keyframeInterval number of frames after which a keyframe is stored
+ */
+RewindBuffer::RewindBuffer(size_t capacity, double duration, unsigned keyframeInterval) :
+    ring(capacity),
+    duration(duration),
+    keyframeInterval(keyframeInterval),
+    head(0),
+    used(0),
+    sinceKeyframe(0),
+    overflowing(false)
+{
+}
+
+/**
+ * The default destructor.
+ */
+RewindBuffer::~RewindBuffer()
+{
+}
+
+/**
+ * Drops every frame.
+ * @return void
+ */
+void RewindBuffer::clear()
+{
+    frames.clear();
+    head = 0;
+    used = 0;
+    sinceKeyframe = 0;
+    previous.clear();
+}
+
+/**
+ * Stores snapshot as newest frame.
+ * It's stored as a delta against previous frame unless a keyframe is due, size of snapshot changed or delta isn't smaller.
+ * @param snapshot Snapshot of simulation
+ * @param time simulation time of snapshot in seconds
+ * @return void
+ */
+void RewindBuffer::record(Snapshot const& snapshot, double time)
+{
+    //oldest keyframe goes only once the next one is old enough, so at least duration is kept
+    while (!frames.empty())
+    {
+        std::deque<Frame>::const_iterator next = frames.begin() + 1;
+        while (next != frames.end() && !next->keyframe)
+            ++next;
+        if (next == frames.end() || next->time > time - duration)
+            break;
+        dropOldest();
+    }
+
+    unsigned char const* data = snapshot.getData();
+    size_t size = snapshot.getSize();
+    bool keyframe = frames.empty() || sinceKeyframe + 1 >= keyframeInterval || size != previous.size();
+    if (!keyframe)
+    {
+        encodeDelta(data);
+        keyframe = delta.size() >= size;
+    }
+    //delta can't be stored if making room for it drops the frame it's taken against
+    if (!keyframe && !store(delta.data(), delta.size(), time, false))
+        keyframe = true;
+    if (keyframe && !store(data, size, time, true))
+    {
+        if (!overflowing)
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Snapshot of %u bytes doesn't fit into rewind buffer", unsigned(size));
+        clear();
+        overflowing = true;
+        return;
+    }
+    overflowing = false;
+    sinceKeyframe = keyframe ? 0 : sinceKeyframe + 1;
+    previous.assign(data, data + size);
+}
+
+/**
+ * Rebuilds newest frame not newer than given time, keeping every frame.
+ * Oldest frame is rebuilt if every frame is newer.
+ * Nothing is dropped, so a frame that can't be restored doesn't cost history. Call truncate once it was restored.
+ * @param time simulation time in seconds
+ * @param snapshot Snapshot that frame is written to
+ * @return bool true if a frame was rebuilt, false if there are no frames
+ */
+bool RewindBuffer::peek(double time, Snapshot& snapshot)
+{
+    if (frames.empty())
+        return false;
+    rebuild(findFrame(time), rebuilt);
+    snapshot.clear();
+    snapshot.write(rebuilt.data(), rebuilt.size());
+    return true;
+}
+
+/**
+ * Drops every frame after newest frame not newer than given time, so recording goes on from it.
+ * Oldest frame is kept if every frame is newer.
+ * @param time simulation time in seconds
+ * @return void
+ */
+void RewindBuffer::truncate(double time)
+{
+    if (frames.empty())
+        return;
+    size_t last = findFrame(time);
+    while (frames.size() > last + 1)
+    {
+        used -= frames.back().size;
+        frames.pop_back();
+    }
+    head = frames.back().offset + frames.back().size;
+    //next delta is taken against kept frame
+    rebuild(last, previous);
+    size_t first = last;
+    while (!frames[first].keyframe)
+        --first;
+    sinceKeyframe = unsigned(last - first);
+}
+
+/**
+ * Get number of stored frames.
+ * @return size_t
+ */
+size_t RewindBuffer::getFrameCount() const
+{
+    return frames.size();
+}
+
+/**
+ * Get simulation time of oldest frame.
+ * @return double
+ */
+double RewindBuffer::getOldestTime() const
+{
+    return frames.empty() ? 0.0 : frames.front().time;
+}
+
+/**
+ * Get simulation time of newest frame.
+ * @return double
+ */
+double RewindBuffer::getNewestTime() const
+{
+    return frames.empty() ? 0.0 : frames.back().time;
+}
+
+/**
+ * Get number of bytes of ring used by frames.
+ * @return size_t
+ */
+size_t RewindBuffer::getUsed() const
+{
+    return used;
+}
+
+/**
+ * Get size of ring in bytes.
+ * @return size_t
+ */
+size_t RewindBuffer::getCapacity() const
+{
+    return ring.size();
+}
+
+/**
+ * Encodes runs of bytes that differ between previous and current into delta.
+ * Every run is its offset and length as Uint32 followed by its bytes. Runs separated by fewer bytes than a run header are merged.
+ * Equal blocks are skipped with memcmp, so unchanged parts of snapshot cost little.
+ * @param current bytes of new frame, as many as previous has
+ * @return void
+ */
+void RewindBuffer::encodeDelta(unsigned char const* current)
+{
+    const size_t block = 64;
+    const size_t header = 2 * sizeof(Uint32);
+    size_t size = previous.size();
+    unsigned char const* old = previous.data();
+    delta.clear();
+    size_t i = 0;
+    while (i < size)
+    {
+        while (i + block <= size && std::memcmp(old + i, current + i, block) == 0)
+            i += block;
+        while (i < size && old[i] == current[i])
+            ++i;
+        if (i == size)
+            break;
+        size_t start = i;
+        size_t end = i + 1;
+        for (i = end; i < size && i - end < header; ++i)
+            if (old[i] != current[i])
+                end = i + 1;
+        Uint32 run[2] = { Uint32(start), Uint32(end - start) };
+        delta.insert(delta.end(), reinterpret_cast<unsigned char const*>(run), reinterpret_cast<unsigned char const*>(run) + header);
+        delta.insert(delta.end(), current + start, current + end);
+        i = end;
+    }
+}
+
+/**
+ * Applies delta stored in ring to bytes of frame before it.
+ * @param frame frame that holds delta
+ * @param bytes bytes of frame before it, changed in place
+ * @return void
+ */
+void RewindBuffer::applyDelta(Frame const& frame, std::vector<unsigned char>& bytes) const
+{
+    unsigned char const* position = ring.data() + frame.offset;
+    unsigned char const* end = position + frame.size;
+    while (position < end)
+    {
+        Uint32 run[2];
+        std::memcpy(run, position, sizeof(run));
+        position += sizeof(run);
+        std::memcpy(bytes.data() + run[0], position, run[1]);
+        position += run[1];
+    }
+}
+
+/**
+ * Copies a frame into ring, dropping oldest frames that are in the way.
+ * Frames are laid out one after another, a frame that doesn't fit before end of ring goes to its beginning.
+ * @param data bytes of frame
+ * @param size number of bytes
+ * @param time simulation time of frame
+ * @param keyframe true if frame holds whole Snapshot
+ * @return bool false if frame doesn't fit into ring at all, or if it's a delta and the frame it's taken against had to be dropped
+ */
+bool RewindBuffer::store(unsigned char const* data, size_t size, double time, bool keyframe)
+{
+    if (size > ring.size())
+        return false;
+    size_t offset = head;
+    if (offset + size > ring.size())
+    {
+        //frames after head are the oldest ones, space after them is left unused
+        while (!frames.empty() && frames.front().offset >= head)
+            dropOldest();
+        offset = 0;
+    }
+    //oldest frame is the first one after offset
+    while (!frames.empty() && offset < frames.front().offset + frames.front().size && frames.front().offset < offset + size)
+        dropOldest();
+    if (frames.empty() && !keyframe)
+        return false;
+    std::memcpy(ring.data() + offset, data, size);
+    Frame frame = { time, offset, size, keyframe };
+    frames.push_back(frame);
+    head = offset + size;
+    used += size;
+    return true;
+}
+
+/**
+ * Drops oldest keyframe together with deltas that depend on it.
+ * @return void
+ */
+void RewindBuffer::dropOldest()
+{
+    do
+    {
+        used -= frames.front().size;
+        frames.pop_front();
+    } while (!frames.empty() && !frames.front().keyframe);
+}
+
+/**
+ * Finds newest frame not newer than given time, or oldest frame if every frame is newer.
+ * @param time simulation time in seconds
+ * @return size_t index of frame, there has to be at least one
+ */
+size_t RewindBuffer::findFrame(double time) const
+{
+    size_t last = size_t(std::upper_bound(frames.begin(), frames.end(), time,
+        [](double time, Frame const& frame){ return time < frame.time; }) - frames.begin());
+    return last > 0 ? last - 1 : 0;
+}
+
+/**
+ * Rebuilds bytes of a frame from keyframe before it and deltas up to it.
+ * @param last index of frame
+ * @param bytes list that bytes of frame are written to
+ * @return void
+ */
+void RewindBuffer::rebuild(size_t last, std::vector<unsigned char>& bytes) const
+{
+    //oldest frame is always a keyframe
+    size_t first = last;
+    while (!frames[first].keyframe)
+        --first;
+    bytes.assign(ring.begin() + frames[first].offset, ring.begin() + frames[first].offset + frames[first].size);
+    for (size_t i = first + 1; i <= last; ++i)
+        applyDelta(frames[i], bytes);
+}
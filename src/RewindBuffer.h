@@ -0,0 +1,211 @@
+#ifndef REWINDBUFFER_H
+#define REWINDBUFFER_H
+
+#include "Snapshot.h"
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+/**
+ * RewindBuffer keeps recent Snapshots of simulation in a ring of fixed size, so game can be rewound.
+ * Most frames are stored as deltas: runs of bytes that changed since previous frame. Every few frames a keyframe
+ * holds a whole Snapshot, so a frame is rebuilt from nearest keyframe before it. A keyframe is also stored whenever
+ * size of Snapshot changes, because objects were created or destroyed and layout of bytes moved.
+ * Frames are dropped from the oldest side, a keyframe together with its deltas, once they are older than kept duration
+ * or their memory is needed. Memory used never exceeds the ring and two Snapshots worth of scratch space.
+ * @see Snapshot
+ * @see Game
+ */
+class RewindBuffer
+{
+public:
+    /**
+     * The default constructor.
+     * @param capacity size of ring in bytes
+     * @param duration seconds of simulation that are kept
+     * @param keyframeInterval number of frames after which a keyframe is stored
+     */
+    RewindBuffer(size_t capacity, double duration, unsigned keyframeInterval);
+
+    /**
+     * The default destructor.
+     */
+    ~RewindBuffer();
+
+    /**
+     * Drops every frame.
+     * @return void
+     */
+    void clear();
+
+    /**
+     * Stores snapshot as newest frame.
+     * @param snapshot Snapshot of simulation
+     * @param time simulation time of snapshot in seconds
+     * @return void
+     */
+    void record(Snapshot const& snapshot, double time);
+
+    /**
+     * Rebuilds newest frame not newer than given time, keeping every frame.
+     * Oldest frame is rebuilt if every frame is newer.
+     * @param time simulation time in seconds
+     * @param snapshot Snapshot that frame is written to
+     * @return bool true if a frame was rebuilt, false if there are no frames
+     */
+    bool peek(double time, Snapshot& snapshot);
+
+    /**
+     * Drops every frame after newest frame not newer than given time, so recording goes on from it.
+     * Oldest frame is kept if every frame is newer.
+     * @param time simulation time in seconds
+     * @return void
+     */
+    void truncate(double time);
+
+    /**
+     * Get number of stored frames.
+     * @return size_t
+     */
+    size_t getFrameCount() const;
+
+    /**
+     * Get simulation time of oldest frame.
+     * @return double
+     */
+    double getOldestTime() const;
+
+    /**
+     * Get simulation time of newest frame.
+     * @return double
+     */
+    double getNewestTime() const;
+
+    /**
+     * Get number of bytes of ring used by frames.
+     * @return size_t
+     */
+    size_t getUsed() const;
+
+    /**
+     * Get size of ring in bytes.
+     * @return size_t
+     */
+    size_t getCapacity() const;
+
+private:
+    /**
+     * Frame is a struct that holds position of a single frame in ring.
+     */
+    struct Frame
+    {
+        double time;   // simulation time of frame
+        size_t offset; // position of frame in ring
+        size_t size;   // size of frame in bytes
+        bool keyframe; // true if frame holds whole Snapshot, false if it holds a delta
+    };
+
+    /**
+     * Memory of frames.
+     */
+    std::vector<unsigned char> ring;
+
+    /**
+     * Seconds of simulation that are kept.
+     */
+    const double duration;
+
+    /**
+     * Number of frames after which a keyframe is stored.
+     */
+    const unsigned keyframeInterval;
+
+    /**
+     * Stored frames from oldest to newest.
+     */
+    std::deque<Frame> frames;
+
+    /**
+     * Position in ring after newest frame.
+     */
+    size_t head;
+
+    /**
+     * Number of bytes used by frames.
+     */
+    size_t used;
+
+    /**
+     * Number of deltas stored since last keyframe.
+     */
+    unsigned sinceKeyframe;
+
+    /**
+     * True if last recorded snapshot didn't fit into ring.
+     */
+    bool overflowing;
+
+    /**
+     * Bytes of newest frame, which next delta is taken against.
+     */
+    std::vector<unsigned char> previous;
+
+    /**
+     * Scratch space for encoded delta.
+     */
+    std::vector<unsigned char> delta;
+
+    /**
+     * Scratch space for frame rebuilt by peek.
+     */
+    std::vector<unsigned char> rebuilt;
+
+    /**
+     * Finds newest frame not newer than given time, or oldest frame if every frame is newer.
+     * @param time simulation time in seconds
+     * @return size_t index of frame, there has to be at least one
+     */
+    size_t findFrame(double time) const;
+
+    /**
+     * Rebuilds bytes of a frame from keyframe before it and deltas up to it.
+     * @param last index of frame
+     * @param bytes list that bytes of frame are written to
+     * @return void
+     */
+    void rebuild(size_t last, std::vector<unsigned char>& bytes) const;
+
+    /**
+     * Encodes runs of bytes that differ between previous and current into delta.
+     * Runs separated by fewer bytes than a run header are merged.
+     * @param current bytes of new frame, as many as previous has
+     * @return void
+     */
+    void encodeDelta(unsigned char const* current);
+
+    /**
+     * Applies delta stored in ring to bytes of frame before it.
+     * @param frame frame that holds delta
+     * @param bytes bytes of frame before it, changed in place
+     * @return void
+     */
+    void applyDelta(Frame const& frame, std::vector<unsigned char>& bytes) const;
+
+    /**
+     * Copies a frame into ring, dropping oldest frames that are in the way.
+     * @param data bytes of frame
+     * @param size number of bytes
+     * @param time simulation time of frame
+     * @param keyframe true if frame holds whole Snapshot
+     * @return bool false if frame doesn't fit into ring at all, or if it's a delta and the frame it's taken against had to be dropped
+     */
+    bool store(unsigned char const* data, size_t size, double time, bool keyframe);
+
+    /**
+     * Drops oldest keyframe together with deltas that depend on it.
+     * @return void
+     */
+    void dropOldest();
+};
+
+#endif // REWINDBUFFER_H
@@ -0,0 +1,232 @@
+#ifndef SIMDLANES_H
+#define SIMDLANES_H
+
+/**
+ * Thin wrappers over SIMD registers holding doubles, so integration kernels can be written once.
+ * Lanes is the widest set of registers available for the target (AVX, SSE2 or plain double),
+ * ScalarLanes always holds a single double and is used for leftover elements.
+ */
+
+#if defined(__AVX__) || defined(__AVX2__)
+#include <immintrin.h>
+#define SIMDLANES_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIMDLANES_SSE2
+#endif
+
+/**
+ * ScalarLanes is a single double with the same interface as Lanes.
+ */
+struct ScalarLanes
+{
+    /**
+     * Number of doubles processed at once.
+     */
+    static int const width = 1;
+
+    /**
+     * Held value.
+     */
+    double v;
+
+    /**
+     * The default constructor. Lanes are left uninitialized, like a plain double.
+     */
+    ScalarLanes() {}
+
+    /**
+     * Constructor that sets every lane to the same value.
+     * @param value value of every lane
+     */
+    explicit ScalarLanes(double value) : v(value) {}
+
+    /**
+     * Loads width consecutive doubles, which don't have to be aligned.
+     * @param p a constant pointer to first double
+     * @return ScalarLanes
+     */
+    static ScalarLanes load(double const* p) { return ScalarLanes(*p); }
+
+    /**
+     * Stores lanes to width consecutive doubles, which don't have to be aligned.
+     * @param p a pointer to first double
+     * @return void
+     */
+    void store(double* p) const { *p = v; }
+
+    /**
+     * Adds lanes of a and b, lane by lane.
+     * @param a left operand
+     * @param b right operand
+     * @return ScalarLanes
+     */
+    friend ScalarLanes operator+(ScalarLanes a, ScalarLanes b) { return ScalarLanes(a.v + b.v); }
+
+    /**
+     * Subtracts lanes of b from lanes of a, lane by lane.
+     * @param a left operand
+     * @param b right operand
+     * @return ScalarLanes
+     */
+    friend ScalarLanes operator-(ScalarLanes a, ScalarLanes b) { return ScalarLanes(a.v - b.v); }
+
+    /**
+     * Multiplies lanes of a and b, lane by lane.
+     * @param a left operand
+     * @param b right operand
+     * @return ScalarLanes
+     */
+    friend ScalarLanes operator*(ScalarLanes a, ScalarLanes b) { return ScalarLanes(a.v * b.v); }
+};
+
+#if defined(SIMDLANES_AVX)
+/**
+ * Lanes holds four doubles in an AVX register.
+ */
+struct Lanes
+{
+    /**
+     * Number of doubles processed at once.
+     */
+    static int const width = 4;
+
+    /**
+     * AVX register that holds the four doubles.
+     */
+    __m256d v;
+
+    /**
+     * The default constructor. Lanes are left uninitialized, like a plain double.
+     */
+    Lanes() {}
+
+    /**
+     * Constructor that sets every lane to the same value.
+     * @param value value of every lane
+     */
+    explicit Lanes(double value) : v(_mm256_set1_pd(value)) {}
+
+    /**
+     * Constructor that wraps a register, so results of intrinsics convert to Lanes.
+     * @param value register that is held
+     */
+    Lanes(__m256d value) : v(value) {}
+
+    /**
+     * Loads width consecutive doubles, which don't have to be aligned.
+     * @param p a constant pointer to first double
+     * @return Lanes
+     */
+    static Lanes load(double const* p) { return Lanes(_mm256_loadu_pd(p)); }
+
+    /**
+     * Stores lanes to width consecutive doubles, which don't have to be aligned.
+     * @param p a pointer to first double
+     * @return void
+     */
+    void store(double* p) const { _mm256_storeu_pd(p, v); }
+
+    /**
+     * Adds lanes of a and b, lane by lane.
+     * @param a left operand
+     * @param b right operand
+     * @return Lanes
+     */
+    friend Lanes operator+(Lanes a, Lanes b) { return Lanes(_mm256_add_pd(a.v, b.v)); }
+
+    /**
+     * Subtracts lanes of b from lanes of a, lane by lane.
+     * @param a left operand
+     * @param b right operand
+     * @return Lanes
+     */
+    friend Lanes operator-(Lanes a, Lanes b) { return Lanes(_mm256_sub_pd(a.v, b.v)); }
+
+    /**
+     * Multiplies lanes of a and b, lane by lane.
+     * @param a left operand
+     * @param b right operand
+     * @return Lanes
+     */
+    friend Lanes operator*(Lanes a, Lanes b) { return Lanes(_mm256_mul_pd(a.v, b.v)); }
+};
+#elif defined(SIMDLANES_SSE2)
+/**
+ * Lanes holds two doubles in an SSE2 register.
+ */
+struct Lanes
+{
+    /**
+     * Number of doubles processed at once.
+     */
+    static int const width = 2;
+
+    /**
+     * SSE2 register that holds the two doubles.
+     */
+    __m128d v;
+
+    /**
+     * The default constructor. Lanes are left uninitialized, like a plain double.
+     */
+    Lanes() {}
+
+    /**
+     * Constructor that sets every lane to the same value.
+     * @param value value of every lane
+     */
+    explicit Lanes(double value) : v(_mm_set1_pd(value)) {}
+
+    /**
+     * Constructor that wraps a register, so results of intrinsics convert to Lanes.
+     * @param value register that is held
+     */
+    Lanes(__m128d value) : v(value) {}
+
+    /**
+     * Loads width consecutive doubles, which don't have to be aligned.
+     * @param p a constant pointer to first double
+     * @return Lanes
+     */
+    static Lanes load(double const* p) { return Lanes(_mm_loadu_pd(p)); }
+
+    /**
+     * Stores lanes to width consecutive doubles, which don't have to be aligned.
+     * @param p a pointer to first double
+     * @return void
+     */
+    void store(double* p) const { _mm_storeu_pd(p, v); }
+
+    /**
+     * Adds lanes of a and b, lane by lane.
+     * @param a left operand
+     * @param b right operand
+     * @return Lanes
+     */
+    friend Lanes operator+(Lanes a, Lanes b) { return Lanes(_mm_add_pd(a.v, b.v)); }
+
+    /**
+     * Subtracts lanes of b from lanes of a, lane by lane.
+     * @param a left operand
+     * @param b right operand
+     * @return Lanes
+     */
+    friend Lanes operator-(Lanes a, Lanes b) { return Lanes(_mm_sub_pd(a.v, b.v)); }
+
+    /**
+     * Multiplies lanes of a and b, lane by lane.
+     * @param a left operand
+     * @param b right operand
+     * @return Lanes
+     */
+    friend Lanes operator*(Lanes a, Lanes b) { return Lanes(_mm_mul_pd(a.v, b.v)); }
+};
+#else
+/**
+ * Without SIMD support Lanes falls back to a single double.
+ */
+typedef ScalarLanes Lanes;
+#endif
+
+#endif // SIMDLANES_H
@@ -0,0 +1,221 @@
+#include "SimulationThread.h"
+#include <SDL_log.h>
+#include <SDL_timer.h>
+
+/**
+ * SimulationThread implementation
+ */
+
+/**
+ * The default constructor. Publishes first frame and starts thread.
+ * @param game a pointer to Game that is run, it can't be used by anything else until SimulationThread is destroyed
+ * @param viewWidth width of view that frames are captured around
+ * @param viewHeight height of view that frames are captured around
+ */
+SimulationThread::SimulationThread(Game* game, double viewWidth, double viewHeight) :
+    game(game),
+    viewWidth(viewWidth),
+    viewHeight(viewHeight),
+    stopping(false),
+    ended(false)
+{
+    game->setInputSource(&input);
+    game->captureFrame(frames.getBack(), viewWidth, viewHeight);
+    frames.publish();
+    thread = std::thread(&SimulationThread::run, this);
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "SimulationThread created!");
+}
+
+/**
+ * The default destructor. Stops thread and gives input of Game back to keyboard.
+ */
+SimulationThread::~SimulationThread()
+{
+    stopping = true;
+    thread.join();
+    game->setInputSource(nullptr);
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "SimulationThread destroyed!");
+}
+
+/**
+ * Sends a command to Game. Can be called from any thread.
+ * @param command GameCommand applied before next update
+ * @return void
+ */
+void SimulationThread::send(GameCommand const& command)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    sent.push_back(command);
+}
+
+/**
+ * Changes buttons that Game reads. Can be called from any thread.
+ * @param buttons buttons held by player
+ * @return void
+ */
+void SimulationThread::setButtons(InputButton buttons)
+{
+    input.buttons = Uint8(buttons);
+}
+
+/**
+ * Takes newest published frame. Only render thread can call it.
+ * @return bool true if a new frame was taken
+ */
+bool SimulationThread::acquireFrame()
+{
+    return frames.acquire();
+}
+
+/**
+ * Get frame taken by acquireFrame. Only render thread can call it.
+ * @return RenderFrame const&
+ */
+RenderFrame const& SimulationThread::getFrame() const
+{
+    return frames.getFront();
+}
+
+/**
+ * Check if game has ended and thread has stopped.
+ * @return bool
+ */
+bool SimulationThread::getHasEnded() const
+{
+    return ended;
+}
+
+/**
+ * Rethrows exception that stopped thread, if there was one. Only render thread can call it, once game has ended.
+ * @return void
+ */
+void SimulationThread::rethrowError() const
+{
+    if (ended && error)
+        std::rethrow_exception(error);
+}
+
+/**
+ * Runs loop of thread, catching any exception so it can be rethrown on render thread.
+ * An exception escaping thread would terminate program before main can handle it.
+ * @return void
+ */
+void SimulationThread::run()
+{
+    try
+    {
+        loop();
+    }
+    catch (...)
+    {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "SimulationThread stopped by an exception");
+        error = std::current_exception();
+        ended = true;
+    }
+}
+
+/**
+ * Loop of thread that runs Game.
+ * Commands are taken under lock by swapping lists, so render thread waits only for the swap.
+ * @return void
+ */
+void SimulationThread::loop()
+{
+    while (!stopping)
+    {
+        Uint32 start = SDL_GetTicks();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            taken.swap(sent);
+        }
+        for (size_t i = 0; i < taken.size(); ++i)
+            apply(taken[i]);
+        taken.clear();
+
+        game->gameLoop();
+        game->captureFrame(frames.getBack(), viewWidth, viewHeight);
+        frames.publish();
+        if (game->getHasEnded())
+        {
+            ended = true;
+            return;
+        }
+
+        //sleep for the rest of timestep
+        Uint32 period = Uint32(game->getPhysicsTimestep() * 1000.0);
+        Uint32 elapsed = SDL_GetTicks() - start;
+        if (elapsed < period)
+            SDL_Delay(period - elapsed);
+    }
+}
+
+/**
+ * Applies a command to Game.
+ * @param command applied GameCommand
+ * @return void
+ */
+void SimulationThread::apply(GameCommand const& command)
+{
+    switch (command.type)
+    {
+    case GameCommandType::GameOver:
+        game->gameOver();
+        return;
+    case GameCommandType::SetView:
+        game->setView(command.first, command.second);
+        return;
+    case GameCommandType::SetViewSize:
+        viewWidth = command.first;
+        viewHeight = command.second;
+        return;
+    case GameCommandType::SetBroadphase:
+        game->setBroadphaseType(BroadphaseType(int(command.first)));
+        return;
+    default:
+        break;
+    }
+    //game has moved on since command was sent
+    if (command.state != game->getGameState())
+        return;
+    switch (command.type)
+    {
+    case GameCommandType::StartGame:
+        game->startGame();
+        break;
+    case GameCommandType::PauseGame:
+        game->pauseGame();
+        break;
+    case GameCommandType::ResumeGame:
+        game->resumeGame();
+        break;
+    case GameCommandType::QuitToMenu:
+        game->quitToMenu();
+        break;
+    case GameCommandType::Rewind:
+        game->rewind(command.first);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * SharedInput implementation
+ */
+
+/**
+ * The default constructor.
+ */
+SimulationThread::SharedInput::SharedInput() :
+    buttons(0)
+{
+}
+
+/**
+ * Get buttons that were set last.
+ * @return InputButton
+ */
+InputButton SimulationThread::SharedInput::getButtons()
+{
+    return InputButton(buttons.load());
+}
@@ -0,0 +1,250 @@
+#ifndef SIMULATIONTHREAD_H
+#define SIMULATIONTHREAD_H
+
+#include "Game.h"
+#include "InputSource.h"
+#include "RenderFrame.h"
+#include "TripleBuffer.h"
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * The types of commands that render thread sends to Game.
+ * @see GameCommand
+ */
+enum class GameCommandType
+{
+    /**
+     * Calls Game::startGame.
+     */
+    StartGame,
+
+    /**
+     * Calls Game::pauseGame.
+     */
+    PauseGame,
+
+    /**
+     * Calls Game::resumeGame.
+     */
+    ResumeGame,
+
+    /**
+     * Calls Game::quitToMenu.
+     */
+    QuitToMenu,
+
+    /**
+     * Calls Game::gameOver, whatever state game is in.
+     */
+    GameOver,
+
+    /**
+     * Calls Game::rewind with first value as seconds.
+     */
+    Rewind,
+
+    /**
+     * Calls Game::setView with first and second value as edges of view, whatever state game is in.
+     */
+    SetView,
+
+    /**
+     * Changes size of view that frames are captured around to first and second value, whatever state game is in.
+     */
+    SetViewSize,
+
+    /**
+     * Calls Game::setBroadphaseType with first value as BroadphaseType, whatever state game is in.
+     */
+    SetBroadphase
+};
+
+/**
+ * GameCommand is a struct that holds a single call that render thread asks simulation thread to make.
+ * Commands that change state of game are dropped if game has left the state they were sent in,
+ * so a command sent while looking at an old frame can't act on a game that has moved on.
+ */
+struct GameCommand
+{
+    GameCommandType type; // what to call
+    GameState state;      // state of game shown in frame when command was sent
+    double first;         // first argument
+    double second;        // second argument
+};
+
+/**
+ * SimulationThread runs Game on its own thread, so drawing and presenting frames don't delay steps of Physics.
+ * Every update is followed by a RenderFrame published through a TripleBuffer, which render thread takes without waiting.
+ * Render thread never touches Game: it sends GameCommands, which are applied before next update, and buttons, which Game reads as its InputSource.
+ * Thread sleeps for the rest of timestep after every update, so every update usually takes a single step of Physics.
+ * @see Game
+ * @see ViewModel
+ */
+class SimulationThread
+{
+public:
+    /**
+     * The default constructor. Publishes first frame and starts thread.
+     * @param game a pointer to Game that is run, it can't be used by anything else until SimulationThread is destroyed
+     * @param viewWidth width of view that frames are captured around
+     * @param viewHeight height of view that frames are captured around
+     */
+    SimulationThread(Game* game, double viewWidth, double viewHeight);
+
+    /**
+     * The default destructor. Stops thread and gives input of Game back to keyboard.
+     */
+    ~SimulationThread();
+
+    /**
+     * Sends a command to Game. Can be called from any thread.
+     * @param command GameCommand applied before next update
+     * @return void
+     */
+    void send(GameCommand const& command);
+
+    /**
+     * Changes buttons that Game reads. Can be called from any thread.
+     * @param buttons buttons held by player
+     * @return void
+     */
+    void setButtons(InputButton buttons);
+
+    /**
+     * Takes newest published frame. Only render thread can call it.
+     * @return bool true if a new frame was taken
+     */
+    bool acquireFrame();
+
+    /**
+     * Get frame taken by acquireFrame. Only render thread can call it.
+     * @return RenderFrame const&
+     */
+    RenderFrame const& getFrame() const;
+
+    /**
+     * Check if game has ended and thread has stopped.
+     * @return bool
+     */
+    bool getHasEnded() const;
+
+    /**
+     * Rethrows exception that stopped thread, if there was one. Only render thread can call it, once game has ended.
+     * @return void
+     */
+    void rethrowError() const;
+
+    /**
+     * Assignment operator is deleted because SimulationThread owns a thread.
+     */
+    SimulationThread& operator=(SimulationThread const&) = delete;
+
+private:
+    /**
+     * SharedInput is an InputSource that holds buttons set by another thread.
+     */
+    class SharedInput: public InputSource
+    {
+    public:
+        /**
+         * The default constructor.
+         */
+        SharedInput();
+
+        /**
+         * Get buttons that were set last.
+         * @return InputButton
+         */
+        InputButton getButtons() override;
+
+        /**
+         * Buttons held by player.
+         */
+        std::atomic<Uint8> buttons;
+    };
+
+    /**
+     * A pointer to Game that is run.
+     */
+    Game* const game;
+
+    /**
+     * Buttons handed to Game.
+     */
+    SharedInput input;
+
+    /**
+     * Frames handed to render thread.
+     */
+    TripleBuffer<RenderFrame> frames;
+
+    /**
+     * Width of view that frames are captured around. Used only by simulation thread.
+     */
+    double viewWidth;
+
+    /**
+     * Height of view that frames are captured around. Used only by simulation thread.
+     */
+    double viewHeight;
+
+    /**
+     * Mutex that guards sent commands.
+     */
+    std::mutex mutex;
+
+    /**
+     * Commands sent since last update.
+     */
+    std::vector<GameCommand> sent;
+
+    /**
+     * Commands taken by simulation thread, reused by every update.
+     */
+    std::vector<GameCommand> taken;
+
+    /**
+     * True if thread should stop.
+     */
+    std::atomic<bool> stopping;
+
+    /**
+     * True if game has ended and thread has stopped.
+     */
+    std::atomic<bool> ended;
+
+    /**
+     * Exception that stopped thread, empty if it stopped normally. Written before ended is set.
+     */
+    std::exception_ptr error;
+
+    /**
+     * Thread that runs Game.
+     */
+    std::thread thread;
+
+    /**
+     * Runs loop of thread, catching any exception so it can be rethrown on render thread.
+     * @return void
+     */
+    void run();
+
+    /**
+     * Loop of thread that runs Game.
+     * @return void
+     */
+    void loop();
+
+    /**
+     * Applies a command to Game.
+     * @param command applied GameCommand
+     * @return void
+     */
+    void apply(GameCommand const& command);
+};
+
+#endif // SIMULATIONTHREAD_H
@@ -0,0 +1,121 @@
+#include "Snapshot.h"
+#include <SDL_log.h>
+
+/**
+ * Snapshot implementation
+ */
+
+/**
+ * The default constructor.
+ * @param capacity number of bytes allocated up front. Defaults to 64 KiB
+ */
+Snapshot::Snapshot(size_t capacity) :
+    buffer(capacity),
+    size(0),
+    readPosition(0),
+    overrun(false)
+{
+}
+
+/**
+ * The default destructor.
+ */
+Snapshot::~Snapshot()
+{
+}
+
+/**
+ * Forgets written state, keeping allocated memory.
+ * @return void
+ */
+void Snapshot::clear()
+{
+    size = 0;
+    readPosition = 0;
+    overrun = false;
+}
+
+/**
+ * Appends bytes to snapshot. Buffer grows if it's full.
+ * @param data a pointer to bytes
+ * @param size number of bytes
+ * @return void
+ */
+void Snapshot::write(void const* data, size_t size)
+{
+    if (this->size + size > buffer.size())
+    {
+        size_t capacity = buffer.size() * 2;
+        if (capacity < this->size + size)
+            capacity = this->size + size;
+        SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Snapshot grows to %u bytes", unsigned(capacity));
+        buffer.resize(capacity);
+    }
+    std::memcpy(&buffer[this->size], data, size);
+    this->size += size;
+}
+
+/**
+ * Moves reading back to the beginning of snapshot.
+ * @return void
+ */
+void Snapshot::rewind()
+{
+    readPosition = 0;
+    overrun = false;
+}
+
+/**
+ * Reads bytes at reading position and moves it forward.
+ * Bytes past written state are read as zeroes and mark snapshot as overrun.
+ * @param data a pointer to memory that bytes are copied to
+ * @param size number of bytes
+ * @return void
+ */
+void Snapshot::read(void* data, size_t size)
+{
+    if (readPosition + size > this->size)
+    {
+        std::memset(data, 0, size);
+        overrun = true;
+        return;
+    }
+    std::memcpy(data, &buffer[readPosition], size);
+    readPosition += size;
+}
+
+/**
+ * Get number of written bytes.
+ * @return size_t
+ */
+size_t Snapshot::getSize() const
+{
+    return size;
+}
+
+/**
+ * Get number of allocated bytes.
+ * @return size_t
+ */
+size_t Snapshot::getCapacity() const
+{
+    return buffer.size();
+}
+
+/**
+ * Get raw written bytes.
+ * @return unsigned char const*
+ */
+unsigned char const* Snapshot::getData() const
+{
+    return buffer.data();
+}
+
+/**
+ * Check if something was read past written state since last rewind.
+ * @return bool
+ */
+bool Snapshot::getOverrun() const
+{
+    return overrun;
+}
@@ -0,0 +1,127 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+/**
+ * Snapshot is a flat byte buffer that holds state of a whole simulation.
+ * Values are appended with memcpy and read back in the same order, there is no per-value tagging.
+ * Buffer is allocated up front and reused by every capture, so capturing every step doesn't allocate once it's big enough.
+ * Snapshot is only meant to be restored by the same build of the game that captured it.
+ * @see Game
+ */
+class Snapshot
+{
+public:
+    /**
+     * The default constructor.
+     * @param capacity number of bytes allocated up front. Defaults to 64 KiB
+     */
+    Snapshot(size_t capacity = 64 * 1024);
+
+    /**
+     * The default destructor.
+     */
+    ~Snapshot();
+
+    /**
+     * Forgets written state, keeping allocated memory.
+     * @return void
+     */
+    void clear();
+
+    /**
+     * Appends bytes to snapshot. Buffer grows if it's full.
+     * @param data a pointer to bytes
+     * @param size number of bytes
+     * @return void
+     */
+    void write(void const* data, size_t size);
+
+    /**
+     * Appends a value of a trivially copyable type.
+     * @param value written value
+     * @return void
+     */
+    template <class T>
+    void write(T const& value)
+    {
+        write(&value, sizeof(T));
+    }
+
+    /**
+     * Moves reading back to the beginning of snapshot.
+     * @return void
+     */
+    void rewind();
+
+    /**
+     * Reads bytes at reading position and moves it forward.
+     * Bytes past written state are read as zeroes and mark snapshot as overrun.
+     * @param data a pointer to memory that bytes are copied to
+     * @param size number of bytes
+     * @return void
+     */
+    void read(void* data, size_t size);
+
+    /**
+     * Reads a value of a trivially copyable type.
+     * @return T
+     */
+    template <class T>
+    T read()
+    {
+        T value;
+        read(&value, sizeof(T));
+        return value;
+    }
+
+    /**
+     * Get number of written bytes.
+     * @return size_t
+     */
+    size_t getSize() const;
+
+    /**
+     * Get number of allocated bytes.
+     * @return size_t
+     */
+    size_t getCapacity() const;
+
+    /**
+     * Get raw written bytes.
+     * @return unsigned char const*
+     */
+    unsigned char const* getData() const;
+
+    /**
+     * Check if something was read past written state since last rewind.
+     * @return bool
+     */
+    bool getOverrun() const;
+
+private:
+    /**
+     * Allocated memory, its size is the capacity.
+     */
+    std::vector<unsigned char> buffer;
+
+    /**
+     * Number of written bytes.
+     */
+    size_t size;
+
+    /**
+     * Position of next read.
+     */
+    size_t readPosition;
+
+    /**
+     * True if something was read past written state.
+     */
+    bool overrun;
+};
+
+#endif // SNAPSHOT_H
@@ -14,6 +14,7 @@
 SolidObject::SolidObject(double x, double y, double width, double height):
 	Object(x,y,width,height)
 {
+    setKind(ObjectKind::Solid);
 }
 
 /**
@@ -23,6 +23,11 @@ public:
      * The default destructor.
      */
     virtual ~SolidObject();
+
+    /**
+     * Kind of objects of this class.
+     */
+    static const ObjectKind staticKind = ObjectKind::Solid;
 };
 
 #endif // SOLIDOBJECT_H
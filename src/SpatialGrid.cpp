@@ -0,0 +1,161 @@
+#include "SpatialGrid.h"
+#include <SDL_log.h>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * SpatialGrid implementation
+ */
+
+/**
+ * The default constructor.
+ * @param cellSize width and height of a single cell. Defaults to 4.0
+ */
+SpatialGrid::SpatialGrid(double cellSize) :
+    cellSize(cellSize),
+    originX(0.0),
+    originY(0.0),
+    columns(0),
+    rows(0)
+{
+}
+
+/**
+ * The default destructor.
+ */
+SpatialGrid::~SpatialGrid()
+{
+}
+
+/**
+ * Builds grid over given objects. Grid covers bounding box of all objects.
+ * @param objects a list of objects that should be indexed
+ * @return void
+ */
+void SpatialGrid::build(std::vector<SolidObject*> const& objects)
+{
+    entries.clear();
+    cellStart.clear();
+    cellEntries.clear();
+    entryIndex.clear();
+    columns = 0;
+    rows = 0;
+    if (objects.empty())
+        return;
+
+    double maxX = objects.front()->getX() + objects.front()->getWidth();
+    double maxY = objects.front()->getY() + objects.front()->getHeight();
+    originX = objects.front()->getX();
+    originY = objects.front()->getY();
+    for (std::vector<SolidObject*>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+    {
+        originX = std::min(originX, (*it)->getX());
+        originY = std::min(originY, (*it)->getY());
+        maxX = std::max(maxX, (*it)->getX() + (*it)->getWidth());
+        maxY = std::max(maxY, (*it)->getY() + (*it)->getHeight());
+    }
+    columns = std::max(1, int(std::ceil((maxX - originX) / cellSize)));
+    rows = std::max(1, int(std::ceil((maxY - originY) / cellSize)));
+
+    //count objects in every cell, then turn counts into offsets
+    cellStart.assign(columns * rows + 1, 0);
+    entries.reserve(objects.size());
+    for (std::vector<SolidObject*>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+    {
+        GridEntry entry = { *it, getColumn((*it)->getX()), getRow((*it)->getY()) };
+        int maxColumn = getColumn((*it)->getX() + (*it)->getWidth());
+        int maxRow = getRow((*it)->getY() + (*it)->getHeight());
+        for (int row = entry.minRow; row <= maxRow; ++row)
+            for (int column = entry.minColumn; column <= maxColumn; ++column)
+                ++cellStart[row * columns + column + 1];
+        entryIndex[*it] = unsigned(entries.size());
+        entries.push_back(entry);
+    }
+    for (size_t i = 1; i < cellStart.size(); ++i)
+        cellStart[i] += cellStart[i - 1];
+
+    //fill cells
+    std::vector<unsigned> cellFill(cellStart.begin(), cellStart.end() - 1);
+    cellEntries.resize(cellStart.back());
+    for (unsigned i = 0; i < entries.size(); ++i)
+    {
+        SolidObject* object = entries[i].object;
+        int maxColumn = getColumn(object->getX() + object->getWidth());
+        int maxRow = getRow(object->getY() + object->getHeight());
+        for (int row = entries[i].minRow; row <= maxRow; ++row)
+            for (int column = entries[i].minColumn; column <= maxColumn; ++column)
+                cellEntries[cellFill[row * columns + column]++] = i;
+    }
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "SpatialGrid built with %d columns, %d rows and %u objects", columns, rows, unsigned(entries.size()));
+}
+
+/**
+ * Removes object from grid, so it won't be returned by queries anymore.
+ * @param object a pointer to an indexed object
+ * @return void
+ */
+void SpatialGrid::remove(SolidObject* object)
+{
+    std::unordered_map<SolidObject*, unsigned>::iterator it = entryIndex.find(object);
+    if (it == entryIndex.end())
+        return;
+    entries[it->second].object = nullptr;
+    entryIndex.erase(it);
+}
+
+/**
+ * Appends to result every indexed object from cells overlapped by given rectangle.
+ * @param left left edge of queried rectangle
+ * @param top top edge of queried rectangle
+ * @param right right edge of queried rectangle
+ * @param bottom bottom edge of queried rectangle
+ * @param result a list to which candidates are appended
+ * @return void
+ */
+void SpatialGrid::query(double left, double top, double right, double bottom, std::vector<SolidObject*>& result) const
+{
+    if (columns == 0)
+        return;
+    int minColumn = getColumn(left);
+    int maxColumn = getColumn(right);
+    int minRow = getRow(top);
+    int maxRow = getRow(bottom);
+    for (int row = minRow; row <= maxRow; ++row)
+    {
+        for (int column = minColumn; column <= maxColumn; ++column)
+        {
+            int cell = row * columns + column;
+            for (unsigned i = cellStart[cell]; i < cellStart[cell + 1]; ++i)
+            {
+                GridEntry const& entry = entries[cellEntries[i]];
+                if (entry.object == nullptr)
+                    continue;
+                //report object only from the first cell shared by object and query, so it's reported once
+                if (column == std::max(entry.minColumn, minColumn) && row == std::max(entry.minRow, minRow))
+                    result.push_back(entry.object);
+            }
+        }
+    }
+}
+
+/**
+ * Get column containing X position, clamped to grid.
+ * @param x X position
+ * @return int
+ */
+int SpatialGrid::getColumn(double x) const
+{
+    int column = int(std::floor((x - originX) / cellSize));
+    return std::min(std::max(column, 0), columns - 1);
+}
+
+/**
+ * Get row containing Y position, clamped to grid.
+ * @param y Y position
+ * @return int
+ */
+int SpatialGrid::getRow(double y) const
+{
+    int row = int(std::floor((y - originY) / cellSize));
+    return std::min(std::max(row, 0), rows - 1);
+}
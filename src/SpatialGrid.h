@@ -0,0 +1,123 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include "Broadphase.h"
+#include <unordered_map>
+
+/**
+ * SpatialGrid is a uniform grid broadphase.
+ * Every indexed object is stored in every cell it overlaps, cells are packed in one contiguous array.
+ * @see Broadphase
+ */
+class SpatialGrid :
+    public Broadphase
+{
+public:
+    /**
+     * The default constructor.
+     * @param cellSize width and height of a single cell. Defaults to 4.0
+     */
+    SpatialGrid(double cellSize = 4.0);
+
+    /**
+     * The default destructor.
+     */
+    ~SpatialGrid();
+
+    /**
+     * Builds grid over given objects. Grid covers bounding box of all objects.
+     * @param objects a list of objects that should be indexed
+     * @return void
+     */
+    void build(std::vector<SolidObject*> const& objects) override;
+
+    /**
+     * Removes object from grid, so it won't be returned by queries anymore.
+     * @param object a pointer to an indexed object
+     * @return void
+     */
+    void remove(SolidObject* object) override;
+
+    /**
+     * Appends to result every indexed object from cells overlapped by given rectangle.
+     * @param left left edge of queried rectangle
+     * @param top top edge of queried rectangle
+     * @param right right edge of queried rectangle
+     * @param bottom bottom edge of queried rectangle
+     * @param result a list to which candidates are appended
+     * @return void
+     */
+    void query(double left, double top, double right, double bottom, std::vector<SolidObject*>& result) const override;
+
+private:
+    /**
+     * GridEntry is a struct that holds indexed object and the first cell it overlaps.
+     */
+    struct GridEntry
+    {
+        SolidObject* object;    // nullptr if removed
+        int minColumn;
+        int minRow;
+    };
+
+    /**
+     * Width and height of a single cell.
+     */
+    double const cellSize;
+
+    /**
+     * X position of left edge of grid.
+     */
+    double originX;
+
+    /**
+     * Y position of top edge of grid.
+     */
+    double originY;
+
+    /**
+     * Number of columns of grid.
+     */
+    int columns;
+
+    /**
+     * Number of rows of grid.
+     */
+    int rows;
+
+    /**
+     * List of indexed objects.
+     */
+    std::vector<GridEntry> entries;
+
+    /**
+     * Offsets into cellEntries where every cell begins. Has one more element than there are cells.
+     */
+    std::vector<unsigned> cellStart;
+
+    /**
+     * Indices into entries stored cell after cell.
+     */
+    std::vector<unsigned> cellEntries;
+
+    /**
+     * Map from indexed object to its index in entries.
+     */
+    std::unordered_map<SolidObject*, unsigned> entryIndex;
+
+    /**
+     * Get column containing X position, clamped to grid.
+     * @param x X position
+     * @return int
+     */
+    int getColumn(double x) const;
+
+    /**
+     * Get row containing Y position, clamped to grid.
+     * @param y Y position
+     * @return int
+     */
+    int getRow(double y) const;
+};
+
+#endif // SPATIALGRID_H
@@ -1,4 +1,5 @@
 #include "Trigger.h"
+#include "Snapshot.h"
 
 /**
  * Trigger implementation
@@ -28,18 +29,13 @@ Trigger::Trigger(Game *const gameObject,
     double height,
     bool triggerOnce) :
     SolidObject(x, y, width, height),
-    onTrigger(nullptr),
-    onStartTouch(nullptr),
-    onEndTouch(nullptr),
-    triggerOnce(triggerOnce),
-    isTriggered(false)
+    game(gameObject),
+    onTrigger(onTrigger),
+    onStartTouch(onStartTouch),
+    onEndTouch(onEndTouch),
+    triggerOnce(triggerOnce)
 {
-    if (onTrigger != (void(Game::*)())nullptr)
-        this->onTrigger = std::bind(onTrigger, gameObject);
-    if (onStartTouch != (void(Game::*)())nullptr)
-        this->onStartTouch = std::bind(onStartTouch, gameObject);
-    if (onEndTouch != (void(Game::*)())nullptr)
-        this->onEndTouch = std::bind(onEndTouch, gameObject);
+    setKind(ObjectKind::Trigger);
 }
 
 /**
@@ -50,38 +46,61 @@ Trigger::~Trigger()
 }
 
 /**
- * Fire when something collides with trigger.
+ * Fire when trigger starts being touched.
+ * @return void
  */
-void Trigger::trigger()
+void Trigger::startTouch()
 {
+    if (onStartTouch != nullptr)
+        (game->*onStartTouch)();
+}
+
+/**
+ * Fire once every step while trigger is touched. Trigger that fires only once is destroyed.
+ * @return void
+ */
+void Trigger::touch()
+{
+    if (onTrigger != nullptr)
+        (game->*onTrigger)();
     if (triggerOnce)
-    {
-        if (onStartTouch != nullptr)
-            onStartTouch();
         destroy();
-    }
-    else
-    {
-        if (!isTriggered)
-        {
-            if (onStartTouch != nullptr)
-                onStartTouch();
-            isTriggered = true;
-        }
-    }
-    if (onTrigger != nullptr)
-        onTrigger();
 }
 
 /**
- * Fire when something stops collision with trigger.
+ * Fire when trigger stops being touched.
+ * @return void
+ */
+void Trigger::endTouch()
+{
+    if (onEndTouch != nullptr)
+        (game->*onEndTouch)();
+}
+
+/**
+ * Appends state of Trigger to snapshot, including member functions it fires.
+ * @param snapshot Snapshot that state is appended to
+ * @return void
+ */
+void Trigger::saveState(Snapshot& snapshot) const
+{
+    SolidObject::saveState(snapshot);
+    snapshot.write(onTrigger);
+    snapshot.write(onStartTouch);
+    snapshot.write(onEndTouch);
+    snapshot.write(triggerOnce);
+}
+
+/**
+ * Reads state of Trigger appended by saveState. Member functions are fired on Game that Trigger was constructed with.
+ * @param snapshot Snapshot that state is read from
+ * @return void
  */
-void Trigger::untrigger()
+void Trigger::loadState(Snapshot& snapshot)
 {
-    if (isTriggered)
-    {
-        isTriggered = false;
-        if (onEndTouch != nullptr)
-            onEndTouch();
-    }
+    SolidObject::loadState(snapshot);
+    onTrigger = snapshot.read<void (Game::*)()>();
+    onStartTouch = snapshot.read<void (Game::*)()>();
+    onEndTouch = snapshot.read<void (Game::*)()>();
+    triggerOnce = snapshot.read<bool>();
 }
@@ -3,11 +3,11 @@
 
 #include "Game.h"
 #include "SolidObject.h"
-#include <functional>
 
 /**
  * Trigger is an object that executes a function when colliding with PlayerCreature.
- * It derives from SolidObject.
+ * It derives from SolidObject, but it's never collided with, TriggerSystem finds who touches it.
+ * @see TriggerSystem
  */
 class Trigger :
     public SolidObject
@@ -43,43 +43,71 @@ public:
     ~Trigger();
 
     /**
-     * Fire when something collides with trigger.
+     * Kind of objects of this class.
      */
-    void trigger();
-    
+    static const ObjectKind staticKind = ObjectKind::Trigger;
+
+    /**
+     * Fire when trigger starts being touched.
+     * @return void
+     */
+    void startTouch();
+
+    /**
+     * Fire once every step while trigger is touched. Trigger that fires only once is destroyed.
+     * @return void
+     */
+    void touch();
+
+    /**
+     * Fire when trigger stops being touched.
+     * @return void
+     */
+    void endTouch();
+
+    /**
+     * Appends state of Trigger to snapshot, including member functions it fires.
+     * @param snapshot Snapshot that state is appended to
+     * @return void
+     */
+    void saveState(Snapshot& snapshot) const override;
+
     /**
-     * Fire when something stops collision with trigger.
+     * Reads state of Trigger appended by saveState. Member functions are fired on Game that Trigger was constructed with.
+     * @param snapshot Snapshot that state is read from
+     * @return void
      */
-    void untrigger();
+    void loadState(Snapshot& snapshot) override;
 
     /**
-     * Assignment operator is deleted because Trigger has constant variable.
+     * Assignment operator is deleted because Trigger is bound to a Game object.
      */
     Trigger& operator=(Trigger const&) = delete;
 private:
     /**
-     * Function object binded to member function of a Game object that's to be fired when trigger is triggered.
+     * Game object whose member functions are fired.
+     * Member functions are kept unbound, so they can be saved in a Snapshot.
      */
-    std::function<void(void)> onTrigger;
-    
+    Game* game;
+
     /**
-     * Function object binded to member function of a Game object that's to be fired on beginning of collision with trigger.
+     * Member function of Game that's to be fired when trigger is triggered.
      */
-    std::function<void(void)> onStartTouch;
+    void (Game::*onTrigger)();
     
     /**
-     * Function object binded to member function of a Game object that's to be fired on ending of collision with trigger.
+     * Member function of Game that's to be fired on beginning of collision with trigger.
      */
-    std::function<void(void)> onEndTouch;
+    void (Game::*onStartTouch)();
     
     /**
-     * Should the trigger be triggered only once.
+     * Member function of Game that's to be fired on ending of collision with trigger.
      */
-    bool const triggerOnce;
+    void (Game::*onEndTouch)();
     
     /**
-     * Is trigger triggered.
+     * Should the trigger be triggered only once.
      */
-    bool isTriggered;
+    bool triggerOnce;
 };
 #endif // TRIGGER_H
\ No newline at end of file
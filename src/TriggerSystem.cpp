@@ -0,0 +1,184 @@
+#include "TriggerSystem.h"
+#include "AABBTree.h"
+#include "Physics.h"
+#include "World.h"
+#include <algorithm>
+
+/**
+ * TriggerSystem implementation
+ */
+
+/**
+ * The default constructor.
+ */
+TriggerSystem::TriggerSystem() :
+    index(new AABBTree())
+{
+}
+
+/**
+ * The default destructor.
+ */
+TriggerSystem::~TriggerSystem()
+{
+    delete index;
+}
+
+/**
+ * Builds index over Triggers of World, keeping pairs found by previous step.
+ * Should be called once Triggers were added to World, removed ones are forgotten by remove.
+ * @param world reference to World that holds all game objects
+ * @return void
+ */
+void TriggerSystem::build(World& world)
+{
+    candidates.clear();
+    world.triggers.forEach([this](Trigger* t){ candidates.push_back(t); });
+    index->build(candidates);
+}
+
+/**
+ * Finds touching pairs without firing anything, forgetting pairs of previous step.
+ * Used when World was restored, so Triggers that were already touched aren't entered again. Index has to be built first.
+ * @param world reference to World that holds all game objects
+ * @return void
+ */
+void TriggerSystem::restore(World& world)
+{
+    findPairs(world, false);
+    previous.swap(current);
+}
+
+/**
+ * Forgets Trigger that is about to be deleted without firing it.
+ * @param trigger a pointer to removed Trigger
+ * @return void
+ */
+void TriggerSystem::remove(Trigger* trigger)
+{
+    index->remove(trigger);
+    previous.erase(std::remove_if(previous.begin(), previous.end(), [trigger](Pair const& p){ return p.trigger == trigger; }), previous.end());
+}
+
+/**
+ * Finds touching pairs and fires Triggers whose pairs have changed since previous step.
+ * Every touched Trigger is also fired once per step while it's being touched.
+ * Both lists are sorted, so they are merged trigger by trigger in a single pass.
+ * Trigger that is passed through within a single step is entered, touched and left on the next one.
+ * @param world reference to World that holds all game objects
+ * @param swept true if Triggers passed through since previous position of PlayerCreature are touched too
+ * @return void
+ */
+void TriggerSystem::update(World& world, bool swept)
+{
+    findPairs(world, swept);
+    size_t i = 0;
+    size_t j = 0;
+    while (i < previous.size() || j < current.size())
+    {
+        unsigned id;
+        if (i == previous.size())
+            id = current[j].triggerId;
+        else if (j == current.size())
+            id = previous[i].triggerId;
+        else
+            id = std::min(previous[i].triggerId, current[j].triggerId);
+
+        Trigger* left = nullptr;
+        for (; i < previous.size() && previous[i].triggerId == id; ++i)
+            left = previous[i].trigger;
+        Trigger* touched = nullptr;
+        for (; j < current.size() && current[j].triggerId == id; ++j)
+            touched = current[j].trigger;
+
+        if (touched != nullptr)
+        {
+            if (left == nullptr)
+                touched->startTouch();
+            touched->touch();
+        }
+        else if (!left->getDestroyed())
+            left->endTouch();
+    }
+    previous.swap(current);
+}
+
+/**
+ * Appends to result every Trigger from leaves of index whose bounds overlap given rectangle.
+ * @param left left edge of queried rectangle
+ * @param top top edge of queried rectangle
+ * @param right right edge of queried rectangle
+ * @param bottom bottom edge of queried rectangle
+ * @param result a list to which candidates are appended
+ * @return void
+ */
+void TriggerSystem::query(double left, double top, double right, double bottom, std::vector<SolidObject*>& result) const
+{
+    index->query(left, top, right, bottom, result);
+}
+
+/**
+ * Get number of pairs found by last step.
+ * @return size_t
+ */
+size_t TriggerSystem::getPairCount() const
+{
+    return previous.size();
+}
+
+/**
+ * Fills current with sorted pairs of Triggers and PlayerCreatures that overlap.
+ * Destroyed objects don't touch anything. Sleeping PlayerCreature hasn't moved, so it isn't swept.
+ * @param world reference to World that holds all game objects
+ * @param swept true if Triggers passed through since previous position of PlayerCreature are touched too
+ * @return void
+ */
+void TriggerSystem::findPairs(World& world, bool swept)
+{
+    current.clear();
+    world.players.forEach([this, swept](PlayerCreature* creature)
+    {
+        if (creature->getDestroyed())
+            return;
+        double left = creature->getX();
+        double top = creature->getY();
+        double right = left + creature->getWidth();
+        double bottom = top + creature->getHeight();
+        double moveX = 0.0;
+        double moveY = 0.0;
+        if (swept && !creature->getIsSleeping())
+        {
+            moveX = left - creature->getPrevX();
+            moveY = top - creature->getPrevY();
+        }
+        candidates.clear();
+        index->query(std::min(left, left - moveX), std::min(top, top - moveY), std::max(right, right - moveX), std::max(bottom, bottom - moveY), candidates);
+        for (std::vector<SolidObject*>::const_iterator it = candidates.begin(); it != candidates.end(); ++it)
+        {
+            Trigger* trigger = static_cast<Trigger*>(*it);
+            if (trigger->getDestroyed())
+                continue;
+            bool touched = left < trigger->getX() + trigger->getWidth() && right > trigger->getX() &&
+                top < trigger->getY() + trigger->getHeight() && bottom > trigger->getY();
+            bool alongX;
+            if (!touched && (moveX != 0.0 || moveY != 0.0))
+                touched = Physics::timeOfImpact(left - moveX, top - moveY, right - left, bottom - top, moveX, moveY, trigger, alongX) < 1.0;
+            if (!touched)
+                continue;
+            Pair pair = { trigger->getId(), creature->getId(), trigger };
+            current.push_back(pair);
+        }
+    });
+    std::sort(current.begin(), current.end(), comparePairs);
+}
+
+/**
+ * Compare pairs by identifier of Trigger, then by identifier of PlayerCreature.
+ * @param a first pair
+ * @param b second pair
+ * @return bool true if a goes before b
+ */
+bool TriggerSystem::comparePairs(Pair const& a, Pair const& b)
+{
+    return a.triggerId < b.triggerId || (a.triggerId == b.triggerId && a.creatureId < b.creatureId);
+}
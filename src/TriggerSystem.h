@@ -0,0 +1,140 @@
+#ifndef TRIGGERSYSTEM_H
+#define TRIGGERSYSTEM_H
+
+#include "Broadphase.h"
+#include <vector>
+
+class World;
+class Trigger;
+
+/**
+ * TriggerSystem fires Triggers touched by PlayerCreatures.
+ * Triggers are kept in their own AABBTree apart from level geometry, so collision never looks at them
+ * and only triggers close to a PlayerCreature are ever tested.
+ * Every step it finds pairs of overlapping Trigger and PlayerCreature and compares them with pairs of previous step:
+ * a Trigger starts being touched when its first pair appears and stops being touched when its last pair disappears.
+ * Pairs are identified by identifiers of objects and sorted, so Triggers are always fired in the same order.
+ * @see Trigger
+ * @see Physics
+ */
+class TriggerSystem
+{
+public:
+    /**
+     * The default constructor.
+     */
+    TriggerSystem();
+
+    /**
+     * The default destructor.
+     */
+    ~TriggerSystem();
+
+    /**
+     * Builds index over Triggers of World, keeping pairs found by previous step.
+     * Should be called once Triggers were added to World, removed ones are forgotten by remove.
+     * @param world reference to World that holds all game objects
+     * @return void
+     */
+    void build(World& world);
+
+    /**
+     * Finds touching pairs without firing anything, forgetting pairs of previous step.
+     * Used when World was restored, so Triggers that were already touched aren't entered again. Index has to be built first.
+     * @param world reference to World that holds all game objects
+     * @return void
+     */
+    void restore(World& world);
+
+    /**
+     * Forgets Trigger that is about to be deleted without firing it.
+     * @param trigger a pointer to removed Trigger
+     * @return void
+     */
+    void remove(Trigger* trigger);
+
+    /**
+     * Finds touching pairs and fires Triggers whose pairs have changed since previous step.
+     * Every touched Trigger is also fired once per step while it's being touched.
+     * @param world reference to World that holds all game objects
+     * @param swept true if Triggers passed through since previous position of PlayerCreature are touched too
+     * @return void
+     */
+    void update(World& world, bool swept = false);
+
+    /**
+     * Appends to result every Trigger from leaves of index whose bounds overlap given rectangle.
+     * @param left left edge of queried rectangle
+     * @param top top edge of queried rectangle
+     * @param right right edge of queried rectangle
+     * @param bottom bottom edge of queried rectangle
+     * @param result a list to which candidates are appended
+     * @return void
+     */
+    void query(double left, double top, double right, double bottom, std::vector<SolidObject*>& result) const;
+
+    /**
+     * Get number of pairs found by last step.
+     * @return size_t
+     */
+    size_t getPairCount() const;
+
+    /**
+     * Copy constructor is deleted because TriggerSystem owns its index.
+     */
+    TriggerSystem(TriggerSystem const&) = delete;
+
+    /**
+     * Assignment operator is deleted because TriggerSystem owns its index.
+     */
+    TriggerSystem& operator=(TriggerSystem const&) = delete;
+
+private:
+    /**
+     * Pair is a struct that holds a Trigger touched by a PlayerCreature.
+     */
+    struct Pair
+    {
+        unsigned triggerId;  // identifier of Trigger
+        unsigned creatureId; // identifier of PlayerCreature
+        Trigger* trigger;    // touched Trigger
+    };
+
+    /**
+     * A pointer to bounding volume hierarchy over Triggers.
+     */
+    Broadphase* index;
+
+    /**
+     * Pairs found by previous step, sorted.
+     */
+    std::vector<Pair> previous;
+
+    /**
+     * Pairs found by current step, sorted. Reused by every step.
+     */
+    std::vector<Pair> current;
+
+    /**
+     * Candidates reported by index, reused by every query.
+     */
+    std::vector<SolidObject*> candidates;
+
+    /**
+     * Fills current with sorted pairs of Triggers and PlayerCreatures that overlap.
+     * @param world reference to World that holds all game objects
+     * @param swept true if Triggers passed through since previous position of PlayerCreature are touched too
+     * @return void
+     */
+    void findPairs(World& world, bool swept);
+
+    /**
+     * Compare pairs by identifier of Trigger, then by identifier of PlayerCreature.
+     * @param a first pair
+     * @param b second pair
+     * @return bool true if a goes before b
+     */
+    static bool comparePairs(Pair const& a, Pair const& b);
+};
+
+#endif // TRIGGERSYSTEM_H
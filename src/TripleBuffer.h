@@ -0,0 +1,105 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+/**
+ * TripleBuffer hands values from a single writing thread to a single reading thread without locks or waiting.
+ * Writer fills back slot and publishes it, reader takes newest published slot as its front slot.
+ * Third slot sits between them, so neither side ever touches a slot the other one owns. Values that reader didn't take in time are overwritten.
+ * Slots are kept for the whole life of buffer, so values that own memory reuse it.
+ * @see SimulationThread
+ */
+template <class T>
+class TripleBuffer
+{
+public:
+    /**
+     * The default constructor.
+     */
+    TripleBuffer() :
+        front(0),
+        middle(1),
+        back(2)
+    {
+    }
+
+    /**
+     * The default destructor.
+     */
+    ~TripleBuffer()
+    {
+    }
+
+    /**
+     * Get slot that writer fills. Only writing thread can call it.
+     * @return T&
+     */
+    T& getBack()
+    {
+        return slots[back];
+    }
+
+    /**
+     * Publishes back slot and takes slot that was published before as new back slot. Only writing thread can call it.
+     * @return void
+     */
+    void publish()
+    {
+        back = middle.exchange(back | fresh, std::memory_order_acq_rel) & ~fresh;
+    }
+
+    /**
+     * Takes newest published slot as front slot if something was published since last call. Only reading thread can call it.
+     * @return bool true if front slot changed
+     */
+    bool acquire()
+    {
+        if ((middle.load(std::memory_order_relaxed) & fresh) == 0)
+            return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & ~fresh;
+        return true;
+    }
+
+    /**
+     * Get slot that reader reads. Only reading thread can call it.
+     * @return T const&
+     */
+    T const& getFront() const
+    {
+        return slots[front];
+    }
+
+    /**
+     * Assignment operator is deleted because slots are owned by threads.
+     */
+    TripleBuffer& operator=(TripleBuffer const&) = delete;
+
+private:
+    /**
+     * Flag of middle slot set when it was published and not acquired yet.
+     */
+    static const unsigned fresh = 4;
+
+    /**
+     * Values handed between threads.
+     */
+    T slots[3];
+
+    /**
+     * Index of slot owned by reader.
+     */
+    unsigned front;
+
+    /**
+     * Index of slot between writer and reader, combined with fresh flag.
+     */
+    std::atomic<unsigned> middle;
+
+    /**
+     * Index of slot owned by writer.
+     */
+    unsigned back;
+};
+
+#endif // TRIPLEBUFFER_H
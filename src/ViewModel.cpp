@@ -1,6 +1,4 @@
 #include "ViewModel.h"
-#include "Coin.h"
-#include "Trigger.h"
 #include <string>
 
 /**
@@ -9,12 +7,15 @@
 
 /**
  * Initializes variables.
- * @param game a constant pointer to a Game object
+ * @param simulation a constant pointer to SimulationThread that runs Game
  * @param sdlWrapper a constant pointer to an SDLWrapper
  */
-ViewModel::ViewModel(Game* const game, SDLWrapper* const sdlWrapper) :
-	game(game),
+ViewModel::ViewModel(SimulationThread* const simulation, SDLWrapper* const sdlWrapper) :
+	simulation(simulation),
 	sdlWrapper(sdlWrapper),
+	hasNewFrame(false),
+	hasDrawnGame(false),
+	drawnVersion(0),
 	hasDrawnPauseMenu(false),
 	countedFrames(0),
 	otherCountedFrames(0),
@@ -23,6 +24,7 @@ ViewModel::ViewModel(Game* const game, SDLWrapper* const sdlWrapper) :
 {
     camera = { 0, 0 };
     SDL_GetRendererOutputSize(sdlWrapper->renderer, &camera.w, &camera.h);
+    sendCommand(GameCommandType::SetViewSize, double(camera.w) / GameDefinitions::scale, double(camera.h) / GameDefinitions::scale);
 	fpsTimer.start();
 	curFPSTimer.start();
 }
@@ -47,28 +49,54 @@ void ViewModel::handleEvents()
 		switch (events.type)
 		{
 		case SDL_QUIT:
-			game->gameOver();
+			sendCommand(GameCommandType::GameOver);
 			break;
 		case SDL_KEYDOWN:
 			if (events.key.keysym.scancode == SDL_SCANCODE_ESCAPE)
 			{
-				switch (game->getGameState())
+				switch (simulation->getFrame().state)
 				{
 				case GameState::Playing:
-					game->pauseGame();
+					sendCommand(GameCommandType::PauseGame);
 					break;
 				case GameState::Paused:
-					game->resumeGame();
+					sendCommand(GameCommandType::ResumeGame);
 					break;
 				}
 			}
+			if (events.key.keysym.scancode == SDL_SCANCODE_BACKSPACE)
+			{
+				//go back a second, also right after dying
+				if (simulation->getFrame().state == GameState::Playing || simulation->getFrame().state == GameState::Lost)
+					sendCommand(GameCommandType::Rewind, 1.0);
+			}
+#ifdef DEBUGGAME
+			if (events.key.keysym.scancode == SDL_SCANCODE_F2)
+			{
+				//switch broadphase to compare them
+				switch (simulation->getFrame().broadphaseType)
+				{
+				case BroadphaseType::BruteForce:
+					sendCommand(GameCommandType::SetBroadphase, double(BroadphaseType::UniformGrid));
+					break;
+				case BroadphaseType::UniformGrid:
+					sendCommand(GameCommandType::SetBroadphase, double(BroadphaseType::Tree));
+					break;
+				default:
+					sendCommand(GameCommandType::SetBroadphase, double(BroadphaseType::BruteForce));
+					break;
+				}
+			}
+#endif
 			break;
 		}
 
 		//If SDL_QUIT, ignore events
-		if (game->getGameState() == GameState::Quit)
+		if (events.type == SDL_QUIT)
 			break;
 	}
+	//buttons are read by simulation thread on its next update
+	simulation->setButtons(keyboard.getButtons());
 }
 
 /**
@@ -78,7 +106,10 @@ void ViewModel::handleEvents()
  */
 void ViewModel::drawLoop()
 {
-	switch (game->getGameState())
+	hasNewFrame = simulation->acquireFrame();
+	if (simulation->getFrame().state != GameState::Playing)
+		hasDrawnGame = false;
+	switch (simulation->getFrame().state)
 	{
 	case GameState::Menu:
         fadeTimer.stop();
@@ -109,26 +140,55 @@ void ViewModel::drawLoop()
 	string += std::to_string(avgFPS);
 	string += " curFPS:";
 	string += std::to_string(curFPS);
+	switch (simulation->getFrame().broadphaseType)
+	{
+	case BroadphaseType::BruteForce:
+		string += " broadphase:BruteForce";
+		break;
+	case BroadphaseType::UniformGrid:
+		string += " broadphase:UniformGrid";
+		break;
+	case BroadphaseType::Tree:
+		string += " broadphase:Tree";
+		break;
+	}
 	SDL_SetWindowTitle(sdlWrapper->window, string.c_str());
 #endif
 }
 
+/**
+ * Check if last draw loop took a new frame.
+ * @return bool
+ */
+bool ViewModel::getHasNewFrame() const
+{
+    return hasNewFrame;
+}
+
 /**
  * Interprets all game objects and draws them accordingly on screen.
+ * Screen is redrawn only if game objects changed since it was last drawn or something blinks.
  * @return void
  */
 void ViewModel::drawGame()
 {
     SDL_ShowCursor(0);
-	if (game->getPosUpdated())
+	RenderFrame const& frame = simulation->getFrame();
+	if (hasNewFrame && (!hasDrawnGame || frame.changeVersion != drawnVersion || frame.blinking))
 	{
+		hasDrawnGame = true;
+		drawnVersion = frame.changeVersion;
+
 		//Clear screen
 		SDL_SetRenderDrawColor(sdlWrapper->renderer, 0xFF, 0xFF, 0xFF, 0xFF);
 		SDL_RenderClear(sdlWrapper->renderer);
 
-		//Center the camera over the player
-		camera.x = int((game->getPlayerController()->getCreature()->getX() + game->getPlayerController()->getCreature()->getWidth() / 2)*GameDefinitions::scale - GameDefinitions::screenWidth / 2);
-		camera.y = int((game->getPlayerController()->getCreature()->getY() + game->getPlayerController()->getCreature()->getHeight() / 2)*GameDefinitions::scale - GameDefinitions::screenHeight / 2);
+		//Center the camera over the player, player is gone once it's dead
+		if (frame.hasPlayer)
+		{
+			camera.x = int((frame.player.x + frame.player.width / 2)*GameDefinitions::scale - GameDefinitions::screenWidth / 2);
+			camera.y = int((frame.player.y + frame.player.height / 2)*GameDefinitions::scale - GameDefinitions::screenHeight / 2);
+		}
 
 		//Keep the camera in bounds
 		if (camera.x < 0)
@@ -139,85 +199,79 @@ void ViewModel::drawGame()
 		{
 			camera.y = 0;
 		}
-		if (camera.x > game->getLevelWidth()*GameDefinitions::scale - camera.w)
+		if (camera.x > frame.levelWidth*GameDefinitions::scale - camera.w)
 		{
-			camera.x = game->getLevelWidth()*GameDefinitions::scale - camera.w;
+			camera.x = frame.levelWidth*GameDefinitions::scale - camera.w;
 		}
-		if (camera.y > game->getLevelHeight()*GameDefinitions::scale - camera.h)
+		if (camera.y > frame.levelHeight*GameDefinitions::scale - camera.h)
 		{
-			camera.y = game->getLevelHeight()*GameDefinitions::scale - camera.h;
+			camera.y = frame.levelHeight*GameDefinitions::scale - camera.h;
 		}
 
-		for (std::list<Object*>::const_iterator it = game->getObjectList().begin(); it != game->getObjectList().end(); ++it)
+		//Streamed level is kept loaded around camera
+		sendCommand(GameCommandType::SetView, double(camera.x) / GameDefinitions::scale, double(camera.x + camera.w) / GameDefinitions::scale);
+
+		//Frame holds objects around player, only ones overlapping camera are drawn
+		for (std::vector<RenderObject>::const_iterator it = frame.objects.begin(); it != frame.objects.end(); ++it)
 		{
-			if ((*it)->getX()*GameDefinitions::scale < camera.x + camera.w &&
-				((*it)->getX() + (*it)->getWidth())*GameDefinitions::scale > camera.x &&
-				(*it)->getY()*GameDefinitions::scale < camera.y + camera.h &&
-				((*it)->getHeight() + (*it)->getY())*GameDefinitions::scale > camera.y)
-			{
-				SDL_SetRenderDrawColor(sdlWrapper->renderer, 0x0, 0x0, 0x0, 0xFF);
-				SDL_Rect rect;
-                SDL_Texture* textureToLoad = nullptr;
-                bool renderTexture = false;
-                if (dynamic_cast<Trigger*>(*it))
-                {
+			SDL_SetRenderDrawColor(sdlWrapper->renderer, 0x0, 0x0, 0x0, 0xFF);
+			SDL_Rect rect;
+            SDL_Texture* textureToLoad = nullptr;
+            bool renderTexture = false;
+            if (it->kind == ObjectKind::Trigger)
+            {
 #ifdef DEBUGGAME
-                    SDL_SetRenderDrawColor(sdlWrapper->renderer, 0x0, 0xFF, 0x0, 0xFF);
+                SDL_SetRenderDrawColor(sdlWrapper->renderer, 0x0, 0xFF, 0x0, 0xFF);
 #else
-                    continue;
+                continue;
 #endif
-                }
-				Creature* tmpC = dynamic_cast<Creature*>(*it);
-				if (tmpC != nullptr)
+            }
+			if (it->kind == ObjectKind::Player || it->kind == ObjectKind::Monster)
+			{
+				if (it->kind == ObjectKind::Player)
 				{
-					if (dynamic_cast<PlayerCreature*>(*it))
-					{
-                        renderTexture = true;
-						SDL_SetRenderDrawColor(sdlWrapper->renderer, 0xFF, 0xA5, 0x0, 0xFF);
-                        if (tmpC->getSpeedX()<0.0)
-                            textureToLoad = sdlWrapper->levelTextureVector[LevelTexture::PlayerLeft];
-                        else if (tmpC->getSpeedX()>0.0)
-                            textureToLoad = sdlWrapper->levelTextureVector[LevelTexture::PlayerRight];
-                        else
-                            textureToLoad = sdlWrapper->levelTextureVector[LevelTexture::PlayerFront];
-					}
-					else
-					{
-                        renderTexture = true;
-                        if (tmpC->getSpeedX()<=0.0)
-                            textureToLoad = sdlWrapper->levelTextureVector[LevelTexture::MonsterLeft];
-                        else
-                            textureToLoad = sdlWrapper->levelTextureVector[LevelTexture::MonsterRight];
-						SDL_SetRenderDrawColor(sdlWrapper->renderer, 0xA5, 0x2A, 0x2A, 0xFF);
-
-					}
-					if (tmpC->getIsInvulnerable() && SDL_GetTicks() % 2 == 0)
-						continue;
-					//Disabled due to jittering
-					//rect.x = int(((*it)->getX()*game->getPosAlpha() + (*it)->getPrevX()*(1.0 - game->getPosAlpha()))*GameDefinitions::scale) - camera.x;
-					//rect.y = int(((*it)->getY()*game->getPosAlpha() + (*it)->getPrevY()*(1.0 - game->getPosAlpha()))*GameDefinitions::scale) - camera.y;
+                    renderTexture = true;
+					SDL_SetRenderDrawColor(sdlWrapper->renderer, 0xFF, 0xA5, 0x0, 0xFF);
+                    if ((it->flags & RenderFlags::FacingLeft) == RenderFlags::FacingLeft)
+                        textureToLoad = sdlWrapper->levelTextureVector[LevelTexture::PlayerLeft];
+                    else if ((it->flags & RenderFlags::FacingRight) == RenderFlags::FacingRight)
+                        textureToLoad = sdlWrapper->levelTextureVector[LevelTexture::PlayerRight];
+                    else
+                        textureToLoad = sdlWrapper->levelTextureVector[LevelTexture::PlayerFront];
 				}
 				else
 				{
-					//rect.x = int((*it)->getX()*GameDefinitions::scale) - camera.x;
-					//rect.y = int((*it)->getY()*GameDefinitions::scale) - camera.y;
+                    renderTexture = true;
+                    if ((it->flags & RenderFlags::FacingRight) != RenderFlags::FacingRight)
+                        textureToLoad = sdlWrapper->levelTextureVector[LevelTexture::MonsterLeft];
+                    else
+                        textureToLoad = sdlWrapper->levelTextureVector[LevelTexture::MonsterRight];
+					SDL_SetRenderDrawColor(sdlWrapper->renderer, 0xA5, 0x2A, 0x2A, 0xFF);
+
 				}
-                if (dynamic_cast<Coin*>(*it))
-                    SDL_SetRenderDrawColor(sdlWrapper->renderer, 0xFF, 0xFF, 0x0, 0xFF);
-
-				rect.x = int((*it)->getX()*GameDefinitions::scale) - camera.x;
-				rect.y = int((*it)->getY()*GameDefinitions::scale) - camera.y;
-				rect.w = int((*it)->getWidth()*GameDefinitions::scale);
-				rect.h = int((*it)->getHeight()*GameDefinitions::scale);
-                if (renderTexture)
-                    SDL_RenderCopy(sdlWrapper->renderer, textureToLoad, nullptr, &rect);
-                else
-                    SDL_RenderFillRect(sdlWrapper->renderer, &rect);
+				if ((it->flags & RenderFlags::Invulnerable) == RenderFlags::Invulnerable && SDL_GetTicks() % 2 == 0)
+					continue;
+				//Disabled due to jittering
+				//rect.x = int((it->x*frame.posAlpha + it->prevX*(1.0 - frame.posAlpha))*GameDefinitions::scale) - camera.x;
+				//rect.y = int((it->y*frame.posAlpha + it->prevY*(1.0 - frame.posAlpha))*GameDefinitions::scale) - camera.y;
 			}
+            if (it->kind == ObjectKind::Coin)
+                SDL_SetRenderDrawColor(sdlWrapper->renderer, 0xFF, 0xFF, 0x0, 0xFF);
+
+			rect.x = int(it->x*GameDefinitions::scale) - camera.x;
+			rect.y = int(it->y*GameDefinitions::scale) - camera.y;
+			rect.w = int(it->width*GameDefinitions::scale);
+			rect.h = int(it->height*GameDefinitions::scale);
+			if (rect.x >= camera.w || rect.y >= camera.h || rect.x + rect.w <= 0 || rect.y + rect.h <= 0)
+				continue;
+            if (renderTexture)
+                SDL_RenderCopy(sdlWrapper->renderer, textureToLoad, nullptr, &rect);
+            else
+                SDL_RenderFillRect(sdlWrapper->renderer, &rect);
 		}
 
         //Draw health meter
-        for (int i = game->getPlayerController()->getCreature()->getHealth(); i > 0; --i)
+        for (int i = frame.hasPlayer ? frame.playerHealth : 0; i > 0; --i)
         {
             SDL_SetRenderDrawColor(sdlWrapper->renderer, 0xFF, 0x0, 0x0, 0xFF);
             SDL_Rect healthRect;
@@ -231,19 +285,22 @@ void ViewModel::drawGame()
         }
 
         //Draw coin meter
-        SDL_SetRenderDrawColor(sdlWrapper->renderer, 0xFF, 0xFF, 0x0, 0xFF);
-        SDL_Rect coinRect = { camera.w - 100, 20, 20, 20 };
-        SDL_RenderFillRect(sdlWrapper->renderer, &coinRect);
-        SDL_SetRenderDrawColor(sdlWrapper->renderer, 0x0, 0x0, 0x0, 0xFF);
-        SDL_RenderDrawRect(sdlWrapper->renderer, &coinRect);
-        
-        std::string coinString = "x " + std::to_string(dynamic_cast<PlayerCreature*>(game->getPlayerController()->getCreature())->getCoins());
-        SDL_Texture* coinText = sdlWrapper->loadTextureFromRenderedText(coinString, { 0x0, 0x0, 0x0, 0xFF }, Font::RegularOutline);
-        drawText(coinRect.x + 28, coinRect.y + (coinRect.h / 2) - 2, coinText, TextAlignment::Left);
-        SDL_DestroyTexture(coinText);
-        coinText = sdlWrapper->loadTextureFromRenderedText(coinString, { 0xFF, 0xFF, 0x0, 0xFF });
-        drawText(coinRect.x + 30, coinRect.y + (coinRect.h / 2), coinText, TextAlignment::Left);
-        SDL_DestroyTexture(coinText);
+        if (frame.hasPlayer)
+        {
+            SDL_SetRenderDrawColor(sdlWrapper->renderer, 0xFF, 0xFF, 0x0, 0xFF);
+            SDL_Rect coinRect = { camera.w - 100, 20, 20, 20 };
+            SDL_RenderFillRect(sdlWrapper->renderer, &coinRect);
+            SDL_SetRenderDrawColor(sdlWrapper->renderer, 0x0, 0x0, 0x0, 0xFF);
+            SDL_RenderDrawRect(sdlWrapper->renderer, &coinRect);
+
+            std::string coinString = "x " + std::to_string(frame.playerCoins);
+            SDL_Texture* coinText = sdlWrapper->loadTextureFromRenderedText(coinString, { 0x0, 0x0, 0x0, 0xFF }, Font::RegularOutline);
+            drawText(coinRect.x + 28, coinRect.y + (coinRect.h / 2) - 2, coinText, TextAlignment::Left);
+            SDL_DestroyTexture(coinText);
+            coinText = sdlWrapper->loadTextureFromRenderedText(coinString, { 0xFF, 0xFF, 0x0, 0xFF });
+            drawText(coinRect.x + 30, coinRect.y + (coinRect.h / 2), coinText, TextAlignment::Left);
+            SDL_DestroyTexture(coinText);
+        }
 
 	}
 	SDL_RenderPresent(sdlWrapper->renderer);
@@ -288,8 +345,8 @@ void ViewModel::drawMenu()
     SDL_GetRendererOutputSize(sdlWrapper->renderer, &rendererWidth, &rendererHeight);
     drawText(rendererWidth / 2, 100, sdlWrapper->menuTextureVector[MenuTexture::TitleText]);
     drawText(rendererWidth / 2, 160, sdlWrapper->menuTextureVector[MenuTexture::SubtitleText]);
-	drawButton(60, rendererHeight - 150, 120, 25, sdlWrapper->menuTextureVector[MenuTexture::StartButton], &Game::startGame);
-	drawButton(60, rendererHeight - 100, 120, 25, sdlWrapper->menuTextureVector[MenuTexture::QuitButton], &Game::gameOver);
+	drawButton(60, rendererHeight - 150, 120, 25, sdlWrapper->menuTextureVector[MenuTexture::StartButton], GameCommandType::StartGame);
+	drawButton(60, rendererHeight - 100, 120, 25, sdlWrapper->menuTextureVector[MenuTexture::QuitButton], GameCommandType::GameOver);
 	SDL_RenderPresent(sdlWrapper->renderer);
 #ifdef DEBUGGAME
 	++countedFrames;
@@ -324,8 +381,8 @@ void ViewModel::drawPauseMenu()
 	}
     int rendererWidth, rendererHeight;
     SDL_GetRendererOutputSize(sdlWrapper->renderer, &rendererWidth, &rendererHeight);
-	drawButton(rendererWidth / 2 - 60, rendererHeight - 150, 120, 25, sdlWrapper->menuTextureVector[MenuTexture::ResumeButton], &Game::resumeGame);
-	drawButton(rendererWidth / 2 - 60, rendererHeight - 100, 120, 25, sdlWrapper->menuTextureVector[MenuTexture::MenuButton], &Game::quitToMenu);
+	drawButton(rendererWidth / 2 - 60, rendererHeight - 150, 120, 25, sdlWrapper->menuTextureVector[MenuTexture::ResumeButton], GameCommandType::ResumeGame);
+	drawButton(rendererWidth / 2 - 60, rendererHeight - 100, 120, 25, sdlWrapper->menuTextureVector[MenuTexture::MenuButton], GameCommandType::QuitToMenu);
 	
 	SDL_RenderPresent(sdlWrapper->renderer);
 #ifdef DEBUGGAME
@@ -376,8 +433,8 @@ void ViewModel::drawLost()
     int rendererWidth, rendererHeight;
     SDL_GetRendererOutputSize(sdlWrapper->renderer, &rendererWidth, &rendererHeight);
     drawText(rendererWidth / 2, 100, sdlWrapper->menuTextureVector[MenuTexture::LostText]);
-    drawButton(rendererWidth / 2 - 180, rendererHeight - 100, 120, 25, sdlWrapper->menuTextureVector[MenuTexture::RetryButton], &Game::startGame);
-    drawButton(rendererWidth / 2 + 60, rendererHeight - 100, 120, 25, sdlWrapper->menuTextureVector[MenuTexture::MenuButton], &Game::quitToMenu);
+    drawButton(rendererWidth / 2 - 180, rendererHeight - 100, 120, 25, sdlWrapper->menuTextureVector[MenuTexture::RetryButton], GameCommandType::StartGame);
+    drawButton(rendererWidth / 2 + 60, rendererHeight - 100, 120, 25, sdlWrapper->menuTextureVector[MenuTexture::MenuButton], GameCommandType::QuitToMenu);
 
     SDL_RenderPresent(sdlWrapper->renderer);
 #ifdef DEBUGGAME
@@ -414,15 +471,16 @@ void ViewModel::drawWon()
     int rendererWidth, rendererHeight;
     SDL_GetRendererOutputSize(sdlWrapper->renderer, &rendererWidth, &rendererHeight);
     drawText(rendererWidth / 2, 100, sdlWrapper->menuTextureVector[MenuTexture::WinText]);
+    RenderFrame const& frame = simulation->getFrame();
     std::string coinString = "Number of coins you've acquired: " +
-        std::to_string(dynamic_cast<PlayerCreature*>(game->getPlayerController()->getCreature())->getCoins()) +
+        std::to_string(frame.playerCoins) +
         "/" +
-        std::to_string(game->getLevelCoins()) +
-        ((dynamic_cast<PlayerCreature*>(game->getPlayerController()->getCreature())->getCoins() == game->getLevelCoins()) ? "!!!" : "");
+        std::to_string(frame.levelCoins) +
+        ((frame.playerCoins == frame.levelCoins) ? "!!!" : "");
     SDL_Texture* coinText = sdlWrapper->loadTextureFromRenderedText(coinString, { 0x0, 0x0, 0x0, 0xFF }, Font::Subtitle);
     drawText(50, 180, coinText,TextAlignment::Left);
     SDL_DestroyTexture(coinText);
-    drawButton(rendererWidth / 2 - 60, rendererHeight - 100, 120, 25, sdlWrapper->menuTextureVector[MenuTexture::MenuButton], &Game::quitToMenu);
+    drawButton(rendererWidth / 2 - 60, rendererHeight - 100, 120, 25, sdlWrapper->menuTextureVector[MenuTexture::MenuButton], GameCommandType::QuitToMenu);
     SDL_RenderPresent(sdlWrapper->renderer);
 #ifdef DEBUGGAME
     ++countedFrames;
@@ -437,10 +495,10 @@ void ViewModel::drawWon()
  * @param buttonWidth width of button
  * @param buttonHeight height of button
  * @param texture a pointer to texture that should be used on button
- * @param onClick a member function pointer to Game member function that should be called upon button press
+ * @param onClick a command that should be sent to Game upon button press
  * @return void
  */
-void ViewModel::drawButton(int buttonX, int buttonY, int buttonWidth, int buttonHeight, SDL_Texture* texture, void (Game::*onClick)())
+void ViewModel::drawButton(int buttonX, int buttonY, int buttonWidth, int buttonHeight, SDL_Texture* texture, GameCommandType onClick)
 {
 	int mouseX, mouseY;
 	Uint32 mouseState = SDL_GetMouseState(&mouseX, &mouseY);
@@ -457,7 +515,7 @@ void ViewModel::drawButton(int buttonX, int buttonY, int buttonWidth, int button
 		if (mouseState & SDL_BUTTON(SDL_BUTTON_LEFT))
 		{
 			SDL_SetRenderDrawColor(sdlWrapper->renderer, 0xFF, 0xA5, 0x0, 0xFF);
-			(game->*onClick)();
+			sendCommand(onClick);
 		}
 	}
 	else
@@ -468,6 +526,19 @@ void ViewModel::drawButton(int buttonX, int buttonY, int buttonWidth, int button
 	SDL_RenderDrawRect(sdlWrapper->renderer, &button);
 }
 
+/**
+ * Sends a command to Game, marked with state of game in current frame.
+ * @param type what to call
+ * @param first first argument. Defaults to 0.0
+ * @param second second argument. Defaults to 0.0
+ * @return void
+ */
+void ViewModel::sendCommand(GameCommandType type, double first, double second)
+{
+    GameCommand command = { type, simulation->getFrame().state, first, second };
+    simulation->send(command);
+}
+
 /**
  * Draws text.
  * @param x X position of text
@@ -1,7 +1,7 @@
 #ifndef VIEWMODEL_H
 #define VIEWMODEL_H
 
-#include "Game.h"
+#include "SimulationThread.h"
 #include "SDLWrapper.h"
 #include "Timer.h"
 
@@ -18,16 +18,17 @@ enum class TextAlignment
 /**
  * ViewModel is a class responsible for drawing game.
  * It interprets game states and objects and draws them on screen using SDLWrapper.
+ * It only reads RenderFrames published by SimulationThread and sends GameCommands back, so it never waits for simulation.
  */
 class ViewModel
 {
 public:
     /**
      * Initializes variables.
-     * @param game a constant pointer to a Game object
+     * @param simulation a constant pointer to SimulationThread that runs Game
      * @param sdlWrapper a constant pointer to an SDLWrapper
      */
-	ViewModel(Game* const game, SDLWrapper* const sdlWrapper);
+	ViewModel(SimulationThread* const simulation, SDLWrapper* const sdlWrapper);
 	
     /**
      * Default destructor
@@ -47,6 +48,12 @@ public:
      */
 	void drawLoop();
 
+    /**
+     * Check if last draw loop took a new frame.
+     * @return bool
+     */
+    bool getHasNewFrame() const;
+
     /**
      * Assigment operator is overloaded because it cannot be generated by compiler but because it shouldn't be used it's deleted.
      */
@@ -54,14 +61,34 @@ public:
 
 private:
     /**
-     * A constant pointer to Game object.
+     * A constant pointer to SimulationThread that runs Game.
      */
-	Game* const game;
+	SimulationThread* const simulation;
 	
     /**
      * A constant pointer to SDLWrapper object.
      */
     SDLWrapper* const sdlWrapper;
+
+    /**
+     * Source of buttons sent to SimulationThread.
+     */
+    InputSource keyboard;
+
+    /**
+     * Was a new frame taken by this draw loop.
+     */
+    bool hasNewFrame;
+
+    /**
+     * Is game shown on screen, false once anything else was drawn over it.
+     */
+    bool hasDrawnGame;
+
+    /**
+     * Version of changes of game objects shown on screen.
+     */
+    Uint32 drawnVersion;
 	
     /**
      * Was a pause menu drawn.
@@ -107,7 +134,7 @@ private:
      * A Timer used for fade in/outs while drawing.
      */
     Timer fadeTimer;
-    
+
     /**
      * Interprets all game objects and draws them accordingly on screen.
      * @return void
@@ -145,10 +172,19 @@ private:
      * @param buttonWidth width of button
      * @param buttonHeight height of button
      * @param texture a pointer to texture that should be used on button
-     * @param onClick a member function pointer to Game member function that should be called upon button press
+     * @param onClick a command that should be sent to Game upon button press
+     * @return void
+     */
+	void drawButton(int buttonX, int buttonY, int buttonWidth, int buttonHeight, SDL_Texture* texture, GameCommandType onClick);
+
+    /**
+     * Sends a command to Game, marked with state of game in current frame.
+     * @param type what to call
+     * @param first first argument. Defaults to 0.0
+     * @param second second argument. Defaults to 0.0
      * @return void
      */
-	void drawButton(int buttonX, int buttonY, int buttonWidth, int buttonHeight, SDL_Texture* texture, void(Game::*onClick)());
+    void sendCommand(GameCommandType type, double first = 0.0, double second = 0.0);
     
     /**
      * Draws text.
@@ -0,0 +1,108 @@
+#include "WorkerPool.h"
+#include <SDL_log.h>
+
+/**
+ * WorkerPool implementation
+ */
+
+/**
+ * The default constructor. Starts worker threads.
+ * @param threadCount number of threads started besides calling thread
+ */
+WorkerPool::WorkerPool(unsigned threadCount) :
+    job(nullptr),
+    jobCount(0),
+    nextJob(0),
+    busyWorkers(0),
+    generation(0),
+    stopping(false)
+{
+    for (unsigned i = 0; i < threadCount; ++i)
+        threads.push_back(std::thread(&WorkerPool::workerLoop, this));
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "WorkerPool created with %u threads", threadCount);
+}
+
+/**
+ * The default destructor. Stops and joins worker threads.
+ */
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobsReady.notify_all();
+    for (std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); ++it)
+        it->join();
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "WorkerPool destroyed!");
+}
+
+/**
+ * Runs job for every number from 0 to jobCount - 1 and waits until all of them are done.
+ * Jobs are picked in order, but may finish in any order.
+ * @param jobCount number of jobs
+ * @param job function called with number of job
+ * @return void
+ */
+void WorkerPool::run(unsigned jobCount, std::function<void(unsigned)> const& job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->job = &job;
+        this->jobCount = jobCount;
+        nextJob = 0;
+        busyWorkers = unsigned(threads.size());
+        ++generation;
+    }
+    jobsReady.notify_all();
+
+    runJobs();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    jobsDone.wait(lock, [this]{ return busyWorkers == 0; });
+    this->job = nullptr;
+}
+
+/**
+ * Get number of worker threads.
+ * @return unsigned
+ */
+unsigned WorkerPool::getThreadCount() const
+{
+    return unsigned(threads.size());
+}
+
+/**
+ * Main loop of worker thread.
+ * @return void
+ */
+void WorkerPool::workerLoop()
+{
+    unsigned seenGeneration = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobsReady.wait(lock, [&]{ return stopping || generation != seenGeneration; });
+            if (stopping)
+                return;
+            seenGeneration = generation;
+        }
+
+        runJobs();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busyWorkers == 0)
+            jobsDone.notify_one();
+    }
+}
+
+/**
+ * Picks and runs jobs until there are none left.
+ * @return void
+ */
+void WorkerPool::runJobs()
+{
+    for (unsigned i = nextJob++; i < jobCount; i = nextJob++)
+        (*job)(i);
+}
@@ -0,0 +1,118 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * WorkerPool is a fixed set of threads that run numbered jobs in parallel.
+ * Thread that calls run() works on jobs too and returns once every job is done.
+ */
+class WorkerPool
+{
+public:
+    /**
+     * The default constructor. Starts worker threads.
+     * @param threadCount number of threads started besides calling thread
+     */
+    WorkerPool(unsigned threadCount);
+
+    /**
+     * The default destructor. Stops and joins worker threads.
+     */
+    ~WorkerPool();
+
+    /**
+     * Runs job for every number from 0 to jobCount - 1 and waits until all of them are done.
+     * Jobs are picked in order, but may finish in any order.
+     * @param jobCount number of jobs
+     * @param job function called with number of job
+     * @return void
+     */
+    void run(unsigned jobCount, std::function<void(unsigned)> const& job);
+
+    /**
+     * Get number of worker threads.
+     * @return unsigned
+     */
+    unsigned getThreadCount() const;
+
+    /**
+     * Copy constructor is deleted because threads can't be copied.
+     */
+    WorkerPool(WorkerPool const&) = delete;
+
+    /**
+     * Assignment operator is deleted because threads can't be copied.
+     */
+    WorkerPool& operator=(WorkerPool const&) = delete;
+
+private:
+    /**
+     * Worker threads.
+     */
+    std::vector<std::thread> threads;
+
+    /**
+     * Mutex guarding everything but nextJob.
+     */
+    std::mutex mutex;
+
+    /**
+     * Signalled when new jobs are available or pool is stopping.
+     */
+    std::condition_variable jobsReady;
+
+    /**
+     * Signalled when the last worker is done with current jobs.
+     */
+    std::condition_variable jobsDone;
+
+    /**
+     * A pointer to currently run job.
+     */
+    std::function<void(unsigned)> const* job;
+
+    /**
+     * Number of currently run jobs.
+     */
+    unsigned jobCount;
+
+    /**
+     * Number of next job that should be picked.
+     */
+    std::atomic<unsigned> nextJob;
+
+    /**
+     * Number of workers that haven't finished current jobs yet.
+     */
+    unsigned busyWorkers;
+
+    /**
+     * Incremented every time new jobs are run, so workers know they should wake up.
+     */
+    unsigned generation;
+
+    /**
+     * Should workers stop.
+     */
+    bool stopping;
+
+    /**
+     * Main loop of worker thread.
+     * @return void
+     */
+    void workerLoop();
+
+    /**
+     * Picks and runs jobs until there are none left.
+     * @return void
+     */
+    void runJobs();
+};
+
+#endif // WORKERPOOL_H
@@ -0,0 +1,173 @@
+#include "World.h"
+
+/**
+ * World implementation
+ */
+
+/**
+ * The default constructor.
+ */
+World::World() :
+    solids(&arena),
+    players(&arena),
+    monsters(&arena),
+    coins(&arena),
+    triggers(&arena),
+    playerControllers(&arena),
+    controllers(&arena),
+    nextScheduleKey(0)
+{
+    auto attach = [this](SolidObject* o)
+    {
+        o->setDirtySet(&changes);
+        o->markChanged(ChangeFlags::Created);
+    };
+    auto attachCreature = [this, attach](Creature* c)
+    {
+        attach(c);
+        c->setScheduleKey(nextScheduleKey++);
+    };
+    solids.setOnCreate(attach);
+    players.setOnCreate(attachCreature);
+    monsters.setOnCreate(attachCreature);
+    coins.setOnCreate(attach);
+    triggers.setOnCreate(attach);
+}
+
+/**
+ * The default destructor.
+ * Destroys every object.
+ */
+World::~World()
+{
+    clear();
+}
+
+/**
+ * Destroys every Controller and game object and resets arena. Every object is reported as changed.
+ * Anything else allocated in arena has to be destroyed before.
+ * Schedule keys of Creatures count from 0 again.
+ * Controllers go first, because they refer to their Creatures.
+ * @return void
+ */
+void World::clear()
+{
+    playerControllers.clear();
+    controllers.clear();
+    solids.clear();
+    players.clear();
+    monsters.clear();
+    coins.clear();
+    triggers.clear();
+    changes.reset();
+    arena.reset();
+    nextScheduleKey = 0;
+}
+
+/**
+ * Get number of game objects.
+ * @return size_t
+ */
+size_t World::size() const
+{
+    return solids.size() + players.size() + monsters.size() + coins.size() + triggers.size();
+}
+
+/**
+ * Get handle of a game object held by World.
+ * @param object a constant pointer to object
+ * @return ObjectHandle
+ */
+ObjectHandle World::getHandle(SolidObject const* object) const
+{
+    ObjectHandle handle;
+    handle.kind = object->getKind();
+    switch (handle.kind)
+    {
+    case ObjectKind::Solid:
+        handle.slot = solids.getHandle(object);
+        break;
+    case ObjectKind::Player:
+        handle.slot = players.getHandle(static_cast<PlayerCreature const*>(object));
+        break;
+    case ObjectKind::Monster:
+        handle.slot = monsters.getHandle(static_cast<MonsterCreature const*>(object));
+        break;
+    case ObjectKind::Coin:
+        handle.slot = coins.getHandle(static_cast<Coin const*>(object));
+        break;
+    case ObjectKind::Trigger:
+        handle.slot = triggers.getHandle(static_cast<Trigger const*>(object));
+        break;
+    default:
+        handle.slot.index = 0;
+        handle.slot.generation = 0;
+        handle.kind = ObjectKind::Object;
+    }
+    return handle;
+}
+
+/**
+ * Get game object that handle refers to.
+ * @param handle handle of object
+ * @return SolidObject* a pointer to object or nullptr if it was destroyed
+ */
+SolidObject* World::get(ObjectHandle handle) const
+{
+    switch (handle.kind)
+    {
+    case ObjectKind::Solid:
+        return solids.get(handle.slot);
+    case ObjectKind::Player:
+        return players.get(handle.slot);
+    case ObjectKind::Monster:
+        return monsters.get(handle.slot);
+    case ObjectKind::Coin:
+        return coins.get(handle.slot);
+    case ObjectKind::Trigger:
+        return triggers.get(handle.slot);
+    default:
+        return nullptr;
+    }
+}
+
+/**
+ * Queues a game object to be destroyed by next collect and records its removal.
+ * @param object a pointer to object held by World
+ * @return void
+ */
+void World::release(SolidObject* object)
+{
+    changes.remove(object);
+    switch (object->getKind())
+    {
+    case ObjectKind::Solid:
+        solids.release(object);
+        break;
+    case ObjectKind::Player:
+        players.release(static_cast<PlayerCreature const*>(object));
+        break;
+    case ObjectKind::Monster:
+        monsters.release(static_cast<MonsterCreature const*>(object));
+        break;
+    case ObjectKind::Coin:
+        coins.release(static_cast<Coin const*>(object));
+        break;
+    case ObjectKind::Trigger:
+        triggers.release(static_cast<Trigger const*>(object));
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * Destroys every released Controller and game object.
+ * Controllers go first, because they refer to their Creatures.
+ * @return size_t number of destroyed Controllers and objects
+ */
+size_t World::collect()
+{
+    size_t count = playerControllers.collect() + controllers.collect();
+    return count + solids.collect() + players.collect() + monsters.collect() + coins.collect() + triggers.collect();
+}
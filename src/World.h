@@ -0,0 +1,194 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "Arena.h"
+#include "DirtySet.h"
+#include "NavGraph.h"
+#include "ObjectPool.h"
+#include "ObjectHandle.h"
+#include "SolidObject.h"
+#include "Coin.h"
+#include "Trigger.h"
+#include "PlayerCreature.h"
+#include "MonsterCreature.h"
+#include "BehaviorController.h"
+#include "PlayerController.h"
+
+/**
+ * World owns every game object and Controller of a loaded level.
+ * Objects are kept in a separate ObjectPool for every class, so code that cares about a single class walks only its pool.
+ * Walking every object visits pools in order: solid objects, players, monsters, coins, triggers.
+ * Objects and Controllers are removed in two phases: they're released during a step and collected once at its end.
+ * Pools take their memory from a per-level Arena, so clearing World gives memory back in one operation and next level reuses it.
+ * Every object records its changes in DirtySet of World, from its creation to its removal.
+ * NavGraph of level geometry is kept next to objects, so Controllers can find their way with nothing but World.
+ * @see ObjectPool
+ * @see Game
+ */
+class World
+{
+public:
+    /**
+     * Memory of objects that live as long as level.
+     * Declared first, so it's constructed before pools and destroyed after them.
+     */
+    Arena arena;
+
+    /**
+     * Objects that changed since it was last cleared.
+     */
+    DirtySet changes;
+
+    /**
+     * Navigation graph of static level geometry. Built by Game when level is loaded,
+     * it isn't touched by clear, so restoring a snapshot of the same level keeps it. Snapshot of another level builds it again.
+     */
+    NavGraph navigation;
+
+    /**
+     * Static solid objects.
+     */
+    ObjectPool<SolidObject> solids;
+
+    /**
+     * Creatures controlled by player.
+     */
+    ObjectPool<PlayerCreature> players;
+
+    /**
+     * Creatures controlled by computer.
+     */
+    ObjectPool<MonsterCreature> monsters;
+
+    /**
+     * Coins to be collected.
+     */
+    ObjectPool<Coin> coins;
+
+    /**
+     * Triggers.
+     */
+    ObjectPool<Trigger> triggers;
+
+    /**
+     * Controllers of players.
+     */
+    ObjectPool<PlayerController> playerControllers;
+
+    /**
+     * Controllers of monsters.
+     */
+    ObjectPool<BehaviorController> controllers;
+
+    /**
+     * Schedule key given to next created Creature. Keys count from 0 after clear,
+     * so Creatures of a level are spread over steps the same way in every run, whatever was created before.
+     * @see LodScheduler
+     */
+    unsigned nextScheduleKey;
+
+    /**
+     * The default constructor.
+     */
+    World();
+
+    /**
+     * The default destructor.
+     * Destroys every object.
+     */
+    ~World();
+
+    /**
+     * Destroys every Controller and game object and resets arena. Every object is reported as changed.
+     * Anything else allocated in arena has to be destroyed before. Schedule keys of Creatures count from 0 again.
+     * @return void
+     */
+    void clear();
+
+    /**
+     * Get number of game objects.
+     * @return size_t
+     */
+    size_t size() const;
+
+    /**
+     * Get handle of a game object held by World.
+     * @param object a constant pointer to object
+     * @return ObjectHandle
+     */
+    ObjectHandle getHandle(SolidObject const* object) const;
+
+    /**
+     * Get game object that handle refers to.
+     * @param handle handle of object
+     * @return SolidObject* a pointer to object or nullptr if it was destroyed
+     */
+    SolidObject* get(ObjectHandle handle) const;
+
+    /**
+     * Queues a game object to be destroyed by next collect and records its removal.
+     * @param object a pointer to object held by World
+     * @return void
+     */
+    void release(SolidObject* object);
+
+    /**
+     * Destroys every released Controller and game object.
+     * @return size_t number of destroyed Controllers and objects
+     */
+    size_t collect();
+
+    /**
+     * Calls function for every Creature, players first.
+     * @param function function called with a pointer to every Creature
+     * @return void
+     */
+    template <class F>
+    void forEachCreature(F function)
+    {
+        players.forEach(function);
+        monsters.forEach(function);
+    }
+
+    /**
+     * Calls function for every game object.
+     * @param function function called with a pointer to every object
+     * @return void
+     */
+    template <class F>
+    void forEachObject(F function)
+    {
+        solids.forEach(function);
+        players.forEach(function);
+        monsters.forEach(function);
+        coins.forEach(function);
+        triggers.forEach(function);
+    }
+
+    /**
+     * Calls function for every game object.
+     * @param function function called with a constant pointer to every object
+     * @return void
+     */
+    template <class F>
+    void forEachObject(F function) const
+    {
+        solids.forEach(function);
+        players.forEach(function);
+        monsters.forEach(function);
+        coins.forEach(function);
+        triggers.forEach(function);
+    }
+
+    /**
+     * Copy constructor is deleted because objects can't be copied.
+     */
+    World(World const&) = delete;
+
+    /**
+     * Assignment operator is deleted because objects can't be copied.
+     */
+    World& operator=(World const&) = delete;
+};
+
+#endif // WORLD_H
@@ -1,7 +1,9 @@
 #include "Game.h"
+#include "SimulationThread.h"
 #include "SDLWrapper.h"
 #include "ViewModel.h"
 #include <iostream>
+#include <string>
 
 int main(int argc, char *argv[])
 {
@@ -9,13 +11,27 @@ int main(int argc, char *argv[])
 	{
 		SDLWrapper graphics;
 		Game game;
-		ViewModel viewModel(&game,&graphics);
-		while (!game.getHasEnded())
+		game.setRewindEnabled(true);
+		//--record <file> records input of next started game, --replay <file> plays recorded game back
+		if (argc > 2 && std::string(argv[1]) == "--record")
+			game.recordInput(argv[2]);
+		else if (argc > 2 && std::string(argv[1]) == "--replay" && !game.replayInput(argv[2]))
+		{
+			std::cerr << "Can't replay input recording " << argv[2] << std::endl;
+			return 1;
+		}
+		//game runs on its own thread from here on, so presenting frames doesn't hold it back
+		SimulationThread simulation(&game, double(GameDefinitions::screenWidth) / GameDefinitions::scale, double(GameDefinitions::screenHeight) / GameDefinitions::scale);
+		ViewModel viewModel(&simulation,&graphics);
+		while (!simulation.getHasEnded())
 		{
 			viewModel.handleEvents();
-			game.gameLoop();
 			viewModel.drawLoop();
+			//nothing new to draw, don't spin until simulation publishes next frame
+			if (!viewModel.getHasNewFrame())
+				SDL_Delay(1);
 		}
+		simulation.rethrowError();
 		return 0;
 	}
 	catch (const InitError& err)
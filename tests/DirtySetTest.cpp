@@ -0,0 +1,54 @@
+#include "../src/Coin.h"
+#include "../src/DirtySet.h"
+#include <iostream>
+
+/**
+ * Checks that every object takes a single entry of DirtySet in a step, whatever order it's changed and removed in.
+ * Usage: DirtySetTest
+ * Build together with src/DirtySet.cpp, src/Object.cpp, src/SolidObject.cpp, src/Coin.cpp and src/Snapshot.cpp.
+ * @see DirtySet
+ */
+int main()
+{
+    int failures = 0;
+    DirtySet changes;
+    Coin removedFirst(1.0, 1.0);
+    Coin markedFirst(2.0, 1.0);
+    removedFirst.setDirtySet(&changes);
+    markedFirst.setDirtySet(&changes);
+
+    //mark after remove in one step
+    changes.remove(&removedFirst);
+    removedFirst.markChanged(ChangeFlags::Moved);
+    changes.remove(&removedFirst);
+    //remove after mark in one step
+    markedFirst.markChanged(ChangeFlags::Moved);
+    changes.remove(&markedFirst);
+
+    if (changes.getCount() != 2)
+    {
+        std::cerr << "Expected 2 entries, got " << changes.getCount() << std::endl;
+        ++failures;
+    }
+    for (size_t i = 0; i < changes.getCount(); ++i)
+    {
+        DirtySet::Entry const& entry = changes.getEntry(i);
+        ChangeFlags expected = ChangeFlags::Moved | ChangeFlags::Removed;
+        if (entry.object != nullptr || (entry.flags & expected) != expected)
+        {
+            std::cerr << "Entry of object " << entry.id << " isn't a moved and removed object" << std::endl;
+            ++failures;
+        }
+    }
+
+    //next step starts empty
+    changes.clear();
+    if (!changes.isEmpty())
+    {
+        std::cerr << "Set isn't empty after clear" << std::endl;
+        ++failures;
+    }
+    if (failures == 0)
+        std::cout << "DirtySetTest passed" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
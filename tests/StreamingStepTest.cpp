@@ -0,0 +1,97 @@
+#include "../src/Game.h"
+#include "../src/LevelFile.h"
+#include "../src/World.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+/**
+ * Captures kind and position of every object in World.
+ * Identifiers aren't captured, because every Game of a process takes them from the same counter.
+ * @param game Game whose World is captured
+ * @param state list that is filled with kind, left edge and top edge of every object
+ * @return void
+ */
+static void captureState(Game const& game, std::vector<double>& state)
+{
+    state.clear();
+    state.push_back(double(game.getGameState()));
+    game.getWorld().forEachObject([&state](SolidObject const* o)
+    {
+        state.push_back(double(o->getKind()));
+        state.push_back(o->getX());
+        state.push_back(o->getY());
+    });
+}
+
+/**
+ * Steps a streamed level headless twice, moving view across it, and checks that both runs give the same World after every step.
+ * Usage: StreamingStepTest
+ * Build together with every file of src except main.cpp, ViewModel.cpp and SDLWrapper.cpp.
+ * @see Game::step
+ */
+int main()
+{
+    //long level with ground, coins and monsters in every chunk
+    char const* path = "StreamingStepTest.lvl";
+    std::stringstream text;
+    text << "level 4000 20\nplayer 1 16\n";
+    for (int x = 0; x < 4000; x += 10)
+    {
+        text << "solid " << x << " 17 10 3\n";
+        text << "coin " << x + 3 << " 14\n";
+        if (x % 30 == 20)
+            text << "monster " << x + 5 << " 16 1 1\n";
+    }
+    std::ofstream binary(path, std::ios::binary);
+    std::string error;
+    if (!LevelFile::convert(text, binary, error))
+    {
+        std::cerr << "Couldn't build level: " << error << std::endl;
+        return 1;
+    }
+    binary.close();
+
+    Game first;
+    Game second;
+    Game* games[] = { &first, &second };
+    for (int i = 0; i < 2; ++i)
+    {
+        games[i]->setLevelStreaming(true);
+        if (!games[i]->loadLevel(std::string(path)))
+        {
+            std::cerr << "Couldn't load level" << std::endl;
+            std::remove(path);
+            return 1;
+        }
+        games[i]->resumeGame();
+    }
+
+    int failures = 0;
+    std::vector<double> firstState;
+    std::vector<double> secondState;
+    for (int step = 0; step < 500 && failures == 0; ++step)
+    {
+        //view runs ahead of player, so new chunks are needed in most steps
+        double left = step * 7.0;
+        for (int i = 0; i < 2; ++i)
+        {
+            games[i]->setView(left, left + 21.0);
+            games[i]->resumeGame();
+            games[i]->step(1);
+        }
+        captureState(first, firstState);
+        captureState(second, secondState);
+        if (firstState != secondState)
+        {
+            std::cerr << "Runs differ after step " << step + 1 << std::endl;
+            ++failures;
+        }
+    }
+    std::remove(path);
+    if (failures == 0)
+        std::cout << "StreamingStepTest passed" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
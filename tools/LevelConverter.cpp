@@ -0,0 +1,37 @@
+#include "../src/LevelFile.h"
+#include <fstream>
+#include <iostream>
+
+/**
+ * Converts text level into binary level file read by Game::loadLevel.
+ * Usage: LevelConverter <input.txt> <output.lvl>
+ * Build together with src/LevelFile.cpp and src/MappedFile.cpp.
+ * @see LevelFile
+ */
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <input.txt> <output.lvl>" << std::endl;
+        return 1;
+    }
+    std::ifstream text(argv[1]);
+    if (!text)
+    {
+        std::cerr << "Couldn't open " << argv[1] << std::endl;
+        return 1;
+    }
+    std::ofstream binary(argv[2], std::ios::binary);
+    if (!binary)
+    {
+        std::cerr << "Couldn't create " << argv[2] << std::endl;
+        return 1;
+    }
+    std::string error;
+    if (!LevelFile::convert(text, binary, error))
+    {
+        std::cerr << argv[1] << ": " << error << std::endl;
+        return 1;
+    }
+    return 0;
+}